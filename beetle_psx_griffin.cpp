@@ -9,6 +9,9 @@
 #include "mednafen/psx/spu.cpp"
 #include "mednafen/psx/gpu.cpp"
 #include "mednafen/psx/mdec.cpp"
+#ifdef HAVE_PROFILE
+#include "mednafen/psx/profile.cpp"
+#endif
 #include "mednafen/psx/input/gamepad.cpp"
 #include "mednafen/psx/input/dualanalog.cpp"
 #include "mednafen/psx/input/dualshock.cpp"
@@ -24,16 +27,22 @@
 #include "mednafen/general.cpp"
 #include "mednafen/FileStream.cpp"
 #include "mednafen/MemoryStream.cpp"
+#include "mednafen/MMapStream.cpp"
 #include "mednafen/Stream.cpp"
+#include "mednafen/AsyncFileWriter.cpp"
+#include "mednafen/OutputResampler.cpp"
 #include "mednafen/state.cpp"
+#include "mednafen/state_rewind.cpp"
 
 #ifdef NEED_CD
 #include "mednafen/cdrom/CDAccess.cpp"
 #include "mednafen/cdrom/CDAccess_Image.cpp"
 #include "mednafen/cdrom/CDAccess_CCD.cpp"
 #include "mednafen/cdrom/CDAccess_PBP.cpp"
+#include "mednafen/cdrom/CDAccess_CHD.cpp"
 #include "mednafen/cdrom/SimpleFIFO.cpp"
-#include "mednafen/cdrom/audioreader.cpp"
+#include "mednafen/cdrom/CDAFReader.cpp"
+#include "mednafen/cdrom/CDAFReader_Vorbis.cpp"
 #include "mednafen/cdrom/cdromif.cpp"
 #include "mednafen/cdrom/misc.cpp"
 #endif
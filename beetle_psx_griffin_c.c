@@ -33,6 +33,8 @@
 #include "mednafen/cdrom/lec.c"
 #include "mednafen/cdrom/recover-raw.c"
 #include "mednafen/cdrom/galois.c"
+#include "mednafen/cdrom/lzmadec.c"
+#include "mednafen/cdrom/flacdec.c"
 #endif
 
 #include "deps/libkirk/aes.c"
@@ -0,0 +1,392 @@
+/* Headless benchmark harness: loads a disc image into the core, runs it for
+ * a fixed number of frames with no frontend attached, and reports throughput
+ * along with hashes of the final frame and of main RAM, so that runs of
+ * different builds can be compared both for speed and for determinism.
+ *
+ * Build with "make bench"; run without arguments for usage.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "libretro.h"
+
+#ifdef HAVE_PROFILE
+#include "mednafen/psx/profile.h"
+#endif
+
+#define MAX_OPTIONS 64
+
+static struct retro_variable options[MAX_OPTIONS];
+static unsigned num_options;
+static const char *system_dir = ".";
+static const char *save_dir = ".";
+static int verbose;
+
+static enum retro_pixel_format pixel_format = RETRO_PIXEL_FORMAT_0RGB1555;
+static const void *last_frame;
+static unsigned last_width, last_height;
+static size_t last_pitch;
+
+static void log_printf(enum retro_log_level level, const char *fmt, ...)
+{
+   va_list ap;
+
+   if (!verbose && level < RETRO_LOG_WARN)
+      return;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+static bool environment(unsigned cmd, void *data)
+{
+   unsigned i;
+
+   switch (cmd)
+   {
+      case RETRO_ENVIRONMENT_GET_LOG_INTERFACE:
+         ((struct retro_log_callback*)data)->log = log_printf;
+         return true;
+      case RETRO_ENVIRONMENT_GET_SYSTEM_DIRECTORY:
+         *(const char**)data = system_dir;
+         return true;
+      case RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY:
+         *(const char**)data = save_dir;
+         return true;
+      case RETRO_ENVIRONMENT_SET_PIXEL_FORMAT:
+         pixel_format = *(const enum retro_pixel_format*)data;
+         return true;
+      case RETRO_ENVIRONMENT_GET_CAN_DUPE:
+         *(bool*)data = true;
+         return true;
+      case RETRO_ENVIRONMENT_GET_VARIABLE:
+         {
+            struct retro_variable *var = (struct retro_variable*)data;
+
+            for (i = 0; i < num_options; i++)
+            {
+               if (!strcmp(options[i].key, var->key))
+               {
+                  var->value = options[i].value;
+                  return true;
+               }
+            }
+
+            var->value = NULL;
+            return false;
+         }
+      case RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE:
+         *(bool*)data = false;
+         return true;
+      default:
+         break;
+   }
+
+   return false;
+}
+
+static void video_refresh(const void *data, unsigned width, unsigned height, size_t pitch)
+{
+   /* NULL is a duped frame; the previous one is still what's on screen. */
+   if (!data)
+      return;
+
+   last_frame  = data;
+   last_width  = width;
+   last_height = height;
+   last_pitch  = pitch;
+}
+
+static void audio_sample(int16_t left, int16_t right)
+{
+}
+
+static size_t audio_sample_batch(const int16_t *data, size_t frames)
+{
+   return frames;
+}
+
+static void input_poll(void)
+{
+}
+
+static int16_t input_state(unsigned port, unsigned device, unsigned index, unsigned id)
+{
+   return 0;
+}
+
+static uint64_t now_ns(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* FNV-1a */
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len)
+{
+   const uint8_t *p = (const uint8_t*)data;
+   size_t i;
+
+   for (i = 0; i < len; i++)
+   {
+      hash ^= p[i];
+      hash *= UINT64_C(0x100000001b3);
+   }
+
+   return hash;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+   const uint64_t x = *(const uint64_t*)a;
+   const uint64_t y = *(const uint64_t*)b;
+
+   return (x > y) - (x < y);
+}
+
+static double percentile_ms(const uint64_t *sorted, unsigned count, unsigned pct)
+{
+   unsigned idx = (unsigned)(((uint64_t)count * pct + 99) / 100);
+
+   if (idx > 0)
+      idx--;
+
+   return sorted[idx] / 1000000.0;
+}
+
+static void *read_file(const char *path, size_t *size)
+{
+   FILE *fp = fopen(path, "rb");
+   void *data;
+   long len;
+
+   if (!fp)
+      return NULL;
+
+   fseek(fp, 0, SEEK_END);
+   len = ftell(fp);
+   fseek(fp, 0, SEEK_SET);
+
+   data = malloc(len > 0 ? len : 1);
+
+   if (data && fread(data, 1, len, fp) != (size_t)len)
+   {
+      free(data);
+      data = NULL;
+   }
+
+   fclose(fp);
+   *size = len;
+
+   return data;
+}
+
+static void usage(const char *argv0)
+{
+   fprintf(stderr,
+         "Usage: %s [options] <image.cue|image.ccd|image.pbp|...>\n"
+         "  -n FRAMES     frames to run(default 1000)\n"
+         "  -w FRAMES     frames to run before timing starts(default 0)\n"
+         "  -s STATE      load a savestate after loading the image\n"
+         "  -b DIR        system(BIOS) directory(default .)\n"
+         "  -d DIR        save directory(default .)\n"
+         "  -o KEY=VALUE  set a core option, e.g. -o beetle_psx_cpu_overclock=enabled\n"
+         "  -v            show core log output\n",
+         argv0);
+}
+
+int main(int argc, char **argv)
+{
+   struct retro_game_info game;
+   struct retro_system_av_info av;
+   const char *image = NULL;
+   const char *state_path = NULL;
+   unsigned frames = 1000;
+   unsigned warmup = 0;
+   uint64_t *frame_ns;
+   uint64_t total_ns = 0;
+   uint64_t start;
+   unsigned i;
+   int ret = 1;
+
+   for (i = 1; i < (unsigned)argc; i++)
+   {
+      const char *arg = argv[i];
+
+      if (arg[0] != '-' || !arg[1])
+      {
+         image = arg;
+         continue;
+      }
+
+      if (!strcmp(arg, "-v"))
+      {
+         verbose = 1;
+         continue;
+      }
+
+      if (i + 1 >= (unsigned)argc || arg[2])
+      {
+         usage(argv[0]);
+         return 1;
+      }
+
+      switch (arg[1])
+      {
+         case 'n':
+            frames = strtoul(argv[++i], NULL, 0);
+            break;
+         case 'w':
+            warmup = strtoul(argv[++i], NULL, 0);
+            break;
+         case 's':
+            state_path = argv[++i];
+            break;
+         case 'b':
+            system_dir = argv[++i];
+            break;
+         case 'd':
+            save_dir = argv[++i];
+            break;
+         case 'o':
+            {
+               char *kv = argv[++i];
+               char *eq = strchr(kv, '=');
+
+               if (!eq || num_options >= MAX_OPTIONS)
+               {
+                  usage(argv[0]);
+                  return 1;
+               }
+
+               *eq = 0;
+               options[num_options].key   = kv;
+               options[num_options].value = eq + 1;
+               num_options++;
+            }
+            break;
+         default:
+            usage(argv[0]);
+            return 1;
+      }
+   }
+
+   if (!image || !frames)
+   {
+      usage(argv[0]);
+      return 1;
+   }
+
+   frame_ns = (uint64_t*)calloc(frames, sizeof(*frame_ns));
+
+   if (!frame_ns)
+   {
+      fprintf(stderr, "Out of memory for %u frame times.\n", frames);
+      return 1;
+   }
+
+   retro_set_environment(environment);
+   retro_set_video_refresh(video_refresh);
+   retro_set_audio_sample(audio_sample);
+   retro_set_audio_sample_batch(audio_sample_batch);
+   retro_set_input_poll(input_poll);
+   retro_set_input_state(input_state);
+   retro_init();
+
+   memset(&game, 0, sizeof(game));
+   game.path = image;
+
+   if (!retro_load_game(&game))
+   {
+      fprintf(stderr, "Failed to load \"%s\".\n", image);
+      goto out;
+   }
+
+   retro_get_system_av_info(&av);
+
+   if (state_path)
+   {
+      size_t state_size;
+      void *state = read_file(state_path, &state_size);
+
+      if (!state || !retro_unserialize(state, state_size))
+      {
+         fprintf(stderr, "Failed to load savestate \"%s\".\n", state_path);
+         free(state);
+         goto unload;
+      }
+
+      free(state);
+   }
+
+   for (i = 0; i < warmup; i++)
+      retro_run();
+
+   for (i = 0; i < frames; i++)
+   {
+      start = now_ns();
+      retro_run();
+      frame_ns[i] = now_ns() - start;
+      total_ns += frame_ns[i];
+   }
+
+   printf("frames:          %u\n", frames);
+   printf("time:            %.3f s\n", total_ns / 1000000000.0);
+   printf("fps:             %.2f (%.1f%% of %.2f)\n", frames * 1000000000.0 / total_ns,
+         frames * 1000000000.0 / total_ns / av.timing.fps * 100, av.timing.fps);
+
+   qsort(frame_ns, frames, sizeof(*frame_ns), compare_u64);
+   printf("frame time(ms):  min %.3f  p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+         frame_ns[0] / 1000000.0, percentile_ms(frame_ns, frames, 50), percentile_ms(frame_ns, frames, 90),
+         percentile_ms(frame_ns, frames, 99), frame_ns[frames - 1] / 1000000.0);
+
+   if (last_frame)
+   {
+      const unsigned bpp = (pixel_format == RETRO_PIXEL_FORMAT_XRGB8888) ? 4 : 2;
+      uint64_t hash = UINT64_C(0xcbf29ce484222325);
+      unsigned y;
+
+      for (y = 0; y < last_height; y++)
+         hash = hash_bytes(hash, (const uint8_t*)last_frame + y * last_pitch, last_width * bpp);
+
+      printf("framebuffer:     %ux%u %016llx\n", last_width, last_height, (unsigned long long)hash);
+   }
+   else
+      printf("framebuffer:     none\n");
+
+   if (retro_get_memory_data(RETRO_MEMORY_SYSTEM_RAM))
+      printf("ram:             %016llx\n", (unsigned long long)hash_bytes(UINT64_C(0xcbf29ce484222325),
+               retro_get_memory_data(RETRO_MEMORY_SYSTEM_RAM), retro_get_memory_size(RETRO_MEMORY_SYSTEM_RAM)));
+
+#ifdef HAVE_PROFILE
+   {
+      struct beetle_psx_profile_counter counters[PSX_PROF_COUNT];
+      unsigned count = beetle_psx_profile_get(counters, PSX_PROF_COUNT);
+
+      printf("\nlast frame:      %10s %10s %12s\n", "ms", "calls", "cycles");
+
+      for (i = 0; i < count && i < PSX_PROF_COUNT; i++)
+         printf("  %-14s %10.3f %10llu %12llu\n", counters[i].name, counters[i].host_ns / 1000000.0,
+               (unsigned long long)counters[i].calls, (unsigned long long)counters[i].cycles);
+   }
+#endif
+
+   ret = 0;
+
+unload:
+   retro_unload_game();
+out:
+   retro_deinit();
+   free(frame_ns);
+
+   return ret;
+}
@@ -0,0 +1,226 @@
+/* Sector-read microbenchmark: opens a disc image through CDIF the way the
+ * core does, reads it back sector by sector(in order, or as runs at random
+ * places to exercise seeking and read-ahead), and reports throughput,
+ * per-read latency and a hash of everything read, so that changes to the
+ * CD backends can be checked for both speed and identical output.
+ *
+ * Build with "make cdbench"; run without arguments for usage.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "libretro.h"
+#include "mednafen/mednafen.h"
+#include "mednafen/cdrom/cdromif.h"
+
+extern retro_log_printf_t log_cb;
+
+static int verbose;
+
+static void log_printf(enum retro_log_level level, const char *fmt, ...)
+{
+   va_list ap;
+
+   if (!verbose && level < RETRO_LOG_WARN)
+      return;
+
+   va_start(ap, fmt);
+   vfprintf(stderr, fmt, ap);
+   va_end(ap);
+}
+
+static uint64_t now_ns(void)
+{
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/* FNV-1a */
+static uint64_t hash_bytes(uint64_t hash, const void *data, size_t len)
+{
+   const uint8_t *p = (const uint8_t*)data;
+   size_t i;
+
+   for (i = 0; i < len; i++)
+   {
+      hash ^= p[i];
+      hash *= UINT64_C(0x100000001b3);
+   }
+
+   return hash;
+}
+
+static int compare_u64(const void *a, const void *b)
+{
+   const uint64_t x = *(const uint64_t*)a;
+   const uint64_t y = *(const uint64_t*)b;
+
+   return (x > y) - (x < y);
+}
+
+static double percentile_us(const uint64_t *sorted, unsigned count, unsigned pct)
+{
+   unsigned idx = (unsigned)(((uint64_t)count * pct + 99) / 100);
+
+   if (idx > 0)
+      idx--;
+
+   return sorted[idx] / 1000.0;
+}
+
+static void usage(const char *argv0)
+{
+   fprintf(stderr,
+         "Usage: %s [options] <image.cue|image.ccd|image.pbp|image.chd|...>\n"
+         "  -p PASSES     times to read the disc(default 1)\n"
+         "  -r RUNS       read RUNS runs of 1-64 sectors at random LBAs instead of the disc in order\n"
+         "  -m            use the in-memory image cache(CDIF_ST) instead of the read thread(CDIF_MT)\n"
+         "  -c            verify data sectors on load(the cd_verify option)\n"
+         "  -v            show log output\n",
+         argv0);
+}
+
+int main(int argc, char **argv)
+{
+   const char *image = NULL;
+   unsigned passes = 1;
+   unsigned runs = 0;
+   bool memcache = false;
+   bool success = true;
+   uint32_t seed = 1;
+   uint64_t hash = UINT64_C(0xcbf29ce484222325);
+   uint64_t open_ns;
+   uint64_t total_ns = 0;
+   uint64_t *read_ns;
+   uint32_t leadout;
+   unsigned count = 0, capacity;
+   unsigned i;
+   CDIF *cdif;
+   TOC toc;
+
+   for (i = 1; i < (unsigned)argc; i++)
+   {
+      const char *arg = argv[i];
+
+      if (arg[0] != '-' || !arg[1])
+      {
+         image = arg;
+         continue;
+      }
+
+      switch (arg[1])
+      {
+         case 'p':
+            if (i + 1 < (unsigned)argc)
+               passes = strtoul(argv[++i], NULL, 0);
+            break;
+         case 'r':
+            if (i + 1 < (unsigned)argc)
+               runs = strtoul(argv[++i], NULL, 0);
+            break;
+         case 'm':
+            memcache = true;
+            break;
+         case 'c':
+            CD_VerifyOnLoad = true;
+            break;
+         case 'v':
+            verbose = 1;
+            break;
+         default:
+            usage(argv[0]);
+            return 1;
+      }
+   }
+
+   if (!image || !passes)
+   {
+      usage(argv[0]);
+      return 1;
+   }
+
+   log_cb = log_printf;
+
+   open_ns = now_ns();
+   cdif = CDIF_Open(&success, image, false, memcache);
+
+   if (!success || !cdif)
+   {
+      fprintf(stderr, "Failed to open %s\n", image);
+      return 1;
+   }
+
+   printf("open:            %.3f ms\n", (now_ns() - open_ns) / 1000000.0);
+
+   TOC_Clear(&toc);
+   cdif->ReadTOC(&toc);
+   leadout = toc.tracks[100].lba;
+
+   capacity = runs ? runs * 64 : leadout;
+   read_ns = (uint64_t*)malloc(sizeof(*read_ns) * capacity * passes);
+
+   for (unsigned pass = 0; pass < passes; pass++)
+   {
+      unsigned run = 0;
+      uint32_t lba = 0, end = leadout;
+
+      while (runs ? run < runs : lba < end)
+      {
+         if (runs)
+         {
+            /* LCG, so every build reads the same sequence. */
+            seed = seed * 1103515245 + 12345;
+            lba = (seed >> 8) % leadout;
+            seed = seed * 1103515245 + 12345;
+            end = lba + 1 + ((seed >> 8) % 64);
+
+            if (end > leadout)
+               end = leadout;
+
+            cdif->HintReadSector(lba);
+            run++;
+         }
+
+         for (; lba < end; lba++)
+         {
+            uint8_t buf[2352 + 96];
+            uint64_t t = now_ns();
+
+            cdif->ReadRawSector(buf, lba);
+            t = now_ns() - t;
+
+            read_ns[count++] = t;
+            total_ns += t;
+            hash = hash_bytes(hash, buf, sizeof(buf));
+         }
+      }
+   }
+
+   printf("sectors:         %u\n", count);
+   printf("time:            %.3f s\n", total_ns / 1000000000.0);
+   printf("rate:            %.1f sectors/s (%.1fx CD speed)\n", count * 1000000000.0 / total_ns,
+         count * 1000000000.0 / total_ns / 75);
+
+   if (count)
+   {
+      qsort(read_ns, count, sizeof(*read_ns), compare_u64);
+      printf("read time(us):   min %.2f  p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+            read_ns[0] / 1000.0, percentile_us(read_ns, count, 50), percentile_us(read_ns, count, 90),
+            percentile_us(read_ns, count, 99), read_ns[count - 1] / 1000.0);
+   }
+
+   printf("data:            %016llx\n", (unsigned long long)hash);
+
+   free(read_ns);
+   delete cdif;
+
+   return 0;
+}
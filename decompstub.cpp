@@ -1,12 +1,9 @@
 #include <jit/jit.h>
+#include <stddef.h>
 #include <stdint.h>
 
-// This is passed as an array of uint32_t
-typedef struct state_s {
-	uint32_t reg[32];
-	uint32_t pc;
-	uint32_t hi, lo;
-} state_t;
+#include "psx.h"
+#include "decomp.h"
 
 bool decompile(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t inst, bool &branched);
 
@@ -17,6 +14,7 @@ jit_value_t _make_uint(jit_function_t func, uint32_t val) {
 
 jit_type_t sig_1, sig_2, sig_3;
 void store_memory(int size, uint32_t ptr, uint32_t val) {
+	CPU->JIT_Store(size, ptr, val);
 }
 
 void call_store_memory(jit_function_t func, int size, jit_value_t ptr, jit_value_t val) {
@@ -25,7 +23,7 @@ void call_store_memory(jit_function_t func, int size, jit_value_t ptr, jit_value
 }
 
 uint32_t load_memory(int size, uint32_t ptr) {
-	return 0;
+	return CPU->JIT_Load(size, ptr);
 }
 
 jit_value_t call_load_memory(jit_function_t func, int size, jit_value_t ptr) {
@@ -34,7 +32,7 @@ jit_value_t call_load_memory(jit_function_t func, int size, jit_value_t ptr) {
 }
 
 uint32_t read_copreg(int cop, int reg) {
-	return 0;
+	return CPU->JIT_ReadCop(cop, reg, false);
 }
 
 jit_value_t call_read_copreg(jit_function_t func, int cop, int reg) {
@@ -43,7 +41,7 @@ jit_value_t call_read_copreg(jit_function_t func, int cop, int reg) {
 }
 
 uint32_t read_copcreg(int cop, int reg) {
-	return 0;
+	return CPU->JIT_ReadCop(cop, reg, true);
 }
 
 jit_value_t call_read_copcreg(jit_function_t func, int cop, int reg) {
@@ -52,6 +50,7 @@ jit_value_t call_read_copcreg(jit_function_t func, int cop, int reg) {
 }
 
 void write_copreg(int cop, int reg, uint32_t val) {
+	CPU->JIT_WriteCop(cop, reg, false, val);
 }
 
 void call_write_copreg(jit_function_t func, int cop, int reg, jit_value_t val) {
@@ -60,6 +59,7 @@ void call_write_copreg(jit_function_t func, int cop, int reg, jit_value_t val) {
 }
 
 void write_copcreg(int cop, int reg, uint32_t val) {
+	CPU->JIT_WriteCop(cop, reg, true, val);
 }
 
 void call_write_copcreg(jit_function_t func, int cop, int reg, jit_value_t val) {
@@ -68,6 +68,7 @@ void call_write_copcreg(jit_function_t func, int cop, int reg, jit_value_t val)
 }
 
 void copfun(int cop, int cofun) {
+	CPU->JIT_CopFun(cop, cofun);
 }
 
 jit_value_t call_copfun(jit_function_t func, int cop, int cofun) {
@@ -76,11 +77,8 @@ jit_value_t call_copfun(jit_function_t func, int cop, int cofun) {
 }
 
 int32_t signext(int size, uint32_t imm) {
-	if(size == 8)
-		return (int32_t) ((int8_t) ((uint8_t) imm));
-	else if(size == 16)
-		return (int32_t) ((int16_t) ((uint16_t) imm));
-	return (int32_t) imm;
+	// Branch offsets are 18 bits wide once shifted, so this can't be just 8 or 16.
+	return ((int32_t) (imm << (32 - size))) >> (32 - size);
 }
 
 jit_value_t call_signext(jit_function_t func, int size, jit_value_t val) {
@@ -105,6 +103,7 @@ void call_break(jit_function_t func, uint32_t code) {
 }
 
 void branch(uint32_t target) {
+	CPU->JIT_Branch(target);
 }
 
 void call_branch(jit_function_t func, jit_value_t val) {
@@ -120,26 +119,30 @@ void call_overflow(jit_function_t func, jit_value_t a, jit_value_t b, int dir) {
 	jit_insn_call_native(func, 0, (void *) overflow, sig_3, args, 3, 0);
 }
 
-jit_context_t context;
+static jit_context_t context;
+static jit_type_t block_sig;
+static unsigned context_insts;	// Instructions translated since the context was created.
 
-jit_type_t block_sig;
+// Compiled code can only be released along with its context, so once this
+// much has been translated the CPU flushes its block cache and starts over.
+#define DECOMP_CONTEXT_INSTS (1 << 20)
 
-void init_decompiler() {
+void decomp_init(void) {
 	context = jit_context_create();
-	jit_context_build_start(context);
+	context_insts = 0;
 
 	jit_type_t s3params[3];
 	s3params[0] = jit_type_uint;
 	s3params[1] = jit_type_uint;
 	s3params[2] = jit_type_uint;
 	sig_3 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, s3params, 3, 1);
-	
+
 	jit_type_t sparams[2];
 	sparams[0] = jit_type_uint;
 	sparams[1] = jit_type_uint;
 	sig_2 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, sparams, 2, 1);
-	
-	jit_type_t lparams[2];
+
+	jit_type_t lparams[1];
 	lparams[0] = jit_type_uint;
 	sig_1 = jit_type_create_signature(jit_abi_cdecl, jit_type_uint, lparams, 1, 1);
 
@@ -148,9 +151,154 @@ void init_decompiler() {
 	block_sig = jit_type_create_signature(jit_abi_cdecl, jit_type_void, params, 1, 1);
 }
 
-jit_function_t create_function() {
-	auto func = jit_function_create(context, signature);
-	auto statevar = jit_value_get_param(func, 0);
-	decompile(func, statevar, 0xDEADBEE0, 0x0, branched);
-	return 0;
-}
\ No newline at end of file
+void decomp_kill(void) {
+	if(!context)
+		return;
+
+	jit_type_free(block_sig);
+	jit_type_free(sig_1);
+	jit_type_free(sig_2);
+	jit_type_free(sig_3);
+	jit_context_destroy(context);
+	context = NULL;
+}
+
+bool decomp_full(void) {
+	return context_insts >= DECOMP_CONTEXT_INSTS;
+}
+
+// Instructions that are left to the interpreter: ones that can trap(the IR
+// has no way to cancel the register write), MULT/MULTU(needs a 64-bit
+// product), DIV/DIVU(divide-by-zero semantics and mul/div unit timing),
+// and COP0/COP1/COP3, which can change interrupt and cache-isolation state.
+static bool jittable(uint32_t inst) {
+	switch(inst >> 26) {
+		case 0x00:
+			switch(inst & 0x3F) {
+				case 0x0C: case 0x0D:			// SYSCALL, BREAK
+				case 0x18: case 0x19: case 0x1A: case 0x1B:	// MULT, MULTU, DIV, DIVU
+				case 0x20: case 0x22:			// ADD, SUB
+					return false;
+			}
+			return true;
+		case 0x08:					// ADDI
+		case 0x10: case 0x11: case 0x13:		// COP0, COP1, COP3
+			return false;
+	}
+	return true;
+}
+
+bool decomp_is_branch(uint32_t inst) {
+	switch(inst >> 26) {
+		case 0x00:
+			return (inst & 0x3E) == 0x08;		// JR, JALR
+		case 0x01: case 0x02: case 0x03: case 0x04: case 0x05: case 0x06: case 0x07:
+			return true;
+	}
+	return false;
+}
+
+// Instructions whose result lands in rt one instruction late.
+static bool is_load(uint32_t inst) {
+	switch(inst >> 26) {
+		case 0x20: case 0x21: case 0x23: case 0x24: case 0x25:	// LB, LH, LW, LBU, LHU
+			return true;
+		case 0x12:					// MFC2, CFC2
+			return !((inst >> 21) & 0x1D);
+	}
+	return false;
+}
+
+// Blocks don't model the load delay slot, so a load is only taken in when
+// the instruction after it doesn't name the loaded register; otherwise the
+// pair is left to the interpreter.
+static bool load_hazard(uint32_t inst, uint32_t next) {
+	uint32_t rt = (inst >> 16) & 0x1F;
+
+	if(!rt)
+		return false;
+
+	return ((next >> 21) & 0x1F) == rt || ((next >> 16) & 0x1F) == rt || ((next >> 11) & 0x1F) == rt;
+}
+
+// Returns from the block before a misaligned load/store, so that the
+// interpreter raises the address error with the right EPC and branch state.
+static void emit_align_check(jit_function_t func, jit_value_t state, uint32_t pc, uint32_t inst) {
+	uint32_t mask;
+
+	switch(inst >> 26) {
+		case 0x21: case 0x25: case 0x29:		// LH, LHU, SH
+			mask = 1;
+			break;
+		case 0x23: case 0x2B:				// LW, SW
+			mask = 3;
+			break;
+		default:
+			return;
+	}
+
+	uint32_t rs = (inst >> 21) & 0x1F;
+	uint32_t offset = (int32_t)(int16_t)(inst & 0xFFFF);
+	jit_label_t aligned = jit_label_undefined;
+	jit_value_t address = jit_insn_add(func, jit_insn_load_relative(func, state, rs * 4, jit_type_uint), make_uint(offset));
+
+	jit_insn_branch_if_not(func, jit_insn_and(func, address, make_uint(mask)), &aligned);
+	jit_insn_store_relative(func, state, 32*4, make_uint(pc));
+	jit_insn_store_relative(func, state, offsetof(state_t, bail), make_uint(1));
+	jit_insn_return(func, NULL);
+	jit_insn_label(func, &aligned);
+}
+
+decomp_block_t decomp_block(uint32_t pc, const uint32_t *code, unsigned max_count, unsigned *count) {
+	for(;;) {
+		unsigned n = 0;
+
+		// A branch is only taken in together with its delay slot, so blocks
+		// never end in between the two.  The delay slot can't hold a load,
+		// as the instruction after it isn't known here.
+		while(n < max_count && jittable(code[n])) {
+			if(decomp_is_branch(code[n])) {
+				if(n + 1 < max_count && jittable(code[n + 1]) && !decomp_is_branch(code[n + 1]) && !is_load(code[n + 1]))
+					n += 2;
+				break;
+			}
+			if(is_load(code[n]) && (n + 1 >= max_count || load_hazard(code[n], code[n + 1])))
+				break;
+			n++;
+		}
+
+		if(!n)
+			return NULL;
+
+		jit_context_build_start(context);
+
+		jit_function_t func = jit_function_create(context, block_sig);
+		jit_value_t state = jit_value_get_param(func, 0);
+		bool branched = false;
+		unsigned i;
+
+		for(i = 0; i < n; i++) {
+			emit_align_check(func, state, pc + i * 4, code[i]);
+
+			if(!decompile(func, state, pc + i * 4, code[i], branched))
+				break;
+		}
+
+		if(i < n) {
+			// Not covered by insts.td; retry with the block ending just before it.
+			jit_function_abandon(func);
+			jit_context_build_end(context);
+			max_count = i;
+			continue;
+		}
+
+		jit_insn_return(func, NULL);
+		jit_function_compile(func);
+		jit_context_build_end(context);
+
+		context_insts += n;
+		*count = n;
+
+		return (decomp_block_t) jit_function_to_closure(func);
+	}
+}
@@ -1,6 +1,5 @@
 import json, re, struct
 import os.path
-from tblgen import interpret, Dag, TableGenBits
 
 def dag2expr(dag):
 	def clean(value):
@@ -17,6 +16,8 @@ def dag2expr(dag):
 		return dag
 
 if not os.path.exists('insts.td.cache') or os.path.getmtime('insts.td') > os.path.getmtime('insts.td.cache'):
+	# Only needed when insts.td has changed; otherwise decomp.cpp is rebuilt from the cache alone.
+	from tblgen import interpret, Dag, TableGenBits
 	insts = interpret('insts.td').deriving('BaseInst')
 	ops = []
 	for name, (bases, data) in insts:
@@ -101,7 +102,9 @@ def output(expr, top=True):
 	elif op in gops:
 		return output(gops[op](*expr[1:]))
 	elif op == 'zeroext':
-		return output(expr[1])
+		return output(expr[2])
+	elif op == 'signed':
+		return '(int32_t) (%s)' % output(expr[1], top=False)
 	else:
 		return '%s(%s)%s' % (op, ', '.join(output(x, top=False) for x in expr[1:]), ';' if top else '')
 
@@ -227,6 +230,12 @@ def to_val(val):
 		return val
 	return 'jit_value_create_nint_constant(func, jit_type_uint, %s)' % val
 
+def is_signed(sexp):
+	return isinstance(sexp, tuple) and len(sexp) == 2 and sexp[0] == 'signed'
+
+def unsign(sexp):
+	return sexp[1] if is_signed(sexp) else sexp
+
 def emitter(sexp, storing=False):
 	if isinstance(sexp, list):
 		if len(sexp) == 1:
@@ -292,7 +301,7 @@ def emitter(sexp, storing=False):
 		end = tempname()
 		return [
 			'jit_label_t %s = jit_label_undefined, %s = jit_label_undefined;' % (temp, end), 
-			'jit_insn_branch_if(func, %s, &%s);' % (to_val(emitter(sexp[1])), temp), 
+			'jit_insn_branch_if_not(func, %s, &%s);' % (to_val(emitter(sexp[1])), temp), 
 			emitter(sexp[2]), 
 			'jit_insn_branch(func, &%s);' % end, 
 			'jit_insn_label(func, &%s);' % temp, 
@@ -314,6 +323,11 @@ def emitter(sexp, storing=False):
 			return 'call_overflow(func, %s, %s, -1);' % (to_val(emitter(sexp[1][1])), to_val(emitter(sexp[1][2])))
 	elif op == 'zeroext':
 		return emitter(sexp[2], storing=storing)
+	elif op in ('lt', 'le', 'gt', 'ge') and any(is_signed(x) for x in sexp[1:]):
+		# Values are uint in the IR; bias both sides so an unsigned compare gives the signed result.
+		return emitter((op, ) + tuple(('xor', unsign(x), 0x80000000) for x in sexp[1:]), storing=storing)
+	elif op == 'signed':
+		return emitter(sexp[1], storing=storing)
 	elif op == 'signext':
 		return 'call_signext(func, %i, %s)' % (sexp[1], emitter(sexp[2], storing=storing))
 	elif op in eops:
@@ -380,7 +394,7 @@ def genDecomp((name, type, dasm, dag)):
 		elif op == 'unsigned':
 			return subgen(dag[1])
 		elif op == 'signed':
-			return subgen(dag[1])
+			return ('signed', subgen(dag[1]))
 		elif op == 'check_overflow':
 			return [('emit', ('overflow', subgen(dag[1])))]
 		elif op == 'raise':
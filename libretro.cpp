@@ -3,6 +3,7 @@
 #include "mednafen/git.h"
 #include "mednafen/general.h"
 #include "mednafen/md5.h"
+#include "mednafen/OutputResampler.h"
 #include <compat/msvc.h>
 #include "mednafen/psx/gpu.h"
 #ifdef NEED_DEINTERLACER
@@ -37,10 +38,19 @@ static bool failed_init = false;
 static unsigned image_offset = 0;
 static unsigned image_crop = 0;
 static bool crop_overscan = false;
+static bool rgb565_requested = false;
+static bool rgb565_output = false;
 static bool enable_memcard1 = false;
 static bool enable_analog_calibration = false;
 static bool enable_variable_serialization_size = false;
 
+// The SPU puts out 44.1kHz; anything else the frontend asks for goes through output_resampler.
+#define SPU_SOUND_RATE 44100
+static unsigned audio_output_rate = SPU_SOUND_RATE;
+static unsigned audio_applied_rate = SPU_SOUND_RATE;
+static double audio_rate_adjust = 1.0;
+static OutputResampler output_resampler;
+
 // Sets how often (in number of output frames/retro_run invocations)
 // the internal framerace counter should be updated if
 // display_internal_framerate is true.
@@ -53,8 +63,18 @@ static bool enable_variable_serialization_size = false;
 static int psx_skipbios;
 
 bool psx_cpu_overclock;
+#ifdef HAVE_JIT
+bool psx_cpu_dynarec;
+#endif
+#ifdef HAVE_PROFILE
+static bool profile_csv = false;
+#endif
 static bool is_pal;
 enum dither_mode psx_gpu_dither_mode;
+#ifdef HAVE_THREADS
+static unsigned psx_gpu_threads;
+static bool psx_spu_thread;
+#endif
 
 //iCB: PGXP options
 unsigned int psx_pgxp_mode;
@@ -141,6 +161,7 @@ static void extract_directory(char *buf, const char *path, size_t size)
 #include "mednafen/psx/cdc.h"
 #include "mednafen/psx/spu.h"
 #include "mednafen/mempatcher.h"
+#include "mednafen/state_rewind.h"
 
 #include <stdarg.h>
 #include <ctype.h>
@@ -220,6 +241,8 @@ int CD_SelectedDisc;     // -1 for no disc
 
 static bool CD_IsPBP = false;
 extern int PBP_DiscCount;
+extern unsigned PBP_CacheBlocks;
+extern bool CD_VerifyOnLoad;
 
 static uint64_t Memcard_PrevDC[8];
 static int64_t Memcard_SaveDelay[8];
@@ -234,6 +257,7 @@ static MultiAccessSizeMem<512 * 1024, uint32, false> *BIOSROM = NULL;
 static MultiAccessSizeMem<65536, uint32, false> *PIOMem = NULL;
 
 MultiAccessSizeMem<2048 * 1024, uint32, false> MainRAM;
+uint8 MainRAMDirty[512];
 
 static uint32_t TextMem_Start;
 static std::vector<uint8> TextMem;
@@ -479,6 +503,9 @@ template<typename T, bool IsWrite, bool Access24> static INLINE void MemRW(int32
             timestamp += 3;
       }
 
+      if(IsWrite)
+         PSX_MarkRAMDirty(A);
+
       if(Access24)
       {
          if(IsWrite)
@@ -981,6 +1008,7 @@ static void PSX_Power(void)
    PSX_PRNG.lcgo = 0xDEADBEEFCAFEBABEULL;
 
    memset(MainRAM.data32, 0, 2048 * 1024);
+   memset(MainRAMDirty, 1, sizeof(MainRAMDirty));
 
    for(i = 0; i < 9; i++)
       SysControl.Regs[i] = 0;
@@ -1009,6 +1037,9 @@ template<typename T, bool Access24> static INLINE void MemPoke(pscpu_timestamp_t
 {
    if(A < 0x00800000)
    {
+      PSX_MarkRAMDirty(A);
+      CPU->CheckCodeWrite(A);
+
       if(Access24)
          MainRAM.WriteU24(A & 0x1FFFFF, V);
       else
@@ -1019,6 +1050,8 @@ template<typename T, bool Access24> static INLINE void MemPoke(pscpu_timestamp_t
 
    if(A >= 0x1FC00000 && A <= 0x1FC7FFFF)
    {
+      CPU->InvalidateCode(A, sizeof(T));
+
       if(Access24)
          BIOSROM->WriteU24(A & 0x7FFFF, V);
       else
@@ -1064,6 +1097,11 @@ void PSX_GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool
    FIO->GPULineHook(timestamp, line_timestamp, vsync, pixels, format, width, pix_clock_offset, pix_clock, pix_clock_divider);
 }
 
+bool PSX_GPULineHookNeedsPixels(void)
+{
+   return FIO->RequireNoFrameskip();
+}
+
 static bool TestMagic(const char *name, MDFNFILE *fp)
 {
    if(GET_FSIZE_PTR(fp) < 0x800)
@@ -1081,17 +1119,11 @@ static bool TestMagicCD(std::vector<CDIF *> *CDInterfaces)
    TOC toc;
    int dt;
 
-#ifndef HAVE_CDROM_NEW
    TOC_Clear(&toc);
-#endif
 
    (*CDInterfaces)[0]->ReadTOC(&toc);
 
-#ifdef HAVE_CDROM_NEW
-   dt = toc.FindTrackByLBA(4);
-#else
    dt = TOC_FindTrackByLBA(&toc, 4);
-#endif
 
    if(dt > 0 && !(toc.tracks[dt].control & 0x4))
       return(false);
@@ -1347,6 +1379,25 @@ static unsigned CalcDiscSCEx(void)
    return ret_region;
 }
 
+// Lets rewinding copy only the pages of the big arrays that were written to.  Writes the frontend makes through
+// retro_get_memory_data() aren't tracked.
+static void SetDirtyRegions(void)
+{
+   MDFNSS_ClearDirtyRegions();
+
+   MDFNSS_AddDirtyRegion(MainRAM.data8, 2048 * 1024, 4096, MainRAMDirty);
+   MDFNSS_AddDirtyRegion(GPU->vram, GPU->vram_npixels() * sizeof(uint16), 2048 << (GPU->upscale_shift * 2), GPU->vram_dirty);
+   SPU->AddDirtyRegion();
+
+   for(unsigned i = 0; i < 8; i++)
+   {
+      InputDevice *mc = FIO->GetMemcardDevice(i);
+
+      if(mc && mc->GetNVSize())
+         MDFNSS_AddDirtyRegion(mc->GetNVData(), mc->GetNVSize(), 4096);
+   }
+}
+
 static void InitCommon(std::vector<CDIF *> *CDInterfaces, const bool EmulateMemcards = true, const bool WantPIOMem = false)
 {
    unsigned region, i;
@@ -1518,6 +1569,7 @@ static void InitCommon(std::vector<CDIF *> *CDInterfaces, const bool EmulateMemc
 #ifdef WANT_DEBUGGER
    DBG_Init();
 #endif
+   SetDirtyRegions();
    PSX_Power();
 }
 
@@ -1578,6 +1630,11 @@ static bool LoadEXE(const uint8_t *data, const uint32_t size, bool ignore_pcsp =
 
    // BIOS patch
    BIOSROM->WriteU32(0x6990, (3 << 26) | ((0xBF001000 >> 2) & ((1 << 26) - 1)));
+   CPU->InvalidateCode(0x1FC06990, 4);
+
+   // The text itself is copied in by the loader stub below, with ordinary stores, but drop anything
+   // cached from a previous EXE there up front.
+   CPU->InvalidateCode(TextStart, TextSize);
 #if 0
    BIOSROM->WriteU32(0x691C, (3 << 26) | ((0xBF001000 >> 2) & ((1 << 26) - 1)));
 #endif
@@ -1729,6 +1786,8 @@ static void Cleanup(void)
 {
    TextMem.resize(0);
 
+   MDFNSS_ClearDirtyRegions();
+
 
    if(CDC)
       delete CDC;
@@ -1769,6 +1828,9 @@ static void CloseGame(void)
 
    if (!failed_init)
    {
+      // Let any save retro_run() started land first; then only cards written to since still need saving.
+      FIO->FlushMemcardSaves();
+
       for(i = 0; i < 8; i++)
       {
          if (i == 0 && !use_mednafen_memcard0_method)
@@ -1861,13 +1923,11 @@ static void CDInsertEject(void)
 
    for(unsigned disc = 0; disc < cdifs->size(); disc++)
    {
-#ifndef HAVE_CDROM_NEW
       if(!(*cdifs)[disc]->Eject(CD_TrayOpen))
       {
          MDFN_DispMessage(_("Eject error."));
          CD_TrayOpen = !CD_TrayOpen;
       }
-#endif
    }
 
    if(CD_TrayOpen)
@@ -2265,6 +2325,8 @@ static MDFN_Surface *surf = NULL;
 
 static void alloc_surface() {
   MDFN_PixelFormat pix_fmt(MDFN_COLORSPACE_RGB, 16, 8, 0, 24);
+  if (rgb565_output)
+     pix_fmt = MDFN_PixelFormat(MDFN_COLORSPACE_RGB, 11, 5, 0, 16, 16);
   uint32_t width  = MEDNAFEN_CORE_GEOMETRY_MAX_W;
   uint32_t height = is_pal ? MEDNAFEN_CORE_GEOMETRY_MAX_H  : 480;
 
@@ -2338,9 +2400,7 @@ static void update_md5_checksum(CDIF *iface)
 
    md5_starts(&layout_md5);
 
-#ifndef HAVE_CDROM_NEW
    TOC_Clear(&toc);
-#endif
 
    iface->ReadTOC(&toc);
 
@@ -2381,11 +2441,7 @@ static bool disk_replace_image_index(unsigned index, const struct retro_game_inf
 
    bool success = true;
 
-#ifdef HAVE_CDROM_NEW
-   CDIF *iface = CDIF_Open(info->path, false);
-#else
    CDIF *iface = CDIF_Open(&success, info->path, false, false);
-#endif
 
    if (!success)
       return false;
@@ -2571,6 +2627,25 @@ static void check_variables(bool startup)
    }
 #endif
 
+   var.key = option_pbp_block_cache;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      PBP_CacheBlocks = atoi(var.value);
+   else
+      PBP_CacheBlocks = 32;
+
+   var.key = option_cd_verify;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "enabled") == 0)
+         CD_VerifyOnLoad = true;
+      else if (strcmp(var.value, "disabled") == 0)
+         CD_VerifyOnLoad = false;
+   }
+   else
+      CD_VerifyOnLoad = false;
+
    var.key = option_cpu_overclock;
    
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -2582,6 +2657,41 @@ static void check_variables(bool startup)
    }
    else
       psx_cpu_overclock = false;
+
+#ifdef HAVE_JIT
+   var.key = option_cpu_dynarec;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "enabled") == 0)
+         psx_cpu_dynarec = true;
+      else if (strcmp(var.value, "disabled") == 0)
+         psx_cpu_dynarec = false;
+   }
+   else
+      psx_cpu_dynarec = false;
+#endif
+
+#ifdef HAVE_PROFILE
+   var.key = option_profile_csv;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      bool want_csv = !strcmp(var.value, "enabled");
+
+      if (want_csv != profile_csv)
+      {
+         char csv_path[4096];
+
+         snprintf(csv_path, sizeof(csv_path), "%s%cbeetle_psx_profile.csv", retro_save_directory, retro_slash);
+
+         if (!beetle_psx_profile_set_csv(want_csv ? csv_path : NULL))
+            log_cb(RETRO_LOG_ERROR, "Could not open %s for writing.\n", csv_path);
+         else
+            profile_csv = want_csv;
+      }
+   }
+#endif
    
    var.key = option_skip_bios;
 
@@ -2680,6 +2790,27 @@ static void check_variables(bool startup)
    else
       psx_gpu_dither_mode = DITHER_NATIVE;
 
+#ifdef HAVE_THREADS
+   var.key = option_gpu_thread;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+   {
+      if (strcmp(var.value, "disabled") == 0)
+         psx_gpu_threads = 0;
+      else
+         psx_gpu_threads = atoi(var.value);
+   }
+   else
+      psx_gpu_threads = 0;
+
+   var.key = option_spu_thread;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      psx_spu_thread = (strcmp(var.value, "enabled") == 0);
+   else
+      psx_spu_thread = false;
+#endif
+
    // iCB: PGXP settings
    var.key = option_pgxp_mode;
 
@@ -2841,6 +2972,23 @@ static void check_variables(bool startup)
      }
    }
 
+   var.key = option_pixel_format;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      rgb565_requested = !strcmp(var.value, "RGB565");
+   else
+      rgb565_requested = false;
+
+   var.key = option_audio_rate;
+
+   if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+      audio_output_rate = atoi(var.value);
+   else
+      audio_output_rate = SPU_SOUND_RATE;
+
+   if (audio_output_rate < 8000)
+      audio_output_rate = SPU_SOUND_RATE;
+
    var.key = option_frame_duping;
 
    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
@@ -2998,33 +3146,21 @@ static MDFNGI *MDFNI_LoadCD(const char *devicename)
          for(unsigned i = 0; i < file_list.size(); i++)
          {
             bool success = true;
-#ifdef HAVE_CDROM_NEW
-            CDIF *image  = CDIF_Open(file_list[i].c_str(), old_cdimagecache);
-#else
             CDIF *image  = CDIF_Open(&success, file_list[i].c_str(), false, old_cdimagecache);
-#endif
             CDInterfaces.push_back(image);
          }
       }
       else if(devicename && strlen(devicename) > 4 && !strcasecmp(devicename + strlen(devicename) - 4, ".pbp"))
       {
          bool success = true;
-#ifdef HAVE_CDROM_NEW
-         CDIF *image  = CDIF_Open(devicename, old_cdimagecache);
-#else
          CDIF *image  = CDIF_Open(&success, devicename, false, old_cdimagecache);
-#endif
          CD_IsPBP     = true;
          CDInterfaces.push_back(image);
       }
       else
       {
          bool success = true;
-#ifdef HAVE_CDROM_NEW
-         CDIF *image  = CDIF_Open(devicename, old_cdimagecache);
-#else
          CDIF *image  = CDIF_Open(&success, devicename, false, old_cdimagecache);
-#endif
          CDInterfaces.push_back(image);
       }
    }
@@ -3038,9 +3174,7 @@ static MDFNGI *MDFNI_LoadCD(const char *devicename)
    for(unsigned i = 0; i < CDInterfaces.size(); i++)
    {
       TOC toc;
-#ifndef HAVE_CDROM_NEW
       TOC_Clear(&toc);
-#endif
 
       CDInterfaces[i]->ReadTOC(&toc);
 
@@ -3065,9 +3199,7 @@ static MDFNGI *MDFNI_LoadCD(const char *devicename)
       {
          TOC toc;
 
-#ifndef HAVE_CDROM_NEW
          TOC_Clear(&toc);
-#endif
          CDInterfaces[i]->ReadTOC(&toc);
 
          md5_update_u32_as_lsb(&layout_md5, toc.first_track);
@@ -3110,7 +3242,7 @@ static MDFNGI *MDFNI_LoadGame(const char *name)
 {
    MDFNFILE *GameFile;
 
-	if(strlen(name) > 4 && (!strcasecmp(name + strlen(name) - 4, ".cue") || !strcasecmp(name + strlen(name) - 4, ".ccd") || !strcasecmp(name + strlen(name) - 4, ".toc") || !strcasecmp(name + strlen(name) - 4, ".m3u") || !strcasecmp(name + strlen(name) - 4, ".pbp")))
+	if(strlen(name) > 4 && (!strcasecmp(name + strlen(name) - 4, ".cue") || !strcasecmp(name + strlen(name) - 4, ".ccd") || !strcasecmp(name + strlen(name) - 4, ".toc") || !strcasecmp(name + strlen(name) - 4, ".m3u") || !strcasecmp(name + strlen(name) - 4, ".pbp") || !strcasecmp(name + strlen(name) - 4, ".chd")))
 	 return MDFNI_LoadCD(name);
 
    GameFile = file_open(name);
@@ -3325,10 +3457,6 @@ bool retro_load_game(const struct retro_game_info *info)
 
    environ_cb(RETRO_ENVIRONMENT_SET_INPUT_DESCRIPTORS, desc);
 
-   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_XRGB8888;
-   if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
-      return false;
-
    extract_basename(retro_cd_base_name,       info->path, sizeof(retro_cd_base_name));
    extract_directory(retro_cd_base_directory, info->path, sizeof(retro_cd_base_directory));
 
@@ -3343,6 +3471,20 @@ bool retro_load_game(const struct retro_game_info *info)
    //make sure shared memory cards and save states are enabled only at startup
    shared_memorycards = shared_memorycards_toggle;
 
+   // RGB565 halves what the software renderer writes and hands over each frame; not every frontend takes it.
+   enum retro_pixel_format fmt = RETRO_PIXEL_FORMAT_RGB565;
+   rgb565_output = rgb565_requested && environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt);
+
+   if (!rgb565_output)
+   {
+      fmt = RETRO_PIXEL_FORMAT_XRGB8888;
+      if (!environ_cb(RETRO_ENVIRONMENT_SET_PIXEL_FORMAT, &fmt))
+         return false;
+   }
+
+   audio_applied_rate = audio_output_rate;
+   output_resampler.SetRates(SPU_SOUND_RATE, audio_applied_rate);
+
    if (environ_cb(RETRO_ENVIRONMENT_GET_RUMBLE_INTERFACE, &rumble) && log_cb)
       log_cb(RETRO_LOG_INFO, "Rumble interface supported!\n");
 
@@ -3614,6 +3756,17 @@ void retro_run(void)
       retro_get_system_av_info(&new_av_info);
       environ_cb(RETRO_ENVIRONMENT_SET_GEOMETRY, &new_av_info);
 
+      if (audio_output_rate != audio_applied_rate)
+      {
+         if (environ_cb(RETRO_ENVIRONMENT_SET_SYSTEM_AV_INFO, &new_av_info))
+         {
+            audio_applied_rate = audio_output_rate;
+            output_resampler.SetRates(SPU_SOUND_RATE, audio_applied_rate);
+         }
+         else
+            audio_output_rate = audio_applied_rate;
+      }
+
       if (GPU->upscale_shift != psx_gpu_upscale_shift)
       {
 	      struct retro_system_av_info new_av_info;
@@ -3627,6 +3780,7 @@ void retro_run(void)
 		  PS_GPU *new_gpu = GPU->Rescale(psx_gpu_upscale_shift);
 		  PS_GPU::Destroy(GPU);
 		  GPU = new_gpu;
+		  SetDirtyRegions();
 		  alloc_surface();
 		}
 	      else
@@ -3690,7 +3844,7 @@ void retro_run(void)
 
    EmulateSpecStruct spec = {0};
    spec.surface = surf;
-   spec.SoundRate = 44100;
+   spec.SoundRate = SPU_SOUND_RATE;
    spec.SoundBuf = NULL;
    spec.LineWidths = rects;
    spec.SoundBufMaxSize = 0;
@@ -3708,20 +3862,33 @@ void retro_run(void)
    MDFNGameInfo->mouse_sensitivity = MDFN_GetSettingF("psx.input.mouse_sensitivity");
 
    MDFNMP_ApplyPeriodicCheats();
+   CPU->CheckCodePages();
 
 
    espec->MasterCycles = 0;
    espec->SoundBufSize = 0;
 
    FIO->UpdateInput();
+#ifdef HAVE_THREADS
+   // PGXP feeds the rasterizer from state outside of the GPU.
+   GPU->SetRenderThreads((rsx_intf_is_type() == RSX_SOFTWARE && !PGXP_enabled()) ? psx_gpu_threads : 0);
+   SPU->SetThreaded(psx_spu_thread);
+#endif
    GPU->StartFrame(espec);
 
    Running = -1;
    timestamp = CPU->Run(timestamp);
 
+#ifdef HAVE_THREADS
+   GPU->SyncRenderThread();
+#endif
+
    assert(timestamp);
 
    ForceEventUpdates(timestamp);
+#ifdef HAVE_THREADS
+   SPU->SyncThread();
+#endif
    if(GPU->GetScanlineNum() < 100)
       PSX_DBG(PSX_DBG_ERROR, "[BUUUUUUUG] Frame timing end glitch; scanline=%u, st=%u\n", GPU->GetScanlineNum(), timestamp);
 
@@ -3740,7 +3907,10 @@ void retro_run(void)
 
    espec->MasterCycles = timestamp;
 
-   // Save memcards if dirty.
+   // Save memcards if dirty.  Saves to files go out on a thread; a card's dirty count drops back to 0 here once its
+   // file has been written, if the game hasn't written to it again meanwhile.
+   FIO->PollMemcardSaves();
+
    for(int i = 0; i < players; i++)
    {
       uint64_t new_dc = FIO->GetMemcardDirtyCount(i);
@@ -3750,6 +3920,8 @@ void retro_run(void)
          Memcard_PrevDC[i] = new_dc;
          Memcard_SaveDelay[i] = 0;
       }
+      else if(new_dc < Memcard_PrevDC[i])
+         Memcard_PrevDC[i] = new_dc;
 
       if(Memcard_SaveDelay[i] >= 0)
       {
@@ -3771,9 +3943,8 @@ void retro_run(void)
 
             snprintf(ext, sizeof(ext), "%d.mcr", i);
             memcard = MDFN_MakeFName(MDFNMKF_SAV, 0, ext);
-            FIO->SaveMemcard(i, memcard);
+            FIO->QueueMemcardSave(i, memcard);
             Memcard_SaveDelay[i] = -1;
-            Memcard_PrevDC[i] = 0;
          }
       }
    }
@@ -3810,7 +3981,6 @@ void retro_run(void)
       //fprintf(stderr, "(%u x %u)\n", width, height);
       // PSX core inserts padding on left and right (overscan). Optionally crop this.
 
-      const uint32_t *pix = surf->pixels;
       unsigned pix_offset = 0;
 
       if (crop_overscan)
@@ -3868,24 +4038,26 @@ void retro_run(void)
 
       width  <<= upscale_shift;
       height <<= upscale_shift;
-      pix     += pix_offset << upscale_shift;
 
-      if (GPU->display_change_count != 0)
-         fb = pix;
+      const void *pix = (const uint8_t*)surf->pixels + ((pix_offset << upscale_shift) * (surf->format.bpp / 8));
 
-      if (!allow_frame_duping)
+      // With nothing scanned out, the surface still holds the last frame; let the frontend show that again.
+      if (!allow_frame_duping || !GPU->scanout_skipped)
          fb = pix;
    }
 
-   int16_t *interbuf = (int16_t*)&IntermediateBuffer;
+   output_resampler.SetAdjust(audio_rate_adjust);
+
+   uint32_t audio_out_frames;
+   const int16_t *audio_out = output_resampler.Process((int16_t*)&IntermediateBuffer, spec.SoundBufSize, &audio_out_frames);
 
    rsx_intf_finalize_frame(fb, width, height,
-         MEDNAFEN_CORE_GEOMETRY_MAX_W << (2 + upscale_shift));
+         (MEDNAFEN_CORE_GEOMETRY_MAX_W << upscale_shift) * (rgb565_output ? 2 : 4));
 
    video_frames++;
-   audio_frames += spec.SoundBufSize;
+   audio_frames += audio_out_frames;
 
-   audio_batch_cb(interbuf, spec.SoundBufSize);
+   audio_batch_cb(audio_out, audio_out_frames);
 
    if (GPU->display_change_count != 0) {
      // For simplicity I assume that the game is using double
@@ -3896,6 +4068,10 @@ void retro_run(void)
 
      GPU->display_change_count = 0;
    }
+
+#ifdef HAVE_PROFILE
+   PSX_ProfileEndFrame();
+#endif
 }
 
 void retro_get_system_info(struct retro_system_info *info)
@@ -3915,17 +4091,29 @@ void retro_get_system_info(struct retro_system_info *info)
 void retro_get_system_av_info(struct retro_system_av_info *info)
 {
    rsx_intf_get_system_av_info(info);
+
+   // The renderers report the SPU's own rate; the frontend gets what comes out of output_resampler.
+   info->timing.sample_rate = audio_output_rate;
 }
 
+/* it seems that mednafen can realloc pointers sent to it?
+   since we don't know the disposition of void* data (is it safe to realloc?) we have to manage a new buffer here.
+   It's kept from one call to the next, as rewind and netplay can save a state every frame. */
+static StateMem serialize_buffer;
+
 void retro_deinit(void)
 {
    delete surf;
    surf = NULL;
 
+   free(serialize_buffer.data);
+   memset(&serialize_buffer, 0, sizeof(serialize_buffer));
+   MDFNSS_RewindInit(0);
+
    log_cb(RETRO_LOG_INFO, "[%s]: Samples / Frame: %.5f\n",
          MEDNAFEN_CORE_NAME, (double)audio_frames / video_frames);
    log_cb(RETRO_LOG_INFO, "[%s]: Estimated FPS: %.5f\n",
-         MEDNAFEN_CORE_NAME, (double)video_frames * 44100 / audio_frames);
+         MEDNAFEN_CORE_NAME, (double)video_frames * audio_applied_rate / audio_frames);
 }
 
 unsigned retro_get_region(void)
@@ -4019,6 +4207,10 @@ void retro_set_environment(retro_environment_t cb)
       { option_pgxp_texture, "PGXP perspective correct texturing; disabled|enabled" },
 #endif
       { option_dither_mode, "Dithering pattern; 1x(native)|internal resolution|disabled" },
+#ifdef HAVE_THREADS
+      { option_gpu_thread, "Threaded software rendering; disabled|1 thread|2 threads|3 threads|4 threads|6 threads|8 threads|12 threads|16 threads" },
+      { option_spu_thread, "Threaded SPU; disabled|enabled" },
+#endif
       { option_scale_dither, "Scale dithering pattern with internal resolution; enabled|disabled" },	   
       { option_initial_scanline, "Initial scanline; 0|1|2|3|4|5|6|7|8|9|10|10|11|12|13|14|15|16|17|18|19|20|21|22|23|24|25|26|27|28|29|30|31|32|33|34|35|36|37|38|39|40" },
       { option_last_scanline, "Last scanline; 239|238|237|236|235|234|232|231|230|229|228|227|226|225|224|223|222|221|220|219|218|217|216|215|214|213|212|211|210" },
@@ -4027,6 +4219,8 @@ void retro_set_environment(retro_environment_t cb)
       { option_frame_duping, "Frame duping (speedup); disabled|enabled" },
       { option_widescreen_hack, "Widescreen mode hack; disabled|enabled" },
       { option_crop_overscan, "Crop Overscan; enabled|disabled" },
+      { option_pixel_format, "Software renderer output format (restart); XRGB8888|RGB565" },
+      { option_audio_rate, "Audio output rate (Hz); 44100|48000|32000|96000" },
       { option_image_crop, "Additional Cropping; disabled|1 px|2 px|3 px|4 px|5 px|6 px|7 px|8 px" },
       { option_image_offset, "Offset Cropped Image; disabled|1 px|2 px|3 px|4 px|-4 px|-3 px|-2 px|-1 px" },
       { option_display_internal_fps, "Display internal FPS; disabled|enabled" },
@@ -4035,9 +4229,17 @@ void retro_set_environment(retro_environment_t cb)
       { option_multitap1, "Port 1: Multitap enable; disabled|enabled" },
       { option_multitap2, "Port 2: Multitap enable; disabled|enabled" },
       { option_cpu_overclock, "CPU Overclock; disabled|enabled" },
+#ifdef HAVE_JIT
+      { option_cpu_dynarec, "CPU Dynarec (experimental); disabled|enabled" },
+#endif
+#ifdef HAVE_PROFILE
+      { option_profile_csv, "Profiling CSV dump; disabled|enabled" },
+#endif
 #ifndef EMSCRIPTEN
       { option_cd_image_cache, "CD Image Cache (restart); disabled|enabled" },
 #endif
+      { option_pbp_block_cache, "PBP decompressed block cache (restart); 32|64|128|256|8|16" },
+      { option_cd_verify, "Verify CD data sectors on load (restart); disabled|enabled" },
       { option_skip_bios, "Skip BIOS; disabled|enabled" },
       { option_memcard0_method, "Memcard 0 method; libretro|mednafen" },
       { option_memcard1_enable, "Enable memory card 1; enabled|disabled" },
@@ -4120,25 +4322,47 @@ size_t retro_serialize_size(void)
    }
 }
 
+static bool serialize_fast(void)
+{
+   int av_enable = 0;
+
+   /* Bit 2: the state is only going back into this instance, e.g. for run-ahead */
+   return environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av_enable) && (av_enable & 4);
+}
+
 bool retro_serialize(void *data, size_t size)
 {
-   /* it seems that mednafen can realloc pointers sent to it?
-      since we don't know the disposition of void* data (is it safe to realloc?) we have to manage a new buffer here */
-   StateMem st;
-   memset(&st, 0, sizeof(st));
-   st.data     = (uint8_t*)malloc(size);
-   st.malloced = size;
+   bool ret;
+
+   /* Snapshots go straight into the frontend's buffer; they're raw, so with upscaling they can outgrow a buffer
+      sized for a normal state, and then we make one of those instead */
+   if (serialize_fast())
+   {
+      StateMem st;
+      memset(&st, 0, sizeof(st));
+      st.data     = (uint8_t*)data;
+      st.malloced = size;
+      st.fixed    = true;
+
+      if (MDFNSS_SaveSM(&st, 0, 1, NULL, NULL, NULL) && st.len <= size)
+         return true;
+   }
 
-   bool ret = MDFNSS_SaveSM(&st, 0, 0, NULL, NULL, NULL);
+   serialize_buffer.loc = 0;
+   serialize_buffer.len = 0;
+
+   ret = MDFNSS_SaveSM(&serialize_buffer, 0, 0, NULL, NULL, NULL);
 
    /* there are still some errors with the save states, the size seems to change on some games for now just log when this happens */
-   if (st.len != size)
+   if (serialize_buffer.len > size)
+   {
       log_cb(RETRO_LOG_WARN, "warning, save state size has changed\n");
+      return false;
+   }
 
-   memcpy(data,st.data,size);
-   free(st.data);
-return ret;
+   memcpy(data, serialize_buffer.data, serialize_buffer.len);
 
+   return ret;
 }
 bool retro_unserialize(const void *data, size_t size)
 {
@@ -4150,6 +4374,42 @@ bool retro_unserialize(const void *data, size_t size)
    return MDFNSS_LoadSM(&st, 0, 0);
 }
 
+int beetle_psx_rewind_init(size_t size)
+{
+   return MDFNSS_RewindInit(size);
+}
+
+int beetle_psx_rewind_push(void)
+{
+#ifdef HAVE_THREADS
+   /* The render threads mark VRAM lines dirty as they draw */
+   if (GPU)
+      GPU->SyncRenderThread();
+#endif
+
+   return MDFNSS_RewindPush();
+}
+
+int beetle_psx_rewind_pop(void)
+{
+#ifdef HAVE_THREADS
+   if (GPU)
+      GPU->SyncRenderThread();
+#endif
+
+   return MDFNSS_RewindPop();
+}
+
+unsigned beetle_psx_rewind_count(void)
+{
+   return MDFNSS_RewindCount();
+}
+
+void beetle_psx_audio_set_rate_adjust(double adjust)
+{
+   audio_rate_adjust = adjust;
+}
+
 void *retro_get_memory_data(unsigned type)
 {
    uint8_t *data;
@@ -4160,6 +4420,8 @@ void *retro_get_memory_data(unsigned type)
          if (use_mednafen_memcard0_method)
             return NULL;
          return FIO->GetMemcardDevice(0)->GetNVData();
+      case RETRO_MEMORY_SYSTEM_RAM:
+         return MainRAM.data8;
       default:
          break;
    }
@@ -4174,6 +4436,8 @@ size_t retro_get_memory_size(unsigned type)
          if (use_mednafen_memcard0_method)
             return 0;
          return (1 << 17);
+      case RETRO_MEMORY_SYSTEM_RAM:
+         return 2048 * 1024;
       default:
          break;
    }
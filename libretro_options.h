@@ -5,7 +5,7 @@
 #define MEDNAFEN_CORE_NAME "Mednafen PSX"
 #endif
 #define MEDNAFEN_CORE_VERSION "0.9.39.2"
-#define MEDNAFEN_CORE_EXTENSIONS "exe|cue|toc|ccd|m3u|pbp"
+#define MEDNAFEN_CORE_EXTENSIONS "exe|cue|toc|ccd|m3u|pbp|chd"
 #define MEDNAFEN_CORE_GEOMETRY_BASE_W 320
 #define MEDNAFEN_CORE_GEOMETRY_BASE_H 240
 #define MEDNAFEN_CORE_GEOMETRY_MAX_W 700
@@ -21,6 +21,8 @@
 #define option_filter                "beetle_psx_hw_filter"
 #define option_depth                 "beetle_psx_hw_internal_color_depth"
 #define option_dither_mode           "beetle_psx_hw_dither_mode"
+#define option_gpu_thread            "beetle_psx_hw_gpu_thread"
+#define option_spu_thread            "beetle_psx_hw_spu_thread"
 #define option_scale_dither          "beetle_psx_hw_scale_dither"
 #define option_wireframe             "beetle_psx_hw_wireframe"
 #define option_display_vram          "beetle_psx_hw_display_vram"
@@ -33,6 +35,8 @@
 #define option_last_scanline_pal     "beetle_psx_hw_last_scanline_pal"
 #define option_frame_duping          "beetle_psx_hw_frame_duping_enable"
 #define option_crop_overscan         "beetle_psx_hw_crop_overscan"
+#define option_pixel_format          "beetle_psx_hw_pixel_format"
+#define option_audio_rate            "beetle_psx_hw_audio_rate"
 #define option_image_crop            "beetle_psx_hw_image_crop"
 #define option_image_offset          "beetle_psx_hw_image_offset"
 #define option_display_internal_fps  "beetle_psx_hw_display_internal_framerate"
@@ -41,7 +45,11 @@
 #define option_multitap1             "beetle_psx_hw_enable_multitap_port1"
 #define option_multitap2             "beetle_psx_hw_enable_multitap_port2"
 #define option_cpu_overclock         "beetle_psx_hw_cpu_overclock"
+#define option_cpu_dynarec           "beetle_psx_hw_cpu_dynarec"
+#define option_profile_csv           "beetle_psx_hw_profile_csv"
 #define option_cd_image_cache        "beetle_psx_hw_cdimagecache"
+#define option_pbp_block_cache       "beetle_psx_hw_pbp_block_cache"
+#define option_cd_verify             "beetle_psx_hw_cd_verify"
 #define option_skip_bios             "beetle_psx_hw_skipbios"
 #define option_memcard0_method       "beetle_psx_hw_use_mednafen_memcard0_method"
 #define option_memcard1_enable       "beetle_psx_hw_enable_memcard1"
@@ -55,6 +63,8 @@
 #define option_filter                "beetle_psx_filter"
 #define option_depth                 "beetle_psx_internal_color_depth"
 #define option_dither_mode           "beetle_psx_dither_mode"
+#define option_gpu_thread            "beetle_psx_gpu_thread"
+#define option_spu_thread            "beetle_psx_spu_thread"
 #define option_scale_dither          "beetle_psx_scale_dither"
 #define option_wireframe             "beetle_psx_wireframe"
 #define option_display_vram          "beetle_psx_display_vram"
@@ -67,6 +77,8 @@
 #define option_last_scanline_pal     "beetle_psx_last_scanline_pal"
 #define option_frame_duping          "beetle_psx_frame_duping_enable"
 #define option_crop_overscan         "beetle_psx_crop_overscan"
+#define option_pixel_format          "beetle_psx_pixel_format"
+#define option_audio_rate            "beetle_psx_audio_rate"
 #define option_image_crop            "beetle_psx_image_crop"
 #define option_image_offset          "beetle_psx_image_offset"
 #define option_display_internal_fps  "beetle_psx_display_internal_framerate"
@@ -75,7 +87,11 @@
 #define option_multitap1             "beetle_psx_enable_multitap_port1"
 #define option_multitap2             "beetle_psx_enable_multitap_port2"
 #define option_cpu_overclock         "beetle_psx_cpu_overclock"
+#define option_cpu_dynarec           "beetle_psx_cpu_dynarec"
+#define option_profile_csv           "beetle_psx_profile_csv"
 #define option_cd_image_cache        "beetle_psx_cdimagecache"
+#define option_pbp_block_cache       "beetle_psx_pbp_block_cache"
+#define option_cd_verify             "beetle_psx_cd_verify"
 #define option_skip_bios             "beetle_psx_skipbios"
 #define option_memcard0_method       "beetle_psx_use_mednafen_memcard0_method"
 #define option_memcard1_enable       "beetle_psx_enable_memcard1"
@@ -0,0 +1,391 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mednafen.h"
+#include "AsyncFileWriter.h"
+
+#include <string.h>
+#include <errno.h>
+#include <stdio.h>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <io.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define ASYNCFW_POSIX
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <streams/file_stream.h>
+
+#include "../libretro.h"
+
+extern retro_log_printf_t log_cb;
+
+static std::string TempPath(const std::string &path)
+{
+   return path + ".tmp";
+}
+
+// Writes and syncs the temporary file for "path".
+static bool WriteTemp(const std::string &path, const void *data, size_t size)
+{
+   const std::string tmp = TempPath(path);
+#if defined(ASYNCFW_POSIX)
+   const uint8_t *p = (const uint8_t *)data;
+   int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+
+   if(fd < 0)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error opening file \"%s\": %s\n", tmp.c_str(), strerror(errno));
+      return false;
+   }
+
+   while(size)
+   {
+      ssize_t written = write(fd, p, size);
+
+      if(written < 0)
+      {
+         if(errno == EINTR)
+            continue;
+
+         break;
+      }
+
+      p += written;
+      size -= written;
+   }
+
+   if(size || fsync(fd) != 0)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error writing file \"%s\": %s\n", tmp.c_str(), strerror(errno));
+      ::close(fd);
+      unlink(tmp.c_str());
+      return false;
+   }
+
+   if(::close(fd) != 0)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error writing file \"%s\": %s\n", tmp.c_str(), strerror(errno));
+      unlink(tmp.c_str());
+      return false;
+   }
+#elif defined(_WIN32)
+   FILE *fp = fopen(tmp.c_str(), "wb");
+
+   if(!fp)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error opening file \"%s\": %s\n", tmp.c_str(), strerror(errno));
+      return false;
+   }
+
+   if(fwrite(data, 1, size, fp) != size || fflush(fp) != 0 || _commit(_fileno(fp)) != 0)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error writing file \"%s\": %s\n", tmp.c_str(), strerror(errno));
+      fclose(fp);
+      remove(tmp.c_str());
+      return false;
+   }
+
+   fclose(fp);
+#else
+   RFILE *fp = filestream_open(tmp.c_str(), RFILE_MODE_WRITE, -1);
+
+   if(!fp)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error opening file \"%s\"\n", tmp.c_str());
+      return false;
+   }
+
+   if(filestream_write(fp, data, size) != (ssize_t)size)
+   {
+      log_cb(RETRO_LOG_ERROR, "Error writing file \"%s\"\n", tmp.c_str());
+      filestream_close(fp);
+      remove(tmp.c_str());
+      return false;
+   }
+
+   filestream_close(fp);
+#endif
+
+   return true;
+}
+
+// Moves the temporary file for "path" over it.
+static bool CommitTemp(const std::string &path)
+{
+   const std::string tmp = TempPath(path);
+#if defined(_WIN32)
+   if(!MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+#else
+#if !defined(ASYNCFW_POSIX)
+   // rename() isn't guaranteed to replace an existing file outside of POSIX.
+   remove(path.c_str());
+#endif
+   if(rename(tmp.c_str(), path.c_str()) != 0)
+#endif
+   {
+      log_cb(RETRO_LOG_ERROR, "Error renaming \"%s\" to \"%s\"\n", tmp.c_str(), path.c_str());
+      remove(tmp.c_str());
+      return false;
+   }
+
+   return true;
+}
+
+// Makes a rename in the directory containing "path" durable; a no-op where the rename itself already is, or where
+// there's no way to do this.
+static void SyncDirectory(const std::string &path)
+{
+#if defined(ASYNCFW_POSIX)
+   size_t slash = path.find_last_of('/');
+   std::string dir = (slash == std::string::npos) ? std::string(".") : path.substr(0, slash ? slash : 1);
+   int fd = open(dir.c_str(), O_RDONLY);
+
+   if(fd >= 0)
+   {
+      fsync(fd);
+      ::close(fd);
+   }
+#endif
+}
+
+bool MDFN_WriteFileAtomic(const char *path, const void *data, size_t size)
+{
+   if(!WriteTemp(path, data, size) || !CommitTemp(path))
+      return false;
+
+   SyncDirectory(path);
+
+   return true;
+}
+
+#ifdef HAVE_THREADS
+AsyncFileWriter::AsyncFileWriter() : thread(NULL), mutex(NULL), cond(NULL), busy(false), quit(false)
+{
+   mutex = slock_new();
+   cond = scond_new();
+   thread = sthread_create(WriterThreadStart, this);
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+   if(thread)
+   {
+      slock_lock(mutex);
+      quit = true;
+      scond_broadcast(cond);
+      slock_unlock(mutex);
+
+      sthread_join(thread);
+   }
+
+   if(cond)
+      scond_free(cond);
+
+   if(mutex)
+      slock_free(mutex);
+}
+
+void AsyncFileWriter::WriterThreadStart(void *data)
+{
+   ((AsyncFileWriter *)data)->WriterThread();
+}
+
+void AsyncFileWriter::WriterThread(void)
+{
+   slock_lock(mutex);
+
+   for(;;)
+   {
+      std::deque<Job> batch;
+      std::vector<Completion> done;
+
+      while(queue.empty() && !quit)
+         scond_wait(cond, mutex);
+
+      // Drain the queue before quitting, so nothing that was asked to be saved is lost.
+      if(queue.empty())
+         break;
+
+      batch.swap(queue);
+      busy = true;
+      slock_unlock(mutex);
+
+      WriteBatch(batch, done);
+
+      slock_lock(mutex);
+      completed.insert(completed.end(), done.begin(), done.end());
+      busy = false;
+      scond_broadcast(cond);
+   }
+
+   slock_unlock(mutex);
+}
+
+void AsyncFileWriter::Write(const char *path, const void *data, size_t size, uint64_t tag)
+{
+   Job job;
+
+   job.path = path;
+   job.data.assign((const uint8_t *)data, (const uint8_t *)data + size);
+   job.tag = tag;
+
+   if(!thread)
+   {
+      std::deque<Job> batch(1, job);
+      std::vector<Completion> done;
+
+      WriteBatch(batch, done);
+      completed.insert(completed.end(), done.begin(), done.end());
+      return;
+   }
+
+   slock_lock(mutex);
+   queue.push_back(job);
+   scond_broadcast(cond);
+   slock_unlock(mutex);
+}
+
+bool AsyncFileWriter::GetCompleted(uint64_t *tag, bool *success)
+{
+   bool ret = false;
+
+   if(mutex)
+      slock_lock(mutex);
+
+   if(!completed.empty())
+   {
+      *tag = completed.front().tag;
+      *success = completed.front().success;
+      completed.pop_front();
+      ret = true;
+   }
+
+   if(mutex)
+      slock_unlock(mutex);
+
+   return ret;
+}
+
+void AsyncFileWriter::Wait(void)
+{
+   if(!thread)
+      return;
+
+   slock_lock(mutex);
+
+   while(!queue.empty() || busy)
+      scond_wait(cond, mutex);
+
+   slock_unlock(mutex);
+}
+#else
+AsyncFileWriter::AsyncFileWriter()
+{
+}
+
+AsyncFileWriter::~AsyncFileWriter()
+{
+}
+
+void AsyncFileWriter::Write(const char *path, const void *data, size_t size, uint64_t tag)
+{
+   std::deque<Job> batch(1);
+   std::vector<Completion> done;
+
+   batch[0].path = path;
+   batch[0].data.assign((const uint8_t *)data, (const uint8_t *)data + size);
+   batch[0].tag = tag;
+
+   WriteBatch(batch, done);
+   completed.insert(completed.end(), done.begin(), done.end());
+}
+
+bool AsyncFileWriter::GetCompleted(uint64_t *tag, bool *success)
+{
+   if(completed.empty())
+      return false;
+
+   *tag = completed.front().tag;
+   *success = completed.front().success;
+   completed.pop_front();
+
+   return true;
+}
+
+void AsyncFileWriter::Wait(void)
+{
+}
+#endif
+
+// Writes and syncs all the temporary files first, then renames them all into place and syncs each directory touched
+// once, rather than paying for a directory sync per file.
+void AsyncFileWriter::WriteBatch(std::deque<Job> &batch, std::vector<Completion> &done)
+{
+   std::vector<bool> written(batch.size(), false);
+   std::vector<std::string> dirs_synced;
+
+   for(size_t i = 0; i < batch.size(); i++)
+   {
+      bool superseded = false;
+
+      for(size_t j = i + 1; j < batch.size(); j++)
+      {
+         if(batch[j].path == batch[i].path)
+         {
+            superseded = true;
+            break;
+         }
+      }
+
+      if(!superseded)
+         written[i] = WriteTemp(batch[i].path, batch[i].data.empty() ? NULL : &batch[i].data[0], batch[i].data.size());
+   }
+
+   for(size_t i = 0; i < batch.size(); i++)
+   {
+      Completion c;
+
+      if(written[i])
+      {
+         written[i] = CommitTemp(batch[i].path);
+
+         if(written[i])
+         {
+            const std::string &path = batch[i].path;
+            const std::string dir = path.substr(0, path.find_last_of('/') + 1);
+            bool synced = false;
+
+            for(size_t d = 0; d < dirs_synced.size(); d++)
+               synced |= (dirs_synced[d] == dir);
+
+            if(!synced)
+            {
+               SyncDirectory(path);
+               dirs_synced.push_back(dir);
+            }
+         }
+      }
+
+      c.tag = batch[i].tag;
+      c.success = written[i];
+      done.push_back(c);
+   }
+}
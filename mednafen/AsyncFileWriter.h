@@ -0,0 +1,72 @@
+#ifndef __MDFN_ASYNCFILEWRITER_H
+#define __MDFN_ASYNCFILEWRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+#include <deque>
+
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+// Replaces the file at "path" with "size" bytes from "data" such that a crash or power loss midway leaves either the
+// old or the new contents there, never a mix: the data goes to a temporary file next to it, which is synced to disk and
+// then renamed over "path".  Returns false(after logging why) on failure, in which case "path" is untouched.
+bool MDFN_WriteFileAtomic(const char *path, const void *data, size_t size);
+
+// Does MDFN_WriteFileAtomic() on a thread, so that a slow disk or network filesystem doesn't hold up whoever wants a
+// file saved.  Writes that are queued up while an earlier batch is being written go out together, with only the newest
+// data for each path written, and with one directory sync per batch.  Without HAVE_THREADS, Write() writes the file
+// before returning.
+class AsyncFileWriter
+{
+   public:
+      AsyncFileWriter();
+      ~AsyncFileWriter();   // Finishes any queued writes first.
+
+      // Copies "data"; "tag" is handed back by GetCompleted() once the write is finished.
+      void Write(const char *path, const void *data, size_t size, uint64_t tag);
+
+      // Returns false if no write has finished since the last call; otherwise fills in the tag passed to Write() and
+      // whether the file was written.  A write superseded by a newer one for the same path before it went out is
+      // reported as not written.
+      bool GetCompleted(uint64_t *tag, bool *success);
+
+      // Blocks until every write queued so far is finished.
+      void Wait(void);
+
+   private:
+      struct Job
+      {
+         std::string path;
+         std::vector<uint8_t> data;
+         uint64_t tag;
+      };
+
+      struct Completion
+      {
+         uint64_t tag;
+         bool success;
+      };
+
+      void WriteBatch(std::deque<Job> &batch, std::vector<Completion> &done);
+
+      std::deque<Job> queue;
+      std::deque<Completion> completed;
+
+#ifdef HAVE_THREADS
+      sthread_t *thread;
+      slock_t *mutex;
+      scond_t *cond;
+      bool busy;
+      bool quit;
+
+      void WriterThread(void);
+      static void WriterThreadStart(void *data);
+#endif
+};
+
+#endif
@@ -0,0 +1,175 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mednafen.h"
+#include "MMapStream.h"
+
+#include <string.h>
+
+#include <memmap.h>
+#include <retro_miscellaneous.h>
+
+#ifdef HAVE_MMAN
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+// How far ahead of the read position to ask for pages to be brought in; about 3 seconds of 1x CD reading.
+static const uint64_t AdviseWindow = 512 * 1024;
+
+MMapStream::MMapStream(const char *path) : data_buffer(NULL), data_buffer_size(0), position(0), advised_start(0), advised_end(0)
+{
+#ifdef HAVE_MMAN
+   struct stat stat_buf;
+   void *p;
+   int fd = open(path, O_RDONLY);
+
+   if(fd < 0)
+      return;
+
+   if(fstat(fd, &stat_buf) == 0 && stat_buf.st_size > 0 && (uint64_t)stat_buf.st_size <= SIZE_MAX)
+   {
+      p = mmap(NULL, (size_t)stat_buf.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+      if(p != MAP_FAILED)
+      {
+         data_buffer = (uint8 *)p;
+         data_buffer_size = stat_buf.st_size;
+#ifdef MADV_SEQUENTIAL
+         madvise(data_buffer, (size_t)data_buffer_size, MADV_SEQUENTIAL);
+#endif
+      }
+   }
+
+   // The mapping stays valid after the descriptor is closed.
+   ::close(fd);
+#endif
+}
+
+MMapStream::~MMapStream()
+{
+   close();
+}
+
+uint64_t MMapStream::attributes(void)
+{
+   return (ATTRIBUTE_READABLE | ATTRIBUTE_SEEKABLE);
+}
+
+uint8 *MMapStream::map(void)
+{
+   return data_buffer;
+}
+
+void MMapStream::unmap(void)
+{
+
+}
+
+void MMapStream::advise(uint64_t offset)
+{
+#if defined(HAVE_MMAN) && defined(MADV_WILLNEED)
+   static uint64_t page_mask = 0;
+
+   if(!page_mask)
+      page_mask = (uint64_t)sysconf(_SC_PAGESIZE) - 1;
+
+   advised_start = offset & ~page_mask;
+   advised_end = MIN(advised_start + AdviseWindow, data_buffer_size);
+
+   madvise(data_buffer + advised_start, (size_t)(advised_end - advised_start), MADV_WILLNEED);
+#endif
+}
+
+uint64_t MMapStream::read(void *data, uint64_t count, bool error_on_eos)
+{
+   if(position >= data_buffer_size)
+      return 0;
+
+   if(count > (data_buffer_size - position))
+      count = data_buffer_size - position;
+
+   // A seek somewhere else, or sequential reading getting through half of the window: move the window up to here.
+   if(position < advised_start || (position + count) > advised_end ||
+         (advised_end < data_buffer_size && (position + count + AdviseWindow / 2) > advised_end))
+      advise(position);
+
+   memcpy(data, data_buffer + position, (size_t)count);
+   position += count;
+
+   return count;
+}
+
+void MMapStream::write(const void *data, uint64_t count)
+{
+}
+
+void MMapStream::seek(int64_t offset, int whence)
+{
+   int64_t new_position = position;
+
+   switch(whence)
+   {
+      case SEEK_SET:
+         new_position = offset;
+         break;
+
+      case SEEK_CUR:
+         new_position = position + offset;
+         break;
+
+      case SEEK_END:
+         new_position = data_buffer_size + offset;
+         break;
+   }
+
+   if(new_position < 0)
+      return;
+
+   position = new_position;
+}
+
+uint64_t MMapStream::tell(void)
+{
+   return position;
+}
+
+uint64_t MMapStream::size(void)
+{
+   return data_buffer_size;
+}
+
+void MMapStream::truncate(uint64_t length)
+{
+}
+
+void MMapStream::flush(void)
+{
+}
+
+void MMapStream::close(void)
+{
+#ifdef HAVE_MMAN
+   if(data_buffer)
+      munmap(data_buffer, (size_t)data_buffer_size);
+#endif
+
+   data_buffer = NULL;
+   data_buffer_size = 0;
+   position = 0;
+}
@@ -0,0 +1,62 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef __MDFN_MMAPSTREAM_H
+#define __MDFN_MMAPSTREAM_H
+
+#include "Stream.h"
+
+// Read-only stream over a memory-mapped file, so reads are plain copies out of the page cache(shared with any other
+// process that has the same file open) instead of a syscall each.  As reads move through the file, the pages just
+// ahead of them are requested from the kernel so they're usually resident by the time they're needed.
+//
+// Where files can't be mapped(no mmap() on the platform, an empty file...), map() returns NULL and the stream
+// shouldn't be used.
+class MMapStream : public Stream
+{
+   public:
+      MMapStream(const char *path);
+      virtual ~MMapStream();
+
+      virtual uint64_t attributes(void);
+
+      virtual uint8 *map(void);
+      virtual void unmap(void);
+
+      virtual uint64_t read(void *data, uint64_t count, bool error_on_eos = true);
+      virtual void write(const void *data, uint64_t count);
+      virtual void seek(int64_t offset, int whence);
+      virtual void truncate(uint64_t length);
+      virtual void flush(void);
+      virtual uint64_t tell(void);
+      virtual uint64_t size(void);
+      virtual void close(void);
+
+   private:
+      uint8 *data_buffer;
+      uint64_t data_buffer_size;
+
+      uint64_t position;
+
+      // Range last handed to madvise(MADV_WILLNEED).
+      uint64_t advised_start;
+      uint64_t advised_end;
+
+      void advise(uint64_t offset);
+};
+
+#endif
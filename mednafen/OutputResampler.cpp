@@ -0,0 +1,245 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mednafen.h"
+#include "OutputResampler.h"
+
+#include <math.h>
+#include <string.h>
+
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Filter length at or above the input rate; 48 taps with a Kaiser window(beta 8) give a stopband of about 80dB and a
+// transition about 4.5kHz wide at 44.1kHz, which a cutoff of 0.89 of the input's Nyquist frequency puts at about
+// 17.5-22kHz.
+#define RS_BASE_TAPS    48
+#define RS_CUTOFF       0.89
+#define RS_KAISER_BETA  8.0
+#define RS_PI           3.14159265358979323846
+
+static double BesselI0(double x)
+{
+   double sum = 1.0;
+   double term = 1.0;
+
+   for(unsigned k = 1; k < 64; k++)
+   {
+      const double t = x / (2 * k);
+
+      term *= t * t;
+      sum += term;
+
+      if(term < sum * 1e-12)
+         break;
+   }
+
+   return sum;
+}
+
+OutputResampler::OutputResampler() : in_rate(44100), out_rate(44100), adjust(1.0), rate_control(false), taps(0), step(0), pos_frac(0), hist_count(0)
+{
+   SetRates(in_rate, out_rate);
+}
+
+void OutputResampler::SetRates(double new_in_rate, double new_out_rate)
+{
+   const double ratio = std::min(1.0, new_out_rate / new_in_rate);
+   const double fc = RS_CUTOFF * ratio;
+   const double i0_beta = BesselI0(RS_KAISER_BETA);
+
+   in_rate = new_in_rate;
+   out_rate = new_out_rate;
+
+   taps = ((uint32_t)ceil(RS_BASE_TAPS / ratio) + 7) & ~7;
+
+   coeffs.resize((NUM_PHASES + 1) * taps);
+
+   for(unsigned p = 0; p <= NUM_PHASES; p++)
+   {
+      std::vector<double> row(taps);
+      double sum = 0;
+
+      for(unsigned k = 0; k < taps; k++)
+      {
+         // Distance from tap "k" to the output sample, which is "p" phases past the tap before the middle.
+         const double x = (double)(taps / 2 - 1) + (double)p / NUM_PHASES - k;
+         const double w = x / (taps / 2);
+         const double window = (fabs(w) >= 1.0) ? 0.0 : BesselI0(RS_KAISER_BETA * sqrt(1.0 - w * w)) / i0_beta;
+         const double sinc = (x == 0) ? 1.0 : sin(RS_PI * fc * x) / (RS_PI * fc * x);
+
+         row[k] = sinc * window;
+         sum += row[k];
+      }
+
+      // Unity gain at DC for every phase, so that the phase doesn't modulate the level.
+      for(unsigned k = 0; k < taps; k++)
+         coeffs[p * taps + k] = (int16_t)floor(row[k] / sum * (1 << COEFF_BITS) + 0.5);
+   }
+
+   hist_l.resize(taps + MAX_IN_FRAMES);
+   hist_r.resize(taps + MAX_IN_FRAMES);
+
+   Reset();
+   SetAdjust(adjust);
+}
+
+void OutputResampler::SetAdjust(double new_adjust)
+{
+   // A frontend doing rate control sends hints either side of 1.0; dropping in and out of passthrough as they cross
+   // it would click each time.
+   if(new_adjust != 1.0)
+      rate_control = true;
+
+   adjust = std::max(0.95, std::min(1.05, new_adjust));
+   step = (uint64_t)floor(in_rate / (out_rate * adjust) * 4294967296.0 + 0.5);
+
+   // Enough for the most that can be ready after a frame's worth of input, plus a little for rounding.
+   const uint64_t max_out = (((uint64_t)(taps + MAX_IN_FRAMES) << 32) / step) + 2;
+
+   if(out_buf.size() < max_out * 2)
+      out_buf.resize(max_out * 2);
+}
+
+bool OutputResampler::IsPassthrough(void) const
+{
+   return in_rate == out_rate && !rate_control;
+}
+
+void OutputResampler::Reset(void)
+{
+   // Start out with half the filter's worth of silence before the input, so the first output sample lines up with
+   // the first input sample.
+   hist_count = taps / 2 - 1;
+   memset(&hist_l[0], 0, hist_count * sizeof(int16_t));
+   memset(&hist_r[0], 0, hist_count * sizeof(int16_t));
+   pos_frac = 0;
+}
+
+static INLINE int16_t RS_Finish(int32_t a0, int32_t a1, uint32_t ifrac, unsigned coeff_bits)
+{
+   const int64_t v = (int64_t)a0 + (((int64_t)(a1 - a0) * ifrac) >> 16);
+   const int64_t r = (v + (1 << (coeff_bits - 1))) >> coeff_bits;
+
+   return (int16_t)std::max<int64_t>(-32768, std::min<int64_t>(32767, r));
+}
+
+const int16_t *OutputResampler::Process(const int16_t *in, uint32_t in_count, uint32_t *out_count)
+{
+   const uint32_t avail = hist_count + std::min<uint32_t>(in_count, MAX_IN_FRAMES);
+
+   for(uint32_t i = hist_count; i < avail; i++)
+   {
+      hist_l[i] = in[(i - hist_count) * 2 + 0];
+      hist_r[i] = in[(i - hist_count) * 2 + 1];
+   }
+
+   if(IsPassthrough())
+   {
+      // Keep the history as if this had been resampled at 1:1, so that the first hint carries on from here without
+      // a gap.
+      const uint32_t keep = taps / 2 - 1;
+
+      memmove(&hist_l[0], &hist_l[avail - keep], keep * sizeof(int16_t));
+      memmove(&hist_r[0], &hist_r[avail - keep], keep * sizeof(int16_t));
+      hist_count = keep;
+      pos_frac = 0;
+
+      *out_count = in_count;
+      return in;
+   }
+   uint64_t pos = pos_frac;
+   uint32_t n = 0;
+
+   while((uint32_t)(pos >> 32) + taps <= avail)
+   {
+      const uint32_t idx = pos >> 32;
+      const uint32_t phase = (uint32_t)pos >> (32 - PHASE_BITS);
+      const uint32_t ifrac = ((uint32_t)pos >> (32 - PHASE_BITS - 16)) & 0xFFFF;
+      const int16_t *c0 = &coeffs[phase * taps];
+      const int16_t *c1 = c0 + taps;
+      const int16_t *l = &hist_l[idx];
+      const int16_t *r = &hist_r[idx];
+      int32_t l0, l1, r0, r1;
+
+#if defined(__SSE2__)
+      __m128i al0 = _mm_setzero_si128();
+      __m128i al1 = _mm_setzero_si128();
+      __m128i ar0 = _mm_setzero_si128();
+      __m128i ar1 = _mm_setzero_si128();
+
+      for(uint32_t k = 0; k < taps; k += 8)
+      {
+         const __m128i xl = _mm_loadu_si128((const __m128i*)(l + k));
+         const __m128i xr = _mm_loadu_si128((const __m128i*)(r + k));
+         const __m128i k0 = _mm_loadu_si128((const __m128i*)(c0 + k));
+         const __m128i k1 = _mm_loadu_si128((const __m128i*)(c1 + k));
+
+         al0 = _mm_add_epi32(al0, _mm_madd_epi16(xl, k0));
+         al1 = _mm_add_epi32(al1, _mm_madd_epi16(xl, k1));
+         ar0 = _mm_add_epi32(ar0, _mm_madd_epi16(xr, k0));
+         ar1 = _mm_add_epi32(ar1, _mm_madd_epi16(xr, k1));
+      }
+
+      // Sum the four lanes of each accumulator, all at once.
+      const __m128i t0 = _mm_unpacklo_epi32(al0, al1);   // al0[0] al1[0] al0[1] al1[1]
+      const __m128i t1 = _mm_unpackhi_epi32(al0, al1);
+      const __m128i t2 = _mm_unpacklo_epi32(ar0, ar1);
+      const __m128i t3 = _mm_unpackhi_epi32(ar0, ar1);
+      const __m128i sl = _mm_add_epi32(t0, t1);           // l0 l1 l0 l1
+      const __m128i sr = _mm_add_epi32(t2, t3);
+      const __m128i s = _mm_add_epi32(_mm_unpacklo_epi64(sl, sr), _mm_unpackhi_epi64(sl, sr));   // l0 l1 r0 r1
+      int32_t sums[4];
+
+      _mm_storeu_si128((__m128i*)sums, s);
+      l0 = sums[0];
+      l1 = sums[1];
+      r0 = sums[2];
+      r1 = sums[3];
+#else
+      l0 = l1 = r0 = r1 = 0;
+
+      for(uint32_t k = 0; k < taps; k++)
+      {
+         l0 += l[k] * c0[k];
+         l1 += l[k] * c1[k];
+         r0 += r[k] * c0[k];
+         r1 += r[k] * c1[k];
+      }
+#endif
+
+      out_buf[n * 2 + 0] = RS_Finish(l0, l1, ifrac, COEFF_BITS);
+      out_buf[n * 2 + 1] = RS_Finish(r0, r1, ifrac, COEFF_BITS);
+      n++;
+
+      pos += step;
+   }
+
+   // Keep what the next output samples still need.
+   const uint32_t consumed = std::min<uint32_t>(pos >> 32, avail);
+
+   hist_count = avail - consumed;
+   memmove(&hist_l[0], &hist_l[consumed], hist_count * sizeof(int16_t));
+   memmove(&hist_r[0], &hist_r[consumed], hist_count * sizeof(int16_t));
+   pos_frac = (uint32_t)pos;
+
+   *out_count = n;
+   return &out_buf[0];
+}
@@ -0,0 +1,69 @@
+#ifndef __MDFN_OUTPUTRESAMPLER_H
+#define __MDFN_OUTPUTRESAMPLER_H
+
+#include <stdint.h>
+
+#include <vector>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Hint from the frontend for how far off its audio clock is from the rate reported in the AV info, as the ratio of
+// the rate it wants samples at to that rate(e.g. 1.002 when its buffer is running low and it wants 0.2% more samples);
+// it's applied from the next frame on, and is clamped to 0.95-1.05.
+void beetle_psx_audio_set_rate_adjust(double adjust);
+
+#ifdef __cplusplus
+}
+#endif
+
+// Converts 16-bit stereo from one rate to another with a windowed-sinc polyphase filter, interpolating between the two
+// nearest of its phases for each output sample.  The filter's cutoff is kept under both Nyquist frequencies, and its
+// length is stretched along with it when going down in rate, so that the cost per input sample stays about the same.
+// Input with the same rate goes through untouched, until the first adjustment.
+class OutputResampler
+{
+   public:
+      OutputResampler();
+
+      // Drops any buffered input.
+      void SetRates(double in_rate, double out_rate);
+
+      // Multiplies the output rate by "adjust" without rebuilding the filter; meant for small, frequent corrections.
+      void SetAdjust(double adjust);
+
+      // Returns true if Process() would hand back its input as is; that's with the same rate in and out, until the first
+      // adjustment.
+      bool IsPassthrough(void) const;
+
+      // Resamples "in_count" frames from "in", and returns the frames that are ready, "*out_count" of them; the pointer
+      // is valid until the next call.  Output lags input by half the filter's length.
+      const int16_t *Process(const int16_t *in, uint32_t in_count, uint32_t *out_count);
+
+   private:
+      enum { PHASE_BITS = 8 };
+      enum { NUM_PHASES = 1 << PHASE_BITS };
+      enum { COEFF_BITS = 14 };
+      enum { MAX_IN_FRAMES = 4096 };
+
+      void Reset(void);
+
+      double in_rate;
+      double out_rate;
+      double adjust;
+      bool rate_control;         // An adjustment other than 1.0 has been asked for; keep resampling from then on
+
+      uint32_t taps;             // Multiple of 8
+      uint64_t step;             // Input frames per output frame, 32.32
+      uint32_t pos_frac;         // Position of the next output frame past hist_*[0], in 1/2^32 frames
+
+      std::vector<int16_t> coeffs;  // NUM_PHASES + 1 phases of "taps" coefficients each
+      std::vector<int16_t> hist_l;
+      std::vector<int16_t> hist_r;
+      uint32_t hist_count;
+
+      std::vector<int16_t> out_buf;
+};
+
+#endif
@@ -1,40 +0,0 @@
-/*  dvdisaster: Additional error correction for optical media.
- *  Copyright (C) 2004-2007 Carsten Gnoerlich.
- *  Project home page: http://www.dvdisaster.com
- *  Email: carsten@dvdisaster.com  -or-  cgnoerlich@fsfe.org
- *
- *  The Reed-Solomon error correction draws a lot of inspiration - and even code -
- *  from Phil Karn's excellent Reed-Solomon library: http://www.ka9q.net/code/fec/
- *
- *  This program is free software; you can redistribute it and/or modify
- *  it under the terms of the GNU General Public License as published by
- *  the Free Software Foundation; either version 2 of the License, or
- *  (at your option) any later version.
- *
- *  This program is distributed in the hope that it will be useful,
- *  but WITHOUT ANY WARRANTY; without even the implied warranty of
- *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
- *  GNU General Public License for more details.
- *
- *  You should have received a copy of the GNU General Public License
- *  along with this program; if not, write to the Free Software
- *  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA,
- *  or direct your browser at http://www.gnu.org.
- */
-
-#include "dvdisaster.h"
-
-/*
- * The following routine is performance critical.
- */
-
-static inline int mod_fieldmax(int x)
-{
-  while (x >= GF_FIELDMAX) 
-  {
-    x -= GF_FIELDMAX;
-    x = (x >> GF_SYMBOLSIZE) + (x & GF_FIELDMAX);
-  }
-
-  return x;
-}
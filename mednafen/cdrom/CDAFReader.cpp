@@ -0,0 +1,266 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// CDAFR_Open(), and CDAFReader, will NOT take "ownership" of the Stream object(IE it won't ever delete it).  Though it does assume it has exclusive access
+// to it for as long as the CDAFReader object exists.
+
+// Don't allow exceptions to propagate into the vorbis/musepack/etc. libraries, as it could easily leave the state of the library's decoder "object" in an
+// inconsistent state, which would cause all sorts of unfun when we try to destroy it while handling the exception farther up.
+
+#include "../mednafen.h"
+#include "CDAFReader.h"
+#include "CDAFReader_Vorbis.h"
+
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+
+#include "../general.h"
+#include "../mednafen-endian.h"
+
+#include <retro_miscellaneous.h>
+#ifdef HAVE_THREADS
+#include <rthreads/rthreads.h>
+#endif
+
+CDAFReader::CDAFReader() : LastReadPos(0)
+{
+
+}
+
+CDAFReader::~CDAFReader()
+{
+
+}
+
+int64_t CDAFReader::Read_(int16_t *buffer, int64_t frames)
+{
+   abort();
+   return(false);
+}
+
+bool CDAFReader::Seek_(int64_t frame_offset)
+{
+   abort();
+   return(false);
+}
+
+int64_t CDAFReader::FrameCount(void)
+{
+   abort();
+   return(0);
+}
+
+#ifdef HAVE_THREADS
+// Runs another CDAFReader on its own thread, which keeps a ring of decoded PCM ahead of wherever the track is being
+// read from, so that reading a CD-DA sector is a copy out of the ring.  A bit of what has already been read is
+// kept too, since the CDC tends to step back a few sectors when it seeks.
+class CDAFReader_Threaded : public CDAFReader
+{
+   public:
+      CDAFReader_Threaded(CDAFReader *ar);
+      ~CDAFReader_Threaded();
+
+      int64_t Read_(int16_t *buffer, int64_t frames);
+      bool Seek_(int64_t frame_offset);
+      int64_t FrameCount(void);
+
+   private:
+      enum { RingFrames = 44100 * 3 };  // Must hold DecodeChunk frames past ReadAhead.
+      enum { ReadAhead = 44100 * 2 };
+      enum { DecodeChunk = 4096 };
+
+      CDAFReader *ar;
+      int64_t frame_count;
+
+      int64_t read_pos;
+
+      sthread_t *thread;
+      slock_t *mutex;
+      scond_t *cond;
+
+      // Everything below is protected by mutex.  Decoded frames [ring_start, ring_end) are in the ring, frame "f" at
+      // ring[(f % RingFrames) * 2].
+      int16_t *ring;
+      int64_t ring_start;
+      int64_t ring_end;
+      int64_t want_pos;
+      bool restart;
+      bool quit;
+
+      void DecodeThread(void);
+      static void DecodeThreadStart(void *data);
+};
+
+CDAFReader_Threaded::CDAFReader_Threaded(CDAFReader *ar) : ar(ar), read_pos(0), thread(NULL), mutex(NULL), cond(NULL), ring(NULL),
+   ring_start(0), ring_end(0), want_pos(0), restart(false), quit(false)
+{
+   frame_count = ar->FrameCount();
+}
+
+CDAFReader_Threaded::~CDAFReader_Threaded()
+{
+   if(thread)
+   {
+      slock_lock(mutex);
+      quit = true;
+      scond_broadcast(cond);
+      slock_unlock(mutex);
+
+      sthread_join(thread);
+   }
+
+   if(cond)
+      scond_free(cond);
+
+   if(mutex)
+      slock_free(mutex);
+
+   if(ring)
+      delete[] ring;
+
+   delete ar;
+}
+
+void CDAFReader_Threaded::DecodeThreadStart(void *data)
+{
+   ((CDAFReader_Threaded *)data)->DecodeThread();
+}
+
+void CDAFReader_Threaded::DecodeThread(void)
+{
+   int16_t *decode_buf = new int16_t[DecodeChunk * 2];
+
+   slock_lock(mutex);
+
+   while(!quit)
+   {
+      int64_t pos, count, didread;
+
+      if(restart)
+      {
+         ring_start = ring_end = want_pos;
+         restart = false;
+         scond_broadcast(cond);
+      }
+
+      if(ring_end >= frame_count || (ring_end - want_pos) >= ReadAhead)
+      {
+         scond_wait(cond, mutex);
+         continue;
+      }
+
+      pos = ring_end;
+      count = MIN((int64_t)DecodeChunk, frame_count - pos);
+
+      slock_unlock(mutex);
+      didread = ar->Read(pos, decode_buf, count);
+      slock_lock(mutex);
+
+      // Reader went somewhere else in the meantime.
+      if(restart)
+         continue;
+
+      // Short read means the stream is shorter than it claimed; don't keep trying past the end.
+      if(didread < count)
+         frame_count = pos + didread;
+
+      if(ring_end + didread - ring_start > RingFrames)
+         ring_start = ring_end + didread - RingFrames;
+
+      for(int64_t i = 0; i < didread; i++)
+      {
+         const int64_t ri = ((pos + i) % RingFrames) * 2;
+
+         ring[ri + 0] = decode_buf[i * 2 + 0];
+         ring[ri + 1] = decode_buf[i * 2 + 1];
+      }
+
+      ring_end += didread;
+      scond_broadcast(cond);
+   }
+
+   slock_unlock(mutex);
+
+   delete[] decode_buf;
+}
+
+int64_t CDAFReader_Threaded::Read_(int16_t *buffer, int64_t frames)
+{
+   int64_t ret;
+
+   if(!thread)
+   {
+      ring = new int16_t[RingFrames * 2];
+      mutex = slock_new();
+      cond = scond_new();
+      ring_start = ring_end = want_pos = read_pos;
+      thread = sthread_create(DecodeThreadStart, this);
+   }
+
+   slock_lock(mutex);
+
+   want_pos = read_pos;
+
+   // Behind what's held, or far enough ahead that an indexed seek beats decoding up to it.
+   if(!restart && (read_pos < ring_start || read_pos > (ring_end + ReadAhead)))
+      restart = true;
+
+   scond_broadcast(cond);
+
+   while(restart || (ring_end < MIN(read_pos + frames, frame_count)))
+      scond_wait(cond, mutex);
+
+   ret = MAX((int64_t)0, MIN(frames, ring_end - read_pos));
+
+   for(int64_t i = 0; i < ret; i++)
+   {
+      const int64_t ri = ((read_pos + i) % RingFrames) * 2;
+
+      buffer[i * 2 + 0] = ring[ri + 0];
+      buffer[i * 2 + 1] = ring[ri + 1];
+   }
+
+   read_pos += ret;
+   want_pos = read_pos;
+   scond_broadcast(cond);
+
+   slock_unlock(mutex);
+
+   return(ret);
+}
+
+bool CDAFReader_Threaded::Seek_(int64_t frame_offset)
+{
+   read_pos = frame_offset;
+   return(true);
+}
+
+int64_t CDAFReader_Threaded::FrameCount(void)
+{
+   return(frame_count);
+}
+#endif
+
+CDAFReader *CDAFR_Open(Stream *fp)
+{
+#ifdef HAVE_THREADS
+   return new CDAFReader_Threaded(CDAFR_Vorbis_Open(fp));
+#else
+   return CDAFR_Vorbis_Open(fp);
+#endif
+}
@@ -1,13 +1,13 @@
-#ifndef __MDFN_AUDIOREADER_H
-#define __MDFN_AUDIOREADER_H
+#ifndef __MDFN_CDAFREADER_H
+#define __MDFN_CDAFREADER_H
 
 #include "../Stream.h"
 
-class AudioReader
+class CDAFReader
 {
    public:
-      AudioReader();
-      virtual ~AudioReader();
+      CDAFReader();
+      virtual ~CDAFReader();
 
       virtual int64_t FrameCount(void);
       INLINE int64_t Read(int64_t frame_offset, int16_t *buffer, int64_t frames)
@@ -34,8 +34,10 @@ class AudioReader
       int64_t LastReadPos;
 };
 
-// AR_Open(), and AudioReader, will NOT take "ownership" of the Stream object(IE it won't ever delete it).  Though it does assume it has exclusive access
-// to it for as long as the AudioReader object exists.
-AudioReader *AR_Open(Stream *fp);
+// CDAFR_Open(), and CDAFReader, will NOT take "ownership" of the Stream object(IE it won't ever delete it).  Though it does assume it has exclusive access
+// to it for as long as the CDAFReader object exists.
+//
+// With HAVE_THREADS, the returned reader decodes ahead on a thread of its own, started by the first Read().
+CDAFReader *CDAFR_Open(Stream *fp);
 
 #endif
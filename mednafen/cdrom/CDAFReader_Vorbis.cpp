@@ -0,0 +1,263 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Don't allow exceptions to propagate into the vorbis library, as it could easily leave the state of the library's decoder "object" in an
+// inconsistent state, which would cause all sorts of unfun when we try to destroy it while handling the exception farther up.
+
+#include "../mednafen.h"
+#include "CDAFReader.h"
+#include "CDAFReader_Vorbis.h"
+
+#include "../tremor/ivorbisfile.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "../mednafen-endian.h"
+
+#include <retro_miscellaneous.h>
+
+class CDAFReader_Vorbis : public CDAFReader
+{
+   public:
+      CDAFReader_Vorbis(Stream *fp);
+      ~CDAFReader_Vorbis();
+
+      int64_t Read_(int16_t *buffer, int64_t frames);
+      bool Seek_(int64_t frame_offset);
+      int64_t FrameCount(void);
+
+   private:
+      OggVorbis_File ovfile;
+      Stream *fp;
+
+      // (granule position, file offset) of every Ogg page that ends a packet, so a seek can jump straight to a page
+      // just before the target instead of bisecting the file.
+      struct SeekPoint
+      {
+         int64_t granule;
+         int64_t offset;
+      };
+
+      static bool SeekPointGranuleLess(const SeekPoint &a, const SeekPoint &b)
+      {
+         return(a.granule < b.granule);
+      }
+
+      std::vector<SeekPoint> SeekIndex;
+      bool SeekIndexBuilt;
+
+      void BuildSeekIndex(void);
+      bool SkipFrames(int64_t count);
+};
+
+
+static size_t iov_read_func(void *ptr, size_t size, size_t nmemb, void *user_data)
+{
+   Stream *fw = (Stream*)user_data;
+
+   if(!size || !fw)
+      return(0);
+
+   return fw->read(ptr, size * nmemb, false) / size;
+}
+
+static int iov_seek_func(void *user_data, ogg_int64_t offset, int whence)
+{
+   Stream *fw = (Stream*)user_data;
+
+   if (fw)
+      fw->seek(offset, whence);
+   return(0);
+}
+
+static int iov_close_func(void *user_data)
+{
+   Stream *fw = (Stream*)user_data;
+
+   if (fw)
+      fw->close();
+   return(0);
+}
+
+static long iov_tell_func(void *user_data)
+{
+   Stream *fw = (Stream*)user_data;
+
+   if (!fw)
+      return -1;
+
+   return fw->tell();
+}
+
+CDAFReader_Vorbis::CDAFReader_Vorbis(Stream *fp) : fp(fp), SeekIndexBuilt(false)
+{
+   ov_callbacks cb;
+
+   memset(&cb, 0, sizeof(cb));
+   cb.read_func = iov_read_func;
+   cb.seek_func = iov_seek_func;
+   cb.close_func = iov_close_func;
+   cb.tell_func = iov_tell_func;
+
+   fp->seek(0, SEEK_SET);
+   if(ov_open_callbacks(fp, &ovfile, NULL, 0, cb))
+      throw(0);
+}
+
+CDAFReader_Vorbis::~CDAFReader_Vorbis()
+{
+   ov_clear(&ovfile);
+}
+
+int64_t CDAFReader_Vorbis::Read_(int16_t *buffer, int64_t frames)
+{
+   uint8 *tw_buf = (uint8 *)buffer;
+   int cursection = 0;
+   long toread = frames * sizeof(int16_t) * 2;
+
+   while(toread > 0)
+   {
+      long didread = ov_read(&ovfile, (char*)tw_buf, toread, &cursection);
+
+      if(didread == 0)
+         break;
+
+      tw_buf = (uint8 *)tw_buf + didread;
+      toread -= didread;
+   }
+
+   return(frames - toread / sizeof(int16_t) / 2);
+}
+
+// Walks the Ogg page headers of the file, without decoding anything.  Chained files, and anything that doesn't parse
+// cleanly, are left without an index and go through ov_pcm_seek() as before.
+void CDAFReader_Vorbis::BuildSeekIndex(void)
+{
+   const int64_t file_size = fp->size();
+   int64_t offset = 0;
+
+   SeekIndexBuilt = true;
+
+   if(!ov_seekable(&ovfile) || ov_streams(&ovfile) != 1)
+      return;
+
+   fp->seek(0, SEEK_SET);
+
+   while(offset < file_size)
+   {
+      uint8 header[27];
+      uint8 lacing[255];
+      int64_t granule;
+      uint32 body_size = 0;
+
+      if(fp->read(header, sizeof(header), false) != sizeof(header) || memcmp(header, "OggS", 4))
+         break;
+
+      if(fp->read(lacing, header[26], false) != header[26])
+         break;
+
+      for(unsigned i = 0; i < header[26]; i++)
+         body_size += lacing[i];
+
+      granule = (int64_t)MDFN_de64lsb(&header[6]);
+
+      // Pages before the first audio page only carry the stream headers.
+      if(granule != -1 && offset >= ovfile.dataoffsets[0])
+      {
+         SeekPoint sp;
+
+         sp.granule = granule;
+         sp.offset = offset;
+         SeekIndex.push_back(sp);
+      }
+
+      offset += sizeof(header) + header[26] + body_size;
+      fp->seek(offset, SEEK_SET);
+   }
+
+   if(offset != file_size)
+      SeekIndex.clear();
+}
+
+// Decodes and throws away "count" frames.
+bool CDAFReader_Vorbis::SkipFrames(int64_t count)
+{
+   int16_t discard[1024 * 2];
+
+   while(count > 0)
+   {
+      int64_t didread = Read_(discard, MIN(count, (int64_t)1024));
+
+      if(!didread)
+         return(false);
+
+      count -= didread;
+   }
+
+   return(true);
+}
+
+bool CDAFReader_Vorbis::Seek_(int64_t frame_offset)
+{
+   // The decoder needs a packet or two of history before its output is settled, and a page's granule position is
+   // the end of its last packet, so land a couple of maximum-size blocks before the target.
+   static const int64_t SeekPreroll = 8192;
+
+   if(!SeekIndexBuilt)
+      BuildSeekIndex();
+
+   if(SeekIndex.size())
+   {
+      SeekPoint target;
+      std::vector<SeekPoint>::const_iterator it;
+
+      target.granule = frame_offset + ovfile.pcmlengths[0] - SeekPreroll;
+      target.offset = 0;
+
+      it = std::upper_bound(SeekIndex.begin(), SeekIndex.end(), target, SeekPointGranuleLess);
+
+      if(it != SeekIndex.begin())
+      {
+         --it;
+
+         // ov_raw_seek() leaves ov_pcm_tell() exact, so from there it's just decoding up to the target.
+         if(!ov_raw_seek(&ovfile, it->offset))
+         {
+            const int64_t pos = ov_pcm_tell(&ovfile);
+
+            if(pos >= 0 && pos <= frame_offset && SkipFrames(frame_offset - pos))
+               return(true);
+         }
+      }
+   }
+
+   ov_pcm_seek(&ovfile, frame_offset);
+   return(true);
+}
+
+int64_t CDAFReader_Vorbis::FrameCount(void)
+{
+   return(ov_pcm_total(&ovfile, -1));
+}
+
+CDAFReader *CDAFR_Vorbis_Open(Stream *fp)
+{
+   return new CDAFReader_Vorbis(fp);
+}
@@ -0,0 +1,8 @@
+#ifndef __MDFN_CDAFREADER_VORBIS_H
+#define __MDFN_CDAFREADER_VORBIS_H
+
+#include "CDAFReader.h"
+
+CDAFReader *CDAFR_Vorbis_Open(Stream *fp);
+
+#endif
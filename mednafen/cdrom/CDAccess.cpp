@@ -24,11 +24,15 @@
 #endif
 
 #include "../mednafen.h"
+#include "../FileStream.h"
+#include "../MemoryStream.h"
+#include "../MMapStream.h"
 
 #include "CDAccess.h"
 #include "CDAccess_Image.h"
 #include "CDAccess_CCD.h"
 #include "CDAccess_PBP.h"
+#include "CDAccess_CHD.h"
 
 CDAccess::CDAccess()
 {
@@ -40,6 +44,11 @@ CDAccess::~CDAccess()
 
 }
 
+bool CDAccess::Prefetch(void)
+{
+ return false;
+}
+
 CDAccess *cdaccess_open_image(bool *success, const char *path, bool image_memcache)
 {
    if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".ccd"))
@@ -48,5 +57,24 @@ CDAccess *cdaccess_open_image(bool *success, const char *path, bool image_memcac
    else if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".pbp"))
       return new CDAccess_PBP(path, image_memcache);
 #endif
+   else if(strlen(path) >= 4 && !strcasecmp(path + strlen(path) - 4, ".chd"))
+      return new CDAccess_CHD(success, path, image_memcache);
    return new CDAccess_Image(success, path, image_memcache);
 }
+
+Stream *cdaccess_open_stream(const char *path, bool image_memcache)
+{
+   MMapStream *ms;
+
+   if(image_memcache)
+      return new MemoryStream(new FileStream(path, MODE_READ));
+
+   ms = new MMapStream(path);
+
+   if(ms->map())
+      return ms;
+
+   delete ms;
+
+   return new FileStream(path, MODE_READ);
+}
@@ -22,6 +22,10 @@ class CDAccess
 
  virtual void Eject(bool eject_status) = 0;		// Eject a disc if it's physical, otherwise NOP.  Returns true on success(or NOP), false on error
 
+ // Does a bit of background work(like decompressing sectors that are likely to be read soon), called by the CDIF_MT
+ // read thread when it has nothing better to do.  Returns true if there's more to be done.
+ virtual bool Prefetch(void);
+
  private:
  CDAccess(const CDAccess&);	// No copy constructor.
  CDAccess& operator=(const CDAccess&); // No assignment operator.
@@ -29,4 +33,10 @@ class CDAccess
 
 CDAccess *cdaccess_open_image(bool *success, const char *path, bool image_memcache);
 
+class Stream;
+
+// Opens a file an image refers to(BIN track, CCD IMG/SUB...) for reading: loaded whole into memory if "image_memcache",
+// otherwise memory-mapped where possible, with a FileStream to fall back on.
+Stream *cdaccess_open_stream(const char *path, bool image_memcache);
+
 #endif
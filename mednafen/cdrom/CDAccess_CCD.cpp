@@ -248,12 +248,7 @@ bool CDAccess_CCD::Load(const char *path, bool image_memcache)
    /* Open image stream. */
    {
       std::string image_path = MDFN_EvalFIP(dir_path, file_base + std::string(".") + std::string(img_extsd), true);
-      FileStream *str        = new FileStream(image_path.c_str(), MODE_READ);
-
-      if(image_memcache)
-         img_stream = new MemoryStream(str);
-      else
-         img_stream = str;
+      img_stream             = cdaccess_open_stream(image_path.c_str(), image_memcache);
 
       int64 ss = img_stream->size();
 
@@ -269,12 +264,7 @@ bool CDAccess_CCD::Load(const char *path, bool image_memcache)
    {
       /* Open subchannel stream */
       std::string sub_path = MDFN_EvalFIP(dir_path, file_base + std::string(".") + std::string(sub_extsd), true);
-      FileStream *str      = new FileStream(sub_path.c_str(), MODE_READ);
-
-      if(image_memcache)
-         sub_stream = new MemoryStream(str);
-      else
-         sub_stream = str;
+      sub_stream           = cdaccess_open_stream(sub_path.c_str(), image_memcache);
 
       if(sub_stream->size() != (int64)img_numsectors * 96)
       {
@@ -0,0 +1,1285 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ Notes and TODO:
+
+	Only version 5 CHDs(what chdman has written since 0.146) are supported, and only CD ones; parent CHDs aren't.
+
+	Hunks are decompressed as they're needed, into a small LRU cache, so with CDIF_MT it's the read-ahead thread that
+	does the work.  With image_memcache, the compressed image is loaded into memory, but is still decompressed as it's
+	read.
+
+	Track layout follows what chdman writes: each track's frames(pregap included when its data is in the image, as
+	PGTYPE "V...") padded to a multiple of 4, with postgaps not stored at all.
+*/
+
+#include <boolean.h>
+#include <retro_stat.h>
+
+#include "../mednafen.h"
+
+#include <string.h>
+
+#include "../general.h"
+#include "../mednafen-endian.h"
+#include "../FileStream.h"
+#include "../MemoryStream.h"
+
+#include "CDAccess.h"
+#include "CDAccess_CHD.h"
+#include "CDUtility.h"
+#include "lec.h"
+#include "lzmadec.h"
+#include "flacdec.h"
+
+#include "zlib.h"
+
+enum
+{
+   CDRF_SUBM_NONE = 0,
+   CDRF_SUBM_RW,
+   CDRF_SUBM_RW_RAW
+};
+
+// Disk-image(rip) track/sector formats
+enum
+{
+   DI_FORMAT_AUDIO       = 0x00,
+   DI_FORMAT_MODE1       = 0x01,
+   DI_FORMAT_MODE1_RAW   = 0x02,
+   DI_FORMAT_MODE2       = 0x03,
+   DI_FORMAT_MODE2_FORM1 = 0x04,
+   DI_FORMAT_MODE2_FORM2 = 0x05,
+   DI_FORMAT_MODE2_RAW   = 0x06,
+   _DI_FORMAT_COUNT
+};
+
+static const struct
+{
+   const char *name;
+   uint32_t format;
+} CHD_TrackTypes[] =
+{
+   { "AUDIO", DI_FORMAT_AUDIO },
+   { "MODE1", DI_FORMAT_MODE1 },
+   { "MODE1_RAW", DI_FORMAT_MODE1_RAW },
+   { "MODE2", DI_FORMAT_MODE2 },
+   { "MODE2_FORM1", DI_FORMAT_MODE2_FORM1 },
+   { "MODE2_FORM2", DI_FORMAT_MODE2_FORM2 },
+   { "MODE2_FORM_MIX", DI_FORMAT_MODE2 },
+   { "MODE2_RAW", DI_FORMAT_MODE2_RAW },
+};
+
+#define CHD_TAG(a, b, c, d) (((uint32_t)(a) << 24) | ((uint32_t)(b) << 16) | ((uint32_t)(c) << 8) | (uint32_t)(d))
+
+enum
+{
+   CHD_CODEC_ZLIB    = CHD_TAG('z', 'l', 'i', 'b'),
+   CHD_CODEC_LZMA    = CHD_TAG('l', 'z', 'm', 'a'),
+   CHD_CODEC_CD_ZLIB = CHD_TAG('c', 'd', 'z', 'l'),
+   CHD_CODEC_CD_LZMA = CHD_TAG('c', 'd', 'l', 'z'),
+   CHD_CODEC_CD_FLAC = CHD_TAG('c', 'd', 'f', 'l')
+};
+
+enum
+{
+   CHD_META_CDROM_TRACK  = CHD_TAG('C', 'H', 'T', 'R'),
+   CHD_META_CDROM_TRACK2 = CHD_TAG('C', 'H', 'T', '2'),
+   CHD_META_GDROM_TRACK  = CHD_TAG('C', 'H', 'G', 'D')
+};
+
+// Hunk types in the compressed map
+enum
+{
+   CHD_COMP_TYPE0 = 0,	// Compressed with compressors[0 ... 3]
+   CHD_COMP_TYPE1,
+   CHD_COMP_TYPE2,
+   CHD_COMP_TYPE3,
+   CHD_COMP_NONE,
+   CHD_COMP_SELF,
+   CHD_COMP_PARENT,
+   CHD_COMP_RLE_SMALL,
+   CHD_COMP_RLE_LARGE,
+   CHD_COMP_SELF_0,
+   CHD_COMP_SELF_1,
+   CHD_COMP_PARENT_SELF,
+   CHD_COMP_PARENT_0,
+   CHD_COMP_PARENT_1,
+
+   CHD_HUNK_RAW = 0x80	// Ours, for uncompressed CHDs: stored as-is, with no CRC; offset 0 means all zeros.
+};
+
+static const uint32_t CHD_V5_HEADER_SIZE = 124;
+static const uint32_t CHD_FRAME_SIZE = 2352 + 96;
+static const uint32_t CHD_TRACK_PADDING = 4;
+
+static uint64_t CHD_de48msb(const uint8_t *morp)
+{
+   return ((uint64_t)MDFN_de16msb(morp) << 32) | MDFN_de32msb(morp + 2);
+}
+
+static uint64_t CHD_de64msb(const uint8_t *morp)
+{
+   return ((uint64_t)MDFN_de32msb(morp) << 32) | MDFN_de32msb(morp + 4);
+}
+
+static uint16_t CHD_crc16(const uint8_t *data, uint32_t len)
+{
+   uint16_t crc = 0xFFFF;
+
+   while(len--)
+   {
+      crc ^= *data++ << 8;
+
+      for(unsigned i = 0; i < 8; i++)
+         crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+   }
+
+   return crc;
+}
+
+// MSB-first bit reader for the compressed hunk map; reads past the end give 0s, which Overrun() catches.
+class CHD_BitReader
+{
+   public:
+
+      CHD_BitReader(const uint8_t *d, uint32_t l) : data(d), len(l), pos(0)
+      {
+      }
+
+      uint32_t Read(unsigned count)
+      {
+         uint32_t ret = Peek(count);
+
+         pos += count;
+         return ret;
+      }
+
+      uint32_t Peek(unsigned count)
+      {
+         uint32_t ret = 0;
+
+         for(unsigned i = 0; i < count; i++)
+         {
+            const uint64_t bit_pos = pos + i;
+            const uint32_t byte = bit_pos >> 3;
+
+            ret <<= 1;
+
+            if(byte < len)
+               ret |= (data[byte] >> (7 - (bit_pos & 7))) & 1;
+         }
+
+         return ret;
+      }
+
+      void Skip(unsigned count)
+      {
+         pos += count;
+      }
+
+      bool Overrun(void)
+      {
+         return pos > ((uint64_t)len * 8);
+      }
+
+   private:
+      const uint8_t *data;
+      uint32_t len;
+      uint64_t pos;
+};
+
+// The Huffman code the hunk types are coded with: 16 symbols, codes of up to 8 bits.
+class CHD_MapHuffman
+{
+   public:
+
+      bool ImportTreeRLE(CHD_BitReader &br)
+      {
+         uint8_t numbits[NumCodes];
+         unsigned cur = 0;
+
+         while(cur < NumCodes)
+         {
+            unsigned nodebits = br.Read(4);
+
+            if(nodebits != 1)
+               numbits[cur++] = nodebits;
+            else
+            {
+               nodebits = br.Read(4);
+
+               if(nodebits == 1)
+                  numbits[cur++] = nodebits;
+               else
+               {
+                  unsigned repcount = br.Read(4) + 3;
+
+                  if((cur + repcount) > NumCodes)
+                     return false;
+
+                  while(repcount--)
+                     numbits[cur++] = nodebits;
+               }
+            }
+         }
+
+         return AssignCanonicalCodes(numbits);
+      }
+
+      unsigned DecodeOne(CHD_BitReader &br)
+      {
+         const uint16_t entry = Lookup[br.Peek(MaxBits)];
+
+         br.Skip(entry & 0x1F);
+
+         return entry >> 5;
+      }
+
+   private:
+
+      enum { NumCodes = 16, MaxBits = 8 };
+
+      uint16_t Lookup[1 << MaxBits];	// Symbol << 5 | code length
+
+      bool AssignCanonicalCodes(const uint8_t *numbits)
+      {
+         uint32_t bithisto[33];
+         uint32_t curstart = 0;
+
+         memset(bithisto, 0, sizeof(bithisto));
+
+         for(unsigned code = 0; code < NumCodes; code++)
+         {
+            if(numbits[code] > MaxBits)
+               return false;
+
+            bithisto[numbits[code]]++;
+         }
+
+         for(unsigned codelen = 32; codelen > 0; codelen--)
+         {
+            const uint32_t nextstart = (curstart + bithisto[codelen]) >> 1;
+
+            if(codelen != 1 && (nextstart * 2) != (curstart + bithisto[codelen]))
+               return false;
+
+            bithisto[codelen] = curstart;
+            curstart = nextstart;
+         }
+
+         memset(Lookup, 0, sizeof(Lookup));
+
+         for(unsigned code = 0; code < NumCodes; code++)
+         {
+            if(numbits[code])
+            {
+               const uint32_t bits = bithisto[numbits[code]]++;
+               const unsigned shift = MaxBits - numbits[code];
+
+               for(uint32_t i = bits << shift; i < ((bits + 1) << shift) && i < (1U << MaxBits); i++)
+                  Lookup[i] = (code << 5) | numbits[code];
+            }
+         }
+
+         return true;
+      }
+};
+
+bool CDAccess_CHD::ReadMap(uint64_t mapoffset, uint32_t hunkcount, uint32_t unitbytes)
+{
+   uint8_t maphead[16];
+   uint32_t mapbytes;
+   uint64_t curoffset;
+   uint16_t mapcrc;
+   uint8_t lengthbits, selfbits, parentbits;
+   std::vector<uint8_t> compmap;
+   std::vector<uint8_t> rawmap(hunkcount * 12);
+   CHD_MapHuffman huff;
+   uint8_t lastcomp = 0;
+   uint32_t repcount = 0;
+   uint64_t last_self = 0;
+   uint64_t last_parent = 0;
+
+   HunkMap.resize(hunkcount);
+
+   //
+   // Uncompressed CHD: the map is just a hunk index for each hunk.
+   //
+   if(!compressors[0])
+   {
+      std::vector<uint8_t> map(hunkcount * 4);
+
+      fp->seek(mapoffset, SEEK_SET);
+
+      if(fp->read(&map[0], map.size(), false) != map.size())
+      {
+         MDFN_Error(0, _("CHD hunk map is truncated."));
+         return false;
+      }
+
+      for(uint32_t hunknum = 0; hunknum < hunkcount; hunknum++)
+      {
+         HunkMap[hunknum].type = CHD_HUNK_RAW;
+         HunkMap[hunknum].length = hunkbytes;
+         HunkMap[hunknum].offset = (uint64_t)MDFN_de32msb(&map[hunknum * 4]) * hunkbytes;
+         HunkMap[hunknum].crc = 0;
+      }
+
+      return true;
+   }
+
+   fp->seek(mapoffset, SEEK_SET);
+
+   if(fp->read(maphead, sizeof(maphead), false) != sizeof(maphead))
+   {
+      MDFN_Error(0, _("CHD hunk map is truncated."));
+      return false;
+   }
+
+   mapbytes = MDFN_de32msb(&maphead[0]);
+   curoffset = CHD_de48msb(&maphead[4]);
+   mapcrc = MDFN_de16msb(&maphead[10]);
+   lengthbits = maphead[12];
+   selfbits = maphead[13];
+   parentbits = maphead[14];
+
+   if(lengthbits > 32 || selfbits > 32 || parentbits > 32 || mapbytes > (hunkcount * 16 + 64))
+   {
+      MDFN_Error(0, _("CHD hunk map is corrupt."));
+      return false;
+   }
+
+   compmap.resize(mapbytes + 1);
+
+   if(fp->read(&compmap[0], mapbytes, false) != mapbytes)
+   {
+      MDFN_Error(0, _("CHD hunk map is truncated."));
+      return false;
+   }
+
+   CHD_BitReader br(&compmap[0], mapbytes);
+
+   if(!huff.ImportTreeRLE(br))
+   {
+      MDFN_Error(0, _("CHD hunk map is corrupt."));
+      return false;
+   }
+
+   // First the hunk types, run-length coded...
+   for(uint32_t hunknum = 0; hunknum < hunkcount; hunknum++)
+   {
+      if(repcount)
+         repcount--;
+      else
+      {
+         const unsigned val = huff.DecodeOne(br);
+
+         if(val == CHD_COMP_RLE_SMALL)
+            repcount = 2 + huff.DecodeOne(br);
+         else if(val == CHD_COMP_RLE_LARGE)
+         {
+            repcount = 2 + 16 + (huff.DecodeOne(br) << 4);
+            repcount += huff.DecodeOne(br);
+         }
+         else
+            lastcomp = val;
+      }
+
+      rawmap[hunknum * 12] = lastcomp;
+   }
+
+   // ...then where each one is.
+   for(uint32_t hunknum = 0; hunknum < hunkcount; hunknum++)
+   {
+      HunkMapEntry *e = &HunkMap[hunknum];
+      uint8_t *raw = &rawmap[hunknum * 12];
+
+      e->type = raw[0];
+      e->offset = curoffset;
+      e->length = 0;
+      e->crc = 0;
+
+      switch(e->type)
+      {
+         case CHD_COMP_TYPE0:
+         case CHD_COMP_TYPE1:
+         case CHD_COMP_TYPE2:
+         case CHD_COMP_TYPE3:
+            curoffset += e->length = br.Read(lengthbits);
+            e->crc = br.Read(16);
+            break;
+
+         case CHD_COMP_NONE:
+            curoffset += e->length = hunkbytes;
+            e->crc = br.Read(16);
+            break;
+
+         case CHD_COMP_SELF:
+            last_self = e->offset = br.Read(selfbits);
+            break;
+
+         case CHD_COMP_PARENT:
+            last_parent = e->offset = br.Read(parentbits);
+            break;
+
+         case CHD_COMP_SELF_1:
+            last_self++;
+         case CHD_COMP_SELF_0:
+            e->type = CHD_COMP_SELF;
+            e->offset = last_self;
+            break;
+
+         case CHD_COMP_PARENT_SELF:
+            e->type = CHD_COMP_PARENT;
+            last_parent = e->offset = ((uint64_t)hunknum * hunkbytes) / unitbytes;
+            break;
+
+         case CHD_COMP_PARENT_1:
+            last_parent += hunkbytes / unitbytes;
+         case CHD_COMP_PARENT_0:
+            e->type = CHD_COMP_PARENT;
+            e->offset = last_parent;
+            break;
+
+         default:
+            MDFN_Error(0, _("CHD hunk map is corrupt."));
+            return false;
+      }
+
+      raw[0] = e->type;
+      MDFN_en24msb(&raw[1], e->length);
+      MDFN_en16msb(&raw[4], e->offset >> 32);
+      MDFN_en32msb(&raw[6], e->offset);
+      MDFN_en16msb(&raw[10], e->crc);
+   }
+
+   if(br.Overrun() || CHD_crc16(&rawmap[0], rawmap.size()) != mapcrc)
+   {
+      MDFN_Error(0, _("CHD hunk map is corrupt."));
+      return false;
+   }
+
+   return true;
+}
+
+bool CDAccess_CHD::ReadMetadata(uint64_t metaoffset)
+{
+   int32_t chd_frame = 0;
+   int32 RunningLBA = 0;
+   unsigned entries = 0;
+
+   FirstTrack = 99;
+   LastTrack = 0;
+
+   while(metaoffset)
+   {
+      uint8_t metahead[16];
+      char metadata[256];
+      uint32_t metatag;
+      uint32_t metalength;
+      int tracknum = 0, frames = 0, pregap = 0, postgap = 0;
+      char type[32], subtype[32], pgtype[32], pgsub[32];
+      CDRFILE_TRACK_INFO *track;
+      bool type_found = false;
+
+      if(++entries > 4096)
+      {
+         MDFN_Error(0, _("CHD metadata is corrupt."));
+         return false;
+      }
+
+      fp->seek(metaoffset, SEEK_SET);
+
+      if(fp->read(metahead, sizeof(metahead), false) != sizeof(metahead))
+      {
+         MDFN_Error(0, _("CHD metadata is truncated."));
+         return false;
+      }
+
+      metatag = MDFN_de32msb(&metahead[0]);
+      metalength = MDFN_de24msb(&metahead[5]);
+      metaoffset = CHD_de64msb(&metahead[8]);
+
+      if(metatag == CHD_META_GDROM_TRACK)
+      {
+         MDFN_Error(0, _("GD-ROM CHDs are not supported."));
+         return false;
+      }
+
+      if(metatag != CHD_META_CDROM_TRACK && metatag != CHD_META_CDROM_TRACK2)
+         continue;
+
+      if(metalength >= sizeof(metadata) || fp->read(metadata, metalength, false) != metalength)
+      {
+         MDFN_Error(0, _("CHD metadata is corrupt."));
+         return false;
+      }
+
+      metadata[metalength] = 0;
+      strcpy(pgtype, "");
+      strcpy(pgsub, "");
+
+      if(metatag == CHD_META_CDROM_TRACK2)
+      {
+         if(sscanf(metadata, "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d PREGAP:%d PGTYPE:%31s PGSUB:%31s POSTGAP:%d",
+                  &tracknum, type, subtype, &frames, &pregap, pgtype, pgsub, &postgap) != 8)
+         {
+            MDFN_Error(0, _("Malformed CHD track metadata: %s"), metadata);
+            return false;
+         }
+      }
+      else
+      {
+         if(sscanf(metadata, "TRACK:%d TYPE:%31s SUBTYPE:%31s FRAMES:%d", &tracknum, type, subtype, &frames) != 4)
+         {
+            MDFN_Error(0, _("Malformed CHD track metadata: %s"), metadata);
+            return false;
+         }
+      }
+
+      // chdman writes the tracks in order.
+      if(tracknum < 1 || tracknum > 99 || (LastTrack && tracknum != (LastTrack + 1)) || frames < 0 || pregap < 0 ||
+            pregap > frames || postgap < 0)
+      {
+         MDFN_Error(0, _("Invalid track in CHD metadata: %s"), metadata);
+         return false;
+      }
+
+      track = &Tracks[tracknum];
+
+      for(unsigned i = 0; i < sizeof(CHD_TrackTypes) / sizeof(CHD_TrackTypes[0]); i++)
+      {
+         if(!strcmp(type, CHD_TrackTypes[i].name))
+         {
+            track->DIFormat = CHD_TrackTypes[i].format;
+            type_found = true;
+            break;
+         }
+      }
+
+      if(!type_found)
+      {
+         MDFN_Error(0, _("Unsupported track format: %s\n"), type);
+         return false;
+      }
+
+      if(!strcmp(subtype, "RW_RAW"))
+         track->SubchannelMode = CDRF_SUBM_RW_RAW;
+      else if(!strcmp(subtype, "RW"))
+      {
+         MDFN_Error(0, _("\"RW\" format subchannel data not supported, only \"RW_RAW\" is!"));
+         return false;
+      }
+
+      if(track->DIFormat == DI_FORMAT_AUDIO)
+         track->subq_control &= ~SUBQ_CTRLF_DATA;
+      else
+         track->subq_control |= SUBQ_CTRLF_DATA;
+
+      switch(track->DIFormat)
+      {
+         case DI_FORMAT_MODE2:
+         case DI_FORMAT_MODE2_FORM1:
+         case DI_FORMAT_MODE2_FORM2:
+         case DI_FORMAT_MODE2_RAW:
+            disc_type = DISC_TYPE_CD_XA;
+            break;
+         default:
+            break;
+      }
+
+      // A pregap whose data is in the image comes as part of the track's frames; otherwise it's silence that isn't,
+      // but the first track's is the 2 seconds of lead-in, which isn't part of the disc as we address it.
+      if(pgtype[0] == 'V')
+      {
+         track->pregap = 0;
+         track->pregap_dv = pregap;
+      }
+      else
+      {
+         track->pregap = (tracknum == 1) ? 0 : pregap;
+         track->pregap_dv = 0;
+      }
+
+      track->postgap = postgap;
+      track->index[0] = -1;
+      track->index[1] = 0;
+
+      RunningLBA += track->pregap;
+      RunningLBA += track->pregap_dv;
+
+      track->LBA = RunningLBA;
+
+      // In CHD frames, rather than bytes.
+      track->FileOffset = chd_frame + track->pregap_dv;
+      track->sectors = frames - track->pregap_dv;
+
+      RunningLBA += track->sectors;
+      RunningLBA += track->postgap;
+
+      chd_frame += (frames + CHD_TRACK_PADDING - 1) / CHD_TRACK_PADDING * CHD_TRACK_PADDING;
+
+      if(tracknum < FirstTrack)
+         FirstTrack = tracknum;
+
+      LastTrack = tracknum;
+   }
+
+   if(FirstTrack > LastTrack)
+   {
+      MDFN_Error(0, _("No tracks found!\n"));
+      return false;
+   }
+
+   if((uint64_t)chd_frame > (uint64_t)HunkMap.size() * frames_per_hunk)
+   {
+      MDFN_Error(0, _("CHD track metadata doesn't match its size."));
+      return false;
+   }
+
+   NumTracks = 1 + LastTrack - FirstTrack;
+   total_sectors = RunningLBA;
+
+   return true;
+}
+
+bool CDAccess_CHD::ImageOpen(const char *path, bool image_memcache)
+{
+   uint8_t header[CHD_V5_HEADER_SIZE];
+   uint32_t unitbytes;
+   uint64_t logicalbytes, mapoffset, metaoffset;
+   uint32_t hunkcount;
+   std::string base_dir, file_base, file_ext;
+   std::string sbi_path;
+   char sbi_ext[4] = { 's', 'b', 'i', 0 };
+
+   MDFN_GetFilePathComponents(path, &base_dir, &file_base, &file_ext);
+
+   if(image_memcache)
+      fp = new MemoryStream(new FileStream(path, MODE_READ));
+   else
+      fp = new FileStream(path, MODE_READ);
+
+   if(fp->read(header, 16, false) != 16 || memcmp(header, "MComprHD", 8))
+   {
+      MDFN_Error(0, _("Invalid CHD header: %s"), path);
+      return false;
+   }
+
+   if(MDFN_de32msb(&header[12]) != 5)
+   {
+      MDFN_Error(0, _("Unsupported CHD version %u; only version 5 is supported."), MDFN_de32msb(&header[12]));
+      return false;
+   }
+
+   if(MDFN_de32msb(&header[8]) != CHD_V5_HEADER_SIZE || fp->read(header + 16, CHD_V5_HEADER_SIZE - 16, false) != (CHD_V5_HEADER_SIZE - 16))
+   {
+      MDFN_Error(0, _("Invalid CHD header: %s"), path);
+      return false;
+   }
+
+   for(unsigned i = 0; i < 4; i++)
+   {
+      compressors[i] = MDFN_de32msb(&header[16 + i * 4]);
+
+      switch(compressors[i])
+      {
+         case 0:
+         case CHD_CODEC_ZLIB:
+         case CHD_CODEC_LZMA:
+         case CHD_CODEC_CD_ZLIB:
+         case CHD_CODEC_CD_LZMA:
+         case CHD_CODEC_CD_FLAC:
+            break;
+
+         default:
+            MDFN_Error(0, _("Unsupported CHD codec \"%c%c%c%c\"."), header[16 + i * 4], header[17 + i * 4],
+                  header[18 + i * 4], header[19 + i * 4]);
+            return false;
+      }
+   }
+
+   logicalbytes = CHD_de64msb(&header[32]);
+   mapoffset = CHD_de64msb(&header[40]);
+   metaoffset = CHD_de64msb(&header[48]);
+   hunkbytes = MDFN_de32msb(&header[56]);
+   unitbytes = MDFN_de32msb(&header[60]);
+
+   // Tracks are whole frames, but a hunk could still start in the middle of one; we don't support that, nor does chdman
+   // make such CHDs.
+   if(unitbytes != CHD_FRAME_SIZE || !hunkbytes || (hunkbytes % CHD_FRAME_SIZE) || hunkbytes > (16 * 1024 * 1024))
+   {
+      MDFN_Error(0, _("Not a CD CHD, or an unsupported hunk size."));
+      return false;
+   }
+
+   if(memcmp(&header[104], "\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0", 20))
+   {
+      MDFN_Error(0, _("CHDs with a parent are not supported."));
+      return false;
+   }
+
+   frames_per_hunk = hunkbytes / CHD_FRAME_SIZE;
+   hunkcount = (logicalbytes + hunkbytes - 1) / hunkbytes;
+
+   if(!hunkcount || hunkcount > (((uint64_t)100 * 60 * 75 + frames_per_hunk - 1) / frames_per_hunk))
+   {
+      MDFN_Error(0, _("Invalid CHD size."));
+      return false;
+   }
+
+   if(!ReadMap(mapoffset, hunkcount, unitbytes))
+      return false;
+
+   if(!ReadMetadata(metaoffset))
+      return false;
+
+   HunkCache = (uint8_t *)malloc((size_t)hunkbytes * HunkCacheCount);
+   CompBuf = (uint8_t *)malloc(hunkbytes);
+   CodecBuf = (uint8_t *)malloc(hunkbytes);
+   ZStream = new z_stream;
+   LZMAProbs = new lzmadec_probs;
+   FLACWork = new flacdec_work;
+
+   if(!HunkCache || !CompBuf || !CodecBuf)
+   {
+      MDFN_Error(0, _("Out of memory."));
+      return false;
+   }
+
+   memset(ZStream, 0, sizeof(*ZStream));
+
+   if(inflateInit2(ZStream, -MAX_WBITS) != Z_OK)
+   {
+      delete ZStream;
+      ZStream = NULL;
+      MDFN_Error(0, _("zlib initialization failed."));
+      return false;
+   }
+
+   for(unsigned i = 0; i < HunkCacheCount; i++)
+   {
+      HunkCacheTag[i] = ~0U;
+      HunkCacheStamp[i] = 0;
+   }
+
+   //
+   // Load SBI file, if present
+   //
+   if(file_ext.length() == 4 && file_ext[0] == '.')
+   {
+      unsigned i;
+      for(i = 0; i < 3; i++)
+      {
+         if(file_ext[1 + i] >= 'A' && file_ext[1 + i] <= 'Z')
+            sbi_ext[i] += 'A' - 'a';
+      }
+   }
+
+   sbi_path = MDFN_EvalFIP(base_dir, file_base + std::string(".") + std::string(sbi_ext), true);
+
+   if (path_is_valid(sbi_path.c_str()))
+      LoadSBI(sbi_path.c_str());
+
+   return true;
+}
+
+int CDAccess_CHD::LoadSBI(const char* sbi_path)
+{
+   /* Loading SBI file */
+   uint8 header[4];
+   uint8 ed[4 + 10];
+   uint8 tmpq[12];
+   FileStream sbis(sbi_path, MODE_READ);
+
+   sbis.read(header, 4);
+
+   if(memcmp(header, "SBI\0", 4))
+      return -1;
+
+   while(sbis.read(ed, sizeof(ed), false) == sizeof(ed))
+   {
+      /* Bad BCD MSF offset in SBI file. */
+      if(!BCD_is_valid(ed[0]) || !BCD_is_valid(ed[1]) || !BCD_is_valid(ed[2]))
+         return -1;
+
+      /* Unrecognized boogly oogly in SBI file */
+      if(ed[3] != 0x01)
+         return -1;
+
+      memcpy(tmpq, &ed[4], 10);
+
+      subq_generate_checksum(tmpq);
+      tmpq[10] ^= 0xFF;
+      tmpq[11] ^= 0xFF;
+
+      uint32 aba = AMSF_to_ABA(BCD_to_U8(ed[0]), BCD_to_U8(ed[1]), BCD_to_U8(ed[2]));
+
+      memcpy(SubQReplaceMap[aba].data, tmpq, 12);
+   }
+
+   return 0;
+}
+
+void CDAccess_CHD::Cleanup(void)
+{
+   if(fp)
+   {
+      fp->close();
+      delete fp;
+      fp = NULL;
+   }
+
+   if(ZStream)
+   {
+      inflateEnd(ZStream);
+      delete ZStream;
+      ZStream = NULL;
+   }
+
+   delete LZMAProbs;
+   LZMAProbs = NULL;
+
+   delete FLACWork;
+   FLACWork = NULL;
+
+   free(HunkCache);
+   HunkCache = NULL;
+
+   free(CompBuf);
+   CompBuf = NULL;
+
+   free(CodecBuf);
+   CodecBuf = NULL;
+}
+
+CDAccess_CHD::CDAccess_CHD(bool *success, const char *path, bool image_memcache) :
+   fp(NULL), hunkbytes(0), frames_per_hunk(0), HunkCache(NULL), HunkCacheClock(0), CompBuf(NULL), CodecBuf(NULL),
+   ZStream(NULL), LZMAProbs(NULL), FLACWork(NULL), NumTracks(0), FirstTrack(0), LastTrack(0), total_sectors(0),
+   disc_type(DISC_TYPE_CDDA_OR_M1)
+{
+   memset(Tracks, 0, sizeof(Tracks));
+
+   if (!ImageOpen(path, image_memcache))
+      *success = false;
+}
+
+CDAccess_CHD::~CDAccess_CHD()
+{
+   Cleanup();
+}
+
+bool CDAccess_CHD::Inflate(const uint8_t *src, uint32_t src_len, uint8_t *dest, uint32_t dest_len)
+{
+   int ret;
+
+   if(inflateReset(ZStream) != Z_OK)
+      return false;
+
+   ZStream->next_in = (Bytef *)src;
+   ZStream->avail_in = src_len;
+   ZStream->next_out = (Bytef *)dest;
+   ZStream->avail_out = dest_len;
+
+   ret = inflate(ZStream, Z_FINISH);
+
+   return (ret == Z_STREAM_END || ret == Z_OK || ret == Z_BUF_ERROR) && !ZStream->avail_out;
+}
+
+// The CD codecs compress the sector data and subcode of a hunk's frames separately(the subcode always with zlib); for
+// cdzl and cdlz, a bitmap of which frames had their sync pattern and ECC dropped comes first.
+bool CDAccess_CHD::DecompressCD(uint32_t codec, const uint8_t *src, uint32_t src_len, uint8_t *dest)
+{
+   const uint32_t frames = frames_per_hunk;
+   const uint32_t ecc_bytes = (frames + 7) / 8;
+   uint8_t *sector_data = CodecBuf;
+   uint8_t *subcode_data = CodecBuf + frames * 2352;
+   bool ecc = false;
+
+   if(codec == CHD_CODEC_CD_FLAC)
+   {
+      int16 *samples = (int16 *)sector_data;
+      long used = flacdec_decode(FLACWork, samples, 2, frames * 588, src, src_len);
+
+      if(used < 0)
+         return false;
+
+      // The sector data is stored as big-endian samples.
+      for(uint32_t i = 0; i < frames * 588 * 2; i++)
+         MDFN_en16msb(sector_data + i * 2, samples[i]);
+
+      if(!Inflate(src + used, src_len - used, subcode_data, frames * 96))
+         return false;
+   }
+   else
+   {
+      const uint32_t complen_bytes = (hunkbytes < 65536) ? 2 : 3;
+      const uint32_t header_bytes = ecc_bytes + complen_bytes;
+      uint32_t complen_base;
+
+      if(src_len < header_bytes)
+         return false;
+
+      complen_base = (src[ecc_bytes + 0] << 8) | src[ecc_bytes + 1];
+
+      if(complen_bytes > 2)
+         complen_base = (complen_base << 8) | src[ecc_bytes + 2];
+
+      if(complen_base > (src_len - header_bytes))
+         return false;
+
+      if(codec == CHD_CODEC_CD_LZMA)
+      {
+         if(lzmadec_decode(LZMAProbs, sector_data, frames * 2352, src + header_bytes, complen_base, 3, 0, 2) != (long)(frames * 2352))
+            return false;
+      }
+      else if(!Inflate(src + header_bytes, complen_base, sector_data, frames * 2352))
+         return false;
+
+      if(!Inflate(src + header_bytes + complen_base, src_len - header_bytes - complen_base, subcode_data, frames * 96))
+         return false;
+
+      ecc = true;
+   }
+
+   for(uint32_t f = 0; f < frames; f++)
+   {
+      memcpy(dest + f * CHD_FRAME_SIZE, sector_data + f * 2352, 2352);
+      memcpy(dest + f * CHD_FRAME_SIZE + 2352, subcode_data + f * 96, 96);
+
+      if(ecc && (src[f >> 3] & (1 << (f & 7))))
+         lec_encode_ecc(dest + f * CHD_FRAME_SIZE);
+   }
+
+   return true;
+}
+
+bool CDAccess_CHD::ReadHunk(uint32_t hunknum, uint8_t *dest)
+{
+   const HunkMapEntry *e = &HunkMap[hunknum];
+   bool ok = false;
+
+   switch(e->type)
+   {
+      case CHD_COMP_TYPE0:
+      case CHD_COMP_TYPE1:
+      case CHD_COMP_TYPE2:
+      case CHD_COMP_TYPE3:
+         {
+            const uint32_t codec = compressors[e->type];
+
+            if(e->length > hunkbytes)
+               return false;
+
+            fp->seek(e->offset, SEEK_SET);
+
+            if(fp->read(CompBuf, e->length, false) != e->length)
+               return false;
+
+            switch(codec)
+            {
+               case CHD_CODEC_ZLIB:
+                  ok = Inflate(CompBuf, e->length, dest, hunkbytes);
+                  break;
+
+               case CHD_CODEC_LZMA:
+                  ok = lzmadec_decode(LZMAProbs, dest, hunkbytes, CompBuf, e->length, 3, 0, 2) == (long)hunkbytes;
+                  break;
+
+               case CHD_CODEC_CD_ZLIB:
+               case CHD_CODEC_CD_LZMA:
+               case CHD_CODEC_CD_FLAC:
+                  ok = DecompressCD(codec, CompBuf, e->length, dest);
+                  break;
+            }
+         }
+         break;
+
+      case CHD_COMP_NONE:
+         fp->seek(e->offset, SEEK_SET);
+         ok = fp->read(dest, hunkbytes, false) == hunkbytes;
+         break;
+
+      case CHD_HUNK_RAW:
+         if(!e->offset)
+         {
+            memset(dest, 0, hunkbytes);
+            return true;
+         }
+
+         fp->seek(e->offset, SEEK_SET);
+         return fp->read(dest, hunkbytes, false) == hunkbytes;
+
+      case CHD_COMP_SELF:
+         // Always an earlier hunk, so this can't go around in circles.
+         if(e->offset >= hunknum)
+            return false;
+
+         return ReadHunk(e->offset, dest);
+
+      default:
+         return false;
+   }
+
+   return ok && CHD_crc16(dest, hunkbytes) == e->crc;
+}
+
+const uint8_t *CDAccess_CHD::GetHunk(uint32_t hunknum)
+{
+   unsigned victim = 0;
+   uint8_t *dest;
+
+   HunkCacheClock++;
+
+   for(unsigned i = 0; i < HunkCacheCount; i++)
+   {
+      if(HunkCacheTag[i] == hunknum)
+      {
+         HunkCacheStamp[i] = HunkCacheClock;
+         return HunkCache + i * hunkbytes;
+      }
+
+      if((uint32_t)(HunkCacheClock - HunkCacheStamp[i]) > (uint32_t)(HunkCacheClock - HunkCacheStamp[victim]))
+         victim = i;
+   }
+
+   if(hunknum >= HunkMap.size())
+      return NULL;
+
+   dest = HunkCache + victim * hunkbytes;
+   HunkCacheTag[victim] = ~0U;
+
+   if(!ReadHunk(hunknum, dest))
+      return NULL;
+
+   HunkCacheTag[victim] = hunknum;
+   HunkCacheStamp[victim] = HunkCacheClock;
+
+   return dest;
+}
+
+bool CDAccess_CHD::Read_Raw_Sector(uint8 *buf, int32 lba)
+{
+   int32_t track;
+   bool TrackFound = false;
+
+   memset(buf + 2352, 0, 96);
+
+   MakeSubPQ(lba, buf + 2352);
+
+   for(track = FirstTrack; track < (FirstTrack + NumTracks); track++)
+   {
+      CDRFILE_TRACK_INFO *ct = &Tracks[track];
+
+      if(lba >= (ct->LBA - ct->pregap_dv - ct->pregap) && lba < (ct->LBA + ct->sectors + ct->postgap))
+      {
+         TrackFound = true;
+
+         // Handle pregap and postgap reading
+         if(lba < (ct->LBA - ct->pregap_dv) || lba >= (ct->LBA + ct->sectors))
+            memset(buf, 0, 2352);	// Null sector data, per spec
+         else
+         {
+            const uint32_t frame = ct->FileOffset + (lba - ct->LBA);
+            const uint8_t *hunk = GetHunk(frame / frames_per_hunk);
+            const uint8_t *src;
+
+            if(!hunk)
+            {
+               memset(buf, 0, 2352);
+               MDFN_Error(0, _("Error decompressing CHD hunk for sector %u!"), lba);
+               return false;
+            }
+
+            src = hunk + (frame % frames_per_hunk) * CHD_FRAME_SIZE;
+
+            switch(ct->DIFormat)
+            {
+               case DI_FORMAT_AUDIO:
+                  // Stored big-endian.
+                  for(unsigned i = 0; i < 2352; i += 2)
+                  {
+                     buf[i + 0] = src[i + 1];
+                     buf[i + 1] = src[i + 0];
+                  }
+                  break;
+
+               case DI_FORMAT_MODE1:
+                  memcpy(buf + 12 + 3 + 1, src, 2048);
+                  encode_mode1_sector(lba + 150, buf);
+                  break;
+
+               case DI_FORMAT_MODE1_RAW:
+               case DI_FORMAT_MODE2_RAW:
+                  memcpy(buf, src, 2352);
+                  break;
+
+               case DI_FORMAT_MODE2:
+                  memcpy(buf + 16, src, 2336);
+                  encode_mode2_sector(lba + 150, buf);
+                  break;
+
+               case DI_FORMAT_MODE2_FORM1:
+                  memcpy(buf + 24, src, 2048);
+                  break;
+
+               case DI_FORMAT_MODE2_FORM2:
+                  memcpy(buf + 24, src, 2324);
+                  break;
+            }
+
+            if(ct->SubchannelMode)
+               memcpy(buf + 2352, src + 2352, 96);
+         }
+         break;
+      }
+   }
+
+   if(!TrackFound)
+   {
+      MDFN_Error(0, _("Could not find track for sector %u!"), lba);
+      return false;
+   }
+
+   return true;
+}
+
+// Note: this function makes use of the current contents(as in |=) in SubPWBuf.
+void CDAccess_CHD::MakeSubPQ(int32 lba, uint8 *SubPWBuf)
+{
+   unsigned i;
+   uint8_t buf[0xC], adr, control;
+   int32_t track;
+   uint32_t lba_relative;
+   uint32_t ma, sa, fa;
+   uint32_t m, s, f;
+   uint8_t pause_or = 0x00;
+   bool track_found = false;
+
+   for(track = FirstTrack; track < (FirstTrack + NumTracks); track++)
+   {
+      if(lba >= (Tracks[track].LBA - Tracks[track].pregap_dv - Tracks[track].pregap)
+            && lba < (Tracks[track].LBA + Tracks[track].sectors + Tracks[track].postgap))
+      {
+         track_found = true;
+         break;
+      }
+   }
+
+   if(!track_found)
+   {
+      printf("MakeSubPQ error for sector %u!", lba);
+      track = FirstTrack;
+   }
+
+   lba_relative = abs((int32)lba - Tracks[track].LBA);
+
+   f            = (lba_relative % 75);
+   s            = ((lba_relative / 75) % 60);
+   m            = (lba_relative / 75 / 60);
+
+   fa           = (lba + 150) % 75;
+   sa           = ((lba + 150) / 75) % 60;
+   ma           = ((lba + 150) / 75 / 60);
+
+   adr          = 0x1; // Q channel data encodes position
+   control      = Tracks[track].subq_control;
+
+   // Handle pause(D7 of interleaved subchannel byte) bit, should be set to 1 when in pregap or postgap.
+   if((lba < Tracks[track].LBA) || (lba >= Tracks[track].LBA + Tracks[track].sectors))
+      pause_or = 0x80;
+
+   // Handle pregap between audio->data track
+   {
+      int32_t pg_offset = (int32)lba - Tracks[track].LBA;
+
+      // If we're more than 2 seconds(150 sectors) from the real "start" of the track/INDEX 01, and the track is a data track,
+      // and the preceding track is an audio track, encode it as audio(by taking the SubQ control field from the preceding track).
+      if(pg_offset < -150)
+      {
+         if((Tracks[track].subq_control & SUBQ_CTRLF_DATA) && (FirstTrack < track) && !(Tracks[track - 1].subq_control & SUBQ_CTRLF_DATA))
+            control = Tracks[track - 1].subq_control;
+      }
+   }
+
+   memset(buf, 0, 0xC);
+   buf[0] = (adr << 0) | (control << 4);
+   buf[1] = U8_to_BCD(track);
+
+   if(lba < Tracks[track].LBA) // Index is 00 in pregap
+      buf[2] = U8_to_BCD(0x00);
+   else
+      buf[2] = U8_to_BCD(0x01);
+
+   /* Track relative MSF address */
+   buf[3] = U8_to_BCD(m);
+   buf[4] = U8_to_BCD(s);
+   buf[5] = U8_to_BCD(f);
+   buf[6] = 0;
+   /* Absolute MSF address */
+   buf[7] = U8_to_BCD(ma);
+   buf[8] = U8_to_BCD(sa);
+   buf[9] = U8_to_BCD(fa);
+
+   subq_generate_checksum(buf);
+
+   if(!SubQReplaceMap.empty())
+   {
+      std::map<uint32, cpp11_array_doodad>::const_iterator it = SubQReplaceMap.find(LBA_to_ABA(lba));
+
+      if(it != SubQReplaceMap.end())
+         memcpy(buf, it->second.data, 12);
+   }
+
+   for (i = 0; i < 96; i++)
+      SubPWBuf[i] |= (((buf[i >> 3] >> (7 - (i & 0x7))) & 1) ? 0x40 : 0x00) | pause_or;
+}
+
+bool CDAccess_CHD::Read_TOC(TOC *toc)
+{
+   unsigned i;
+
+   TOC_Clear(toc);
+
+   toc->first_track = FirstTrack;
+   toc->last_track = FirstTrack + NumTracks - 1;
+   toc->disc_type = disc_type;
+
+   for(i = toc->first_track; i <= toc->last_track; i++)
+   {
+      toc->tracks[i].lba = Tracks[i].LBA;
+      toc->tracks[i].adr = ADR_CURPOS;
+      toc->tracks[i].control = Tracks[i].subq_control;
+   }
+
+   toc->tracks[100].lba = total_sectors;
+   toc->tracks[100].adr = ADR_CURPOS;
+   toc->tracks[100].control = toc->tracks[toc->last_track].control & 0x4;
+
+   // Convenience leadout track duplication.
+   if(toc->last_track < 99)
+      toc->tracks[toc->last_track + 1] = toc->tracks[100];
+
+   return true;
+}
+
+void CDAccess_CHD::Eject(bool eject_status)
+{
+
+}
@@ -0,0 +1,89 @@
+#ifndef __MDFN_CDACCESS_CHD_H
+#define __MDFN_CDACCESS_CHD_H
+
+#include <map>
+#include <vector>
+
+#include "CDAccess_Image.h"
+
+class Stream;
+struct z_stream_s;
+struct lzmadec_probs;
+struct flacdec_work;
+
+class CDAccess_CHD : public CDAccess
+{
+   public:
+
+      CDAccess_CHD(bool *success, const char *path, bool image_memcache);
+      virtual ~CDAccess_CHD();
+
+      virtual bool Read_Raw_Sector(uint8_t *buf, int32_t lba);
+
+      virtual bool Read_TOC(TOC *toc);
+
+      virtual void Eject(bool eject_status);
+
+   private:
+
+      Stream *fp;
+
+      uint32_t compressors[4];
+      uint32_t hunkbytes;
+      uint32_t frames_per_hunk;
+
+      struct HunkMapEntry
+      {
+         uint8_t type;
+         uint32_t length;
+         uint64_t offset;	// Byte offset into the file, or hunk number for the types that refer to another hunk.
+         uint16_t crc;
+      };
+
+      std::vector<HunkMapEntry> HunkMap;
+
+      // Decompressed hunks, least recently used goes first.
+      enum { HunkCacheCount = 32 };
+
+      uint8_t *HunkCache;
+      uint32_t HunkCacheTag[HunkCacheCount];
+      uint32_t HunkCacheStamp[HunkCacheCount];
+      uint32_t HunkCacheClock;
+
+      // Decompression scratch space; only the thread reading sectors(the read-ahead thread with CDIF_MT) touches it.
+      uint8_t *CompBuf;
+      uint8_t *CodecBuf;
+      z_stream_s *ZStream;
+      lzmadec_probs *LZMAProbs;
+      flacdec_work *FLACWork;
+
+      int32_t NumTracks;
+      int32_t FirstTrack;
+      int32_t LastTrack;
+      int32_t total_sectors;
+      uint8_t disc_type;
+      CDRFILE_TRACK_INFO Tracks[100]; // Track #0(HMM?) through 99
+
+      struct cpp11_array_doodad
+      {
+         uint8 data[12];
+      };
+
+      std::map<uint32, cpp11_array_doodad> SubQReplaceMap;
+
+      bool ImageOpen(const char *path, bool image_memcache);
+      bool ReadMap(uint64_t mapoffset, uint32_t hunkcount, uint32_t unitbytes);
+      bool ReadMetadata(uint64_t metaoffset);
+      int LoadSBI(const char* sbi_path);
+      void Cleanup(void);
+
+      const uint8_t *GetHunk(uint32_t hunknum);
+      bool ReadHunk(uint32_t hunknum, uint8_t *dest);
+      bool Inflate(const uint8_t *src, uint32_t src_len, uint8_t *dest, uint32_t dest_len);
+      bool DecompressCD(uint32_t codec, const uint8_t *src, uint32_t src_len, uint8_t *dest);
+
+      // MakeSubPQ will OR the simulated P and Q subchannel data into SubPWBuf.
+      void MakeSubPQ(int32_t lba, uint8_t *SubPWBuf);
+};
+
+#endif
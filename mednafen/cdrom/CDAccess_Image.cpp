@@ -49,7 +49,7 @@
 #include "CDAccess_Image.h"
 #include "CDUtility.h"
 
-#include "audioreader.h"
+#include "CDAFReader.h"
 
 #include "../../libretro.h"
 
@@ -242,17 +242,14 @@ bool CDAccess_Image::ParseTOCFileLineInfo(CDRFILE_TRACK_INFO *track, const int t
 
       efn = MDFN_EvalFIP(base_dir, filename);
 
-      if(image_memcache)
-         track->fp = new MemoryStream(new FileStream(efn.c_str(), MODE_READ));
-      else
-         track->fp = new FileStream(efn.c_str(), MODE_READ);
+      track->fp = cdaccess_open_stream(efn.c_str(), image_memcache);
 
       toc_streamcache[filename] = track->fp;
    }
 
    if(filename.length() >= 4 && !strcasecmp(filename.c_str() + filename.length() - 4, ".wav"))
    {
-      track->AReader = AR_Open(track->fp);
+      track->AReader = CDAFR_Open(track->fp);
 
       if(!track->AReader)
       {
@@ -624,12 +621,9 @@ bool CDAccess_Image::ImageOpen(const char *path, bool image_memcache)
             }
 
             std::string efn = MDFN_EvalFIP(base_dir, args[0]);
-            TmpTrack.fp = new FileStream(efn.c_str(), MODE_READ);
+            TmpTrack.fp = cdaccess_open_stream(efn.c_str(), image_memcache);
             TmpTrack.FirstFileInstance = 1;
 
-            if(image_memcache)
-               TmpTrack.fp = new MemoryStream(TmpTrack.fp);
-
             if(!strcasecmp(args[1].c_str(), "BINARY"))
             {
                //TmpTrack.Format = TRACK_FORMAT_DATA;
@@ -640,7 +634,7 @@ bool CDAccess_Image::ImageOpen(const char *path, bool image_memcache)
             else if(!strcasecmp(args[1].c_str(), "OGG") || !strcasecmp(args[1].c_str(), "VORBIS") || !strcasecmp(args[1].c_str(), "WAVE") || !strcasecmp(args[1].c_str(), "WAV") || !strcasecmp(args[1].c_str(), "PCM")
                   || !strcasecmp(args[1].c_str(), "MPC") || !strcasecmp(args[1].c_str(), "MP+"))
             {
-               TmpTrack.AReader = AR_Open(TmpTrack.fp);
+               TmpTrack.AReader = CDAFR_Open(TmpTrack.fp);
 
                if(!TmpTrack.AReader)
                {
@@ -4,7 +4,7 @@
 #include <map>
 
 class Stream;
-class AudioReader;
+class CDAFReader;
 
 struct CDRFILE_TRACK_INFO
 {
@@ -29,7 +29,7 @@ struct CDRFILE_TRACK_INFO
 
    uint32_t LastSamplePos;
 
-   AudioReader *AReader;
+   CDAFReader *AReader;
 };
 
 class CDAccess_Image : public CDAccess
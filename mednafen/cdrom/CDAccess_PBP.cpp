@@ -17,6 +17,7 @@
 
 #include <boolean.h>
 #include <retro_stat.h>
+#include <retro_miscellaneous.h>
 
 #include "../mednafen.h"
 
@@ -34,7 +35,7 @@
 #include "CDAccess_PBP.h"
 #include "CDUtility.h"
 
-#include "audioreader.h"
+#include "CDAFReader.h"
 
 #include "../../libretro.h"
 
@@ -51,6 +52,8 @@ extern retro_log_printf_t log_cb;
 // very hacky but currently the only way to update the disc start offset class variable from libretro.cpp
 extern int CD_SelectedDisc;
 int PBP_DiscCount;
+// Number of decompressed 16-sector blocks to keep around, set from libretro.cpp.
+unsigned PBP_CacheBlocks = 32;
 
 // Disk-image(rip) track/sector formats
 enum
@@ -217,6 +220,8 @@ void CDAccess_PBP::Cleanup(void)
    }
    if(index_table != NULL)
       free(index_table);
+   if(BlockCache != NULL)
+      delete[] BlockCache;
 }
 
 CDAccess_PBP::CDAccess_PBP(const char *path, bool image_memcache) : NumTracks(0), FirstTrack(0), LastTrack(0), total_sectors(0)
@@ -224,6 +229,12 @@ CDAccess_PBP::CDAccess_PBP(const char *path, bool image_memcache) : NumTracks(0)
    is_official = false;
    index_table = NULL;
    fp = NULL;
+
+   BlockCacheCount = MAX(PBP_CacheBlocks, 4U);
+   BlockCache = new BlockCacheEntry[BlockCacheCount];
+   ReadAheadBlocks = BlockCacheCount / 4;
+   InvalidateBlockCache();
+
    kirk_init();
    if (!ImageOpen(path, image_memcache))
    {
@@ -370,86 +381,166 @@ int CDAccess_PBP::decompress2(void *out, uint32_t *out_size, void *in, uint32_t
    return ret == 1 ? 0 : ret;
 }
 
+// Reads and decompresses one block of 16 sectors into "dest".
+bool CDAccess_PBP::ReadBlock(uint32_t block, uint8_t *dest)
+{
+   uint32_t start_byte = index_table[block];
+   uint32_t size = index_table[block+1] - start_byte;
+   bool is_compressed = true;
+
+   if (size > sizeof(buff_compressed))
+   {
+      log_cb(RETRO_LOG_ERROR, "[PBP] block %u is too large (%u)\n", block, size);
+      return false;
+   }
+   else if(size == sizeof(buff_compressed))
+      is_compressed = false;  // should be the case here?
+
+   fp->seek(start_byte, SEEK_SET);
+   fp->read(is_compressed ? buff_compressed : dest, size);
+
+//log_cb(RETRO_LOG_DEBUG, "block = %u, start_byte = %#x, index_table[%i] = %#x\n", block, start_byte, block, index_table[block]);
+
+   if (is_compressed)
+   {
+      if(is_official)
+         decompress(dest, buff_compressed, sizeof(buff_compressed));
+      else
+      {
+         uint32_t cdbuffer_size_expect = 2352 << 4;
+         uint32_t cdbuffer_size = cdbuffer_size_expect;
+         int ret = decompress2(dest, &cdbuffer_size, buff_compressed, size);
+         if (ret != 0)
+         {
+            log_cb(RETRO_LOG_ERROR, "[PBP] uncompress failed with %d for block %u (%u)\n", ret, block, size);
+            return false;
+         }
+         if (cdbuffer_size != cdbuffer_size_expect)
+         {
+            log_cb(RETRO_LOG_WARN, "[PBP] cdbuffer_size: %lu != %lu, block %u\n", cdbuffer_size, cdbuffer_size_expect, block);
+            return false;
+         }
+      }
+   }
+
+   return true;
+}
+
+CDAccess_PBP::BlockCacheEntry *CDAccess_PBP::GetBlock(uint32_t block)
+{
+   unsigned victim = 0;
+   BlockCacheEntry *ent;
+
+   BlockCacheClock++;
+
+   for(unsigned i = 0; i < BlockCacheCount; i++)
+   {
+      if(BlockCache[i].block == block)
+      {
+         BlockCache[i].stamp = BlockCacheClock;
+         return &BlockCache[i];
+      }
+
+      if((uint32_t)(BlockCacheClock - BlockCache[i].stamp) > (uint32_t)(BlockCacheClock - BlockCache[victim].stamp))
+         victim = i;
+   }
+
+   ent = &BlockCache[victim];
+   ent->block = ~0U;
+
+   if(!ReadBlock(block, ent->data[0]))
+      return NULL;
+
+   ent->block = block;
+   ent->stamp = BlockCacheClock;
+   ent->fixed_sectors = 0;
+
+   return ent;
+}
+
+void CDAccess_PBP::InvalidateBlockCache(void)
+{
+   for(unsigned i = 0; i < BlockCacheCount; i++)
+   {
+      BlockCache[i].block = ~0U;
+      BlockCache[i].stamp = 0;
+   }
+
+   BlockCacheClock = 0;
+   last_block = ~0U;
+   ra_block = ra_end = 0;
+}
+
 bool CDAccess_PBP::Read_Raw_Sector(uint8 *buf, int32 lba)
 {
    uint8_t SimuQ[0xC];
 
-   int32_t block = lba >> 4;
-   sector_in_blk = lba & 0xf;
+   uint32_t block = lba >> 4;
+   uint32_t sector_in_blk = lba & 0xf;
+   BlockCacheEntry *ent;
 
    memset(buf + 2352, 0, 96);
    MakeSubPQ(lba, buf + 2352);
    subq_deinterleave(buf + 2352, SimuQ);
 
-   if (block != current_block)
+   if (lba < 0 || block >= index_len)
    {
-      uint32_t start_byte = index_table[block];
-      uint32_t size = index_table[block+1] - start_byte;
-      bool is_compressed = true;
+      log_cb(RETRO_LOG_ERROR, "[PBP] sector %d is past img end\n", lba);
+      return false;
+   }
 
-      if (lba >= index_len * 16)
-      {
-         log_cb(RETRO_LOG_ERROR, "[PBP] sector %d is past img end\n", lba);
-         return false;
-      }
+   ent = GetBlock(block);
 
-      if (size > sizeof(buff_compressed))
+   if (!ent)
+   {
+      log_cb(RETRO_LOG_ERROR, "[PBP] failed to read block %u for sector %d\n", block, lba);
+      return false;
+   }
+
+   // Reading on from the previous block(streaming FMV, XA audio...) widens the read-ahead window, anything else
+   // starts it over at just the next block.
+   if (block != last_block)
+   {
+      if (block == last_block + 1)
+         ra_end = MIN(block + 1 + ReadAheadBlocks, index_len);
+      else
       {
-         log_cb(RETRO_LOG_ERROR, "[PBP] %u: block %d is too large (%u)\n", lba, block, size);
-         return false;
+         ra_block = block + 1;
+         ra_end = MIN(block + 2, index_len);
       }
-      else if(size == sizeof(buff_compressed))
-         is_compressed = false;  // should be the case here?
-
-      fp->seek(start_byte, SEEK_SET);
-      fp->read(is_compressed ? buff_compressed : buff_raw[0], size);
 
-//log_cb(RETRO_LOG_DEBUG, "lba = %d, block = %u, start_byte = %#x, index_table[%i] = %#x\n", lba, block, start_byte, block, index_table[block]);
+      if (ra_block <= block)
+         ra_block = block + 1;
 
-      if (is_compressed)
-      {
-         if(is_official)
-         {
-            decompress(buff_raw[0], buff_compressed, sizeof(buff_compressed));
-            fixed_sectors = 0;
-         }
-         else
-         {
-            uint32_t cdbuffer_size_expect = sizeof(buff_raw[0]) << 4;
-            uint32_t cdbuffer_size = cdbuffer_size_expect;
-            int ret = decompress2(buff_raw[0], &cdbuffer_size, buff_compressed, size);
-            if (ret != 0)
-            {
-               log_cb(RETRO_LOG_ERROR, "[PBP] uncompress failed with %d for block %d, sector %d (%u)\n", ret, block, lba, size);
-               return false;
-            }
-            if (cdbuffer_size != cdbuffer_size_expect)
-            {
-               log_cb(RETRO_LOG_WARN, "[PBP] cdbuffer_size: %lu != %lu, sector %d\n", cdbuffer_size, cdbuffer_size_expect, lba);
-               return false;
-            }
-         }
-      }
-      current_block = block;
+      last_block = block;
    }
 
    if(is_official)
    {
       // this will probably rarely get caught but better than trying to do it every time I guess...
-      if(!(fixed_sectors & (0x1 << sector_in_blk)))
+      if(!(ent->fixed_sectors & (0x1 << sector_in_blk)))
       {
-         if(fix_sector(buff_raw[sector_in_blk], lba) != 0)
+         if(fix_sector(ent->data[sector_in_blk], lba) != 0)
             log_cb(RETRO_LOG_WARN, "[PBP] Failed to fix sector %d\n", lba);
          else
-            fixed_sectors |= (0x1 << sector_in_blk);
+            ent->fixed_sectors |= (0x1 << sector_in_blk);
       }
    }
 
-   memcpy(buf, buff_raw[sector_in_blk], 2352);
+   memcpy(buf, ent->data[sector_in_blk], 2352);
 
    return true;
 }
 
+// Decompresses the next block in the read-ahead window, unless it's cached already.
+bool CDAccess_PBP::Prefetch(void)
+{
+   if (ra_block < ra_end && !GetBlock(ra_block++))
+      ra_block = ra_end;
+
+   return ra_block < ra_end;
+}
+
 bool CDAccess_PBP::Read_TOC(TOC *toc)
 {
    struct {
@@ -599,8 +690,7 @@ bool CDAccess_PBP::Read_TOC(TOC *toc)
    read_offset = index_table_offset;
 
    // set class variables
-   fixed_sectors = 0;
-   current_block = (uint32_t)-1;
+   InvalidateBlockCache();
    index_len = 0xAFC80 / sizeof(index_entry);   // disc map table has a fixed size of 0xAFC80 (22500 entries)?
 
    if(index_table != NULL)
@@ -625,8 +715,11 @@ bool CDAccess_PBP::Read_TOC(TOC *toc)
          break;
 
       index_table[i] = cdimg_base + index_entry.offset;
+      index_table[i+1] = index_table[i] + index_entry.size;
    }
-   index_table[i] = cdimg_base + index_entry.offset + index_entry.size;
+
+   // Blocks past the last entry don't exist, whatever the table size.
+   index_len = i;
 
    toc->tracks[100].lba = total_sectors;
    toc->tracks[100].adr = ADR_CURPOS;
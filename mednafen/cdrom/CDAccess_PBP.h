@@ -21,6 +21,8 @@ class CDAccess_PBP : public CDAccess
 
       virtual void Eject(bool eject_status);
 
+      virtual bool Prefetch(void);
+
    private:
       Stream* fp;
 
@@ -39,12 +41,28 @@ class CDAccess_PBP : public CDAccess
       uint32_t pbp_file_offsets[PBP_NUM_FILES];
 
       ////////////////
-      uint8_t buff_raw[16][2352];
       uint8_t buff_compressed[2352 * 16];
       uint32_t *index_table;
       uint32_t index_len;
-      uint32_t current_block;
-      uint32_t sector_in_blk;
+
+      // Decompressed blocks of 16 sectors, least recently used goes first.
+      struct BlockCacheEntry
+      {
+         uint32_t block;
+         uint32_t stamp;
+         uint16_t fixed_sectors;
+         uint8_t data[16][2352];
+      };
+
+      BlockCacheEntry *BlockCache;
+      unsigned BlockCacheCount;
+      uint32_t BlockCacheClock;
+
+      // Blocks from ra_block up to(but not including) ra_end are decompressed ahead of time by Prefetch().
+      unsigned ReadAheadBlocks;
+      uint32_t last_block;
+      uint32_t ra_block;
+      uint32_t ra_end;
       ////////////////
 
       int32_t NumTracks;
@@ -57,13 +75,16 @@ class CDAccess_PBP : public CDAccess
       uint32_t discs_start_offset[5];
       uint32_t psisoimg_offset;
 
-      uint16_t fixed_sectors;
       bool is_official;    // TODO: find more consistent ways to check for used compression algorithm, compressed (and/or encrypted?) audio tracks and messed up sectors
 
       bool ImageOpen(const char *path, bool image_memcache);
       int LoadSBI(const char* sbi_path);
       void Cleanup(void);
 
+      BlockCacheEntry *GetBlock(uint32_t block);
+      bool ReadBlock(uint32_t block, uint8_t *dest);
+      void InvalidateBlockCache(void);
+
       CDRFILE_TRACK_INFO Tracks[100]; // Track #0(HMM?) through 99
       struct cpp11_array_doodad
       {
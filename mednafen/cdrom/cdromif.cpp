@@ -42,6 +42,7 @@ enum
    // Command messages.
    CDIF_MSG_DIEDIEDIE,
    CDIF_MSG_READ_SECTOR,
+   CDIF_MSG_HINT_READ,
    CDIF_MSG_EJECT
 };
 
@@ -117,7 +118,7 @@ class CDIF_MT : public CDIF
       CDIF_Queue EmuThreadQueue;
 
 
-      enum { SBSize = 256 };
+      enum { SBSize = 512 };
       CDIF_Sector_Buffer SectorBuffers[SBSize];
 
       uint32 SBWritePos;
@@ -131,8 +132,21 @@ class CDIF_MT : public CDIF
       bool RT_EjectDisc(bool eject_status, bool skip_actual_eject = false);
 
       uint32 ra_lba;
-      int ra_count;
+      uint32 ra_end;
       uint32 last_read_lba;
+      bool prefetch_pending;
+
+      // Where the current run of sequential reads started, and a running average of how long those runs go on for,
+      // in sectors; it sizes the read-ahead.  Only actual reads count towards these, not hints.
+      uint32 run_start;
+      uint32 run_avg;
+
+      // Where the read-ahead from ra_lba started; a hint can move it off the current run.
+      uint32 ra_start;
+
+      bool RT_Covered(uint32 lba) const;
+      void RT_Request(uint32 lba);
+      void RT_Hint(uint32 lba);
 };
 
 /* TODO: prohibit copy constructor */
@@ -258,6 +272,11 @@ bool CDIF_MT::RT_EjectDisc(bool eject_status, bool skip_actual_eject)
       if(!skip_actual_eject)
          disc_cdaccess->Eject(eject_status);
 
+      // The verify results belong to whatever disc was in before(a multi-disc image switches discs behind the same
+      // CDAccess).
+      VerifiedMap.clear();
+      RepairedSectors.clear();
+
       if(!eject_status)	// Re-read the TOC
       {
          disc_cdaccess->Read_TOC(&disc_toc);
@@ -269,10 +288,16 @@ bool CDIF_MT::RT_EjectDisc(bool eject_status, bool skip_actual_eject)
          }
       }
 
+      // The emulation thread is waiting on us here, so the disc is ours while the new one is checked.
+      if(!eject_status && CD_VerifyOnLoad)
+         VerifyDisc(disc_cdaccess);
+
       SBWritePos = 0;
       ra_lba = 0;
-      ra_count = 0;
+      ra_end = 0;
       last_read_lba = ~0U;
+      run_start = ~0U;
+      ra_start = ~0U;
       memset(SectorBuffers, 0, SBSize * sizeof(CDIF_Sector_Buffer));
    }
 
@@ -298,8 +323,12 @@ int CDIF_MT::ReadThreadStart()
    DiscEjected = true;
    SBWritePos = 0;
    ra_lba = 0;
-   ra_count = 0;
+   ra_end = 0;
    last_read_lba = ~0U;
+   prefetch_pending = false;
+   run_start = ~0U;
+   run_avg = 1;
+   ra_start = ~0U;
 
    RT_EjectDisc(false, true);
 
@@ -310,8 +339,8 @@ int CDIF_MT::ReadThreadStart()
       CDIF_Message msg;
 
       // Only do a blocking-wait for a message if we don't have any sectors to read-ahead.
-      // MDFN_DispMessage("%d %d %d\n", last_read_lba, ra_lba, ra_count);
-      if(ReadThreadQueue.Read(&msg, ra_count ? false : true))
+      // MDFN_DispMessage("%d %d %d\n", last_read_lba, ra_lba, ra_end);
+      if(ReadThreadQueue.Read(&msg, (ra_lba < ra_end || prefetch_pending) ? false : true))
       {
          switch(msg.message)
          {
@@ -325,48 +354,26 @@ int CDIF_MT::ReadThreadStart()
                break;
 
             case CDIF_MSG_READ_SECTOR:
-               {
-                  static const int       max_ra = 16;
-                  static const int   initial_ra = 1;
-                  static const int speedmult_ra = 2;
-                  uint32_t              new_lba = msg.args[0];
-
-                  assert((unsigned int)max_ra < (SBSize / 4));
-
-                  if(last_read_lba != ~0U && new_lba == (last_read_lba + 1))
-                  {
-                     int how_far_ahead = ra_lba - new_lba;
-
-                     if(how_far_ahead <= max_ra)
-                        ra_count = MIN(speedmult_ra, 1 + max_ra - how_far_ahead);
-                     else
-                        ra_count++;
-                  }
-                  else if(new_lba != last_read_lba)
-                  {
-                     ra_lba = new_lba;
-                     ra_count = initial_ra;
-                  }
-
-                  last_read_lba = new_lba;
-               }
+               RT_Request(msg.args[0]);
+               break;
+
+            case CDIF_MSG_HINT_READ:
+               RT_Hint(msg.args[0]);
                break;
          }
       }
 
       // Don't read >= the "end" of the disc, silly snake.  Slither.
-      if(ra_count && ra_lba == disc_toc.tracks[100].lba)
-      {
-         ra_count = 0;
-         //printf("Ephemeral scarabs: %d!\n", ra_lba);
-      }
+      if(ra_end > disc_toc.tracks[100].lba)
+         ra_end = disc_toc.tracks[100].lba;
 
-      if(ra_count)
+      if(ra_lba < ra_end)
       {
          uint8_t tmpbuf[2352 + 96];
          bool error_condition = false;
 
          disc_cdaccess->Read_Raw_Sector(tmpbuf, ra_lba);
+         PatchRepairedSector(tmpbuf, ra_lba);
 
          slock_lock((slock_t*)SBMutex);
 
@@ -380,13 +387,92 @@ int CDIF_MT::ReadThreadStart()
          slock_unlock((slock_t*)SBMutex);
 
          ra_lba++;
-         ra_count--;
+         prefetch_pending = true;
       }
+      else if(prefetch_pending)
+         prefetch_pending = disc_cdaccess->Prefetch();
    }
 
    return(1);
 }
 
+// Read thread: whether "lba" has been read ahead since the read-ahead last started over(and so is still in
+// SectorBuffers), or is the next sector it'll read.
+bool CDIF_MT::RT_Covered(uint32 lba) const
+{
+   return ra_start != ~0U && lba >= ra_start && lba <= ra_lba && (ra_lba - lba) < (SBSize / 2);
+}
+
+// Read thread: the emulated drive has asked for "lba".  Reading on from there extends the read-ahead window, anything
+// else is a seek and starts it over.  The window is sized from how long runs of sequential reads have gone on for, so
+// streaming gets read well ahead while scattered reads don't pull in sectors that'll be thrown away.
+void CDIF_MT::RT_Request(uint32 lba)
+{
+   static const uint32 min_ra = 16;
+   static const uint32 max_ra = SBSize / 4;
+   const bool covered = RT_Covered(lba);
+   uint32 expect;
+
+   if(lba == last_read_lba)
+      return;
+
+   if((covered && ra_start == run_start) || (last_read_lba != ~0U && lba == (last_read_lba + 1)))
+   {
+      expect = MAX(run_avg, lba + 1 - run_start);
+      expect = MIN(MAX(expect, min_ra), max_ra);
+
+      // A hint for somewhere else moved the read-ahead off this run, and it didn't pan out.
+      if(!covered)
+      {
+         ra_start = run_start;
+         ra_lba = lba;
+         ra_end = lba;
+      }
+
+      ra_end = MAX(ra_end, lba + 1 + expect);
+   }
+   else
+   {
+      if(run_start != ~0U && last_read_lba != ~0U && last_read_lba >= run_start)
+      {
+         const uint32 run_len = MIN(last_read_lba + 1 - run_start, max_ra * 4);
+
+         run_avg = (run_avg * 3 + run_len + 3) / 4;
+      }
+
+      expect = MIN(MAX(run_avg, 1), max_ra);
+
+      run_start = lba;
+      ra_start = lba;
+
+      // What a hint for here has already read ahead is kept.
+      if(covered)
+         ra_end = MAX(ra_end, lba + expect);
+      else
+      {
+         ra_lba = lba;
+         ra_end = lba + expect;
+      }
+   }
+
+   last_read_lba = lba;
+}
+
+// Read thread: the emulated drive is about to ask for "lba"(HintReadSector() from the CDC's Setloc, seek and read
+// commands, ahead of the seek completing), so start reading ahead from there.  It might not, so the sequential-run
+// bookkeeping is left for RT_Request() to do once it does.
+void CDIF_MT::RT_Hint(uint32 lba)
+{
+   static const uint32 max_ra = SBSize / 4;
+
+   if(RT_Covered(lba))
+      return;
+
+   ra_start = lba;
+   ra_lba = lba;
+   ra_end = lba + MIN(MAX(run_avg, 1), max_ra);
+}
+
 CDIF_MT::CDIF_MT(CDAccess *cda) : disc_cdaccess(cda), CDReadThread(NULL), SBMutex(NULL), SBCond(NULL)
 {
    CDIF_Message msg;
@@ -438,6 +524,273 @@ bool CDIF::ValidateRawSector(uint8 *buf)
    return(true);
 }
 
+bool CD_VerifyOnLoad = false;
+
+enum
+{
+   VERIFY_SKIPPED = 0,	// Not a mode 1 or mode 2 form 1 sector; the CDC doesn't check those either.
+   VERIFY_GOOD,
+   VERIFY_REPAIRED,
+   VERIFY_BAD
+};
+
+// Threads for CDIF::VerifyDisc(), which hand out the sectors of a batch between them a few at a time.
+class CDIF_Verifier
+{
+   public:
+
+      CDIF_Verifier();
+      ~CDIF_Verifier();
+
+      // Checks(and corrects, where it can) the "count" sectors at "data", 2352 + 96 bytes apart, leaving VERIFY_*
+      // codes in "status".  Returns before that's done; Wait() for it.
+      void Start(uint8 *data, uint8 *status, uint32 count);
+      void Wait(void);
+
+   private:
+
+      enum { NumThreads = 4 };
+      enum { SectorsPerClaim = 16 };
+
+      sthread_t *threads[NumThreads];
+      slock_t *mutex;
+      scond_t *cond;
+
+      uint8 *batch_data;
+      uint8 *batch_status;
+      uint32 batch_count;
+      uint32 batch_next;
+      unsigned busy;
+      bool quit;
+
+      static uint8 CheckSector(uint8 *buf);
+      static void ThreadStart(void *data);
+      void Thread(void);
+};
+
+CDIF_Verifier::CDIF_Verifier() : batch_data(NULL), batch_status(NULL), batch_count(0), batch_next(0), busy(0), quit(false)
+{
+   // The L-EC tables get built on first use, which has to happen here before there are several threads about.
+   CDUtility_Init();
+
+   mutex = slock_new();
+   cond = scond_new();
+
+   for(unsigned i = 0; i < NumThreads; i++)
+      threads[i] = sthread_create(ThreadStart, this);
+}
+
+CDIF_Verifier::~CDIF_Verifier()
+{
+   slock_lock(mutex);
+   quit = true;
+   scond_broadcast(cond);
+   slock_unlock(mutex);
+
+   for(unsigned i = 0; i < NumThreads; i++)
+      sthread_join(threads[i]);
+
+   scond_free(cond);
+   slock_free(mutex);
+}
+
+uint8 CDIF_Verifier::CheckSector(uint8 *buf)
+{
+   static const uint8 sync[12] = { 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 };
+   const uint8 mode = buf[12 + 3];
+   uint8 header[4];
+   bool xa = false;
+
+   if(memcmp(buf, sync, sizeof(sync)))
+      return(VERIFY_SKIPPED);
+
+   if(mode == 0x2)
+   {
+      if(buf[12 + 6] & 0x20)
+         return(VERIFY_SKIPPED);
+
+      xa = true;
+   }
+   else if(mode != 0x1)
+      return(VERIFY_SKIPPED);
+
+   if(edc_check(buf, xa))
+      return(VERIFY_GOOD);
+
+   // Mode 2 P/Q parity doesn't cover the header, so L-EC leaves it zeroed; it's what was read that the CDC wants.
+   memcpy(header, buf + 12, sizeof(header));
+
+   if(edc_lec_check_and_correct(buf, xa))
+   {
+      memcpy(buf + 12, header, sizeof(header));
+      return(VERIFY_REPAIRED);
+   }
+
+   return(VERIFY_BAD);
+}
+
+void CDIF_Verifier::ThreadStart(void *data)
+{
+   ((CDIF_Verifier *)data)->Thread();
+}
+
+void CDIF_Verifier::Thread(void)
+{
+   slock_lock(mutex);
+
+   while(!quit)
+   {
+      uint32 start, end;
+
+      if(batch_next >= batch_count)
+      {
+         scond_wait(cond, mutex);
+         continue;
+      }
+
+      start = batch_next;
+      end = MIN(start + SectorsPerClaim, batch_count);
+      batch_next = end;
+      busy++;
+      slock_unlock(mutex);
+
+      for(uint32 i = start; i < end; i++)
+         batch_status[i] = CheckSector(batch_data + i * (2352 + 96));
+
+      slock_lock(mutex);
+      busy--;
+
+      if(batch_next >= batch_count && !busy)
+         scond_broadcast(cond);
+   }
+
+   slock_unlock(mutex);
+}
+
+void CDIF_Verifier::Start(uint8 *data, uint8 *status, uint32 count)
+{
+   slock_lock(mutex);
+   batch_data = data;
+   batch_status = status;
+   batch_count = count;
+   batch_next = 0;
+   scond_broadcast(cond);
+   slock_unlock(mutex);
+}
+
+void CDIF_Verifier::Wait(void)
+{
+   slock_lock(mutex);
+
+   while(batch_next < batch_count || busy)
+      scond_wait(cond, mutex);
+
+   slock_unlock(mutex);
+}
+
+// Reading goes on here, in LBA order(which is what the backends are fastest at), a batch ahead of the checking.
+void CDIF::VerifyDisc(CDAccess *cda)
+{
+   enum { BatchSectors = 256 };
+   const uint32 leadout = disc_toc.tracks[100].lba;
+   CDIF_Verifier verifier;
+   uint8 *data[2];
+   uint32 *lbas[2];
+   uint32 count[2];
+   uint8 status[BatchSectors];
+   uint32 num_checked = 0, num_repaired = 0, num_bad = 0;
+   bool pending = false;
+   int track = disc_toc.first_track;
+   uint32 lba = disc_toc.tracks[track].lba;
+
+   VerifiedMap.assign((leadout + 7) / 8, 0);
+   RepairedSectors.clear();
+
+   for(unsigned b = 0; b < 2; b++)
+   {
+      data[b] = new uint8[BatchSectors * (2352 + 96)];
+      lbas[b] = new uint32[BatchSectors];
+   }
+
+   for(unsigned b = 0; ; b ^= 1)
+   {
+      count[b] = 0;
+
+      while(count[b] < BatchSectors && track <= disc_toc.last_track)
+      {
+         const uint32 track_end = (track < disc_toc.last_track) ? disc_toc.tracks[track + 1].lba : leadout;
+
+         if(!(disc_toc.tracks[track].control & SUBQ_CTRLF_DATA) || lba >= track_end)
+         {
+            if(++track <= disc_toc.last_track)
+               lba = disc_toc.tracks[track].lba;
+            continue;
+         }
+
+         cda->Read_Raw_Sector(data[b] + count[b] * (2352 + 96), lba);
+         lbas[b][count[b]++] = lba++;
+      }
+
+      // Collect the batch read last time around while this one was being read.
+      if(pending)
+      {
+         const unsigned pb = b ^ 1;
+
+         verifier.Wait();
+
+         for(uint32 i = 0; i < count[pb]; i++)
+         {
+            const uint32 plba = lbas[pb][i];
+
+            switch(status[i])
+            {
+               case VERIFY_REPAIRED:
+                  memcpy(RepairedSectors[plba].data, data[pb] + i * (2352 + 96), 2352);
+                  num_repaired++;
+                  // fall through
+               case VERIFY_GOOD:
+                  VerifiedMap[plba >> 3] |= 1 << (plba & 7);
+                  break;
+
+               case VERIFY_BAD:
+                  num_bad++;
+                  break;
+            }
+         }
+
+         num_checked += count[pb];
+         pending = false;
+      }
+
+      if(!count[b])
+         break;
+
+      verifier.Start(data[b], status, count[b]);
+      pending = true;
+   }
+
+   for(unsigned b = 0; b < 2; b++)
+   {
+      delete[] data[b];
+      delete[] lbas[b];
+   }
+
+   log_cb(RETRO_LOG_INFO, "[CDIF] Verified %u data track sectors: %u repaired, %u unrecoverable.\n", num_checked, num_repaired, num_bad);
+}
+
+void CDIF::PatchRepairedSector(uint8 *buf, uint32 lba)
+{
+   std::map<uint32, RepairedSector>::const_iterator it;
+
+   if(RepairedSectors.empty())
+      return;
+
+   it = RepairedSectors.find(lba);
+
+   if(it != RepairedSectors.end())
+      memcpy(buf, it->second.data, 2352);
+}
+
 bool CDIF_MT::ReadRawSector(uint8 *buf, uint32 lba)
 {
    bool found = false;
@@ -514,7 +867,7 @@ void CDIF_MT::HintReadSector(uint32 lba)
    if(UnrecoverableError)
       return;
 
-   ReadThreadQueue.Write(CDIF_Message(CDIF_MSG_READ_SECTOR, lba));
+   ReadThreadQueue.Write(CDIF_Message(CDIF_MSG_HINT_READ, lba));
 }
 
 int CDIF::ReadSector(uint8* pBuf, uint32 lba, uint32 nSectors)
@@ -589,6 +942,9 @@ CDIF_ST::CDIF_ST(CDAccess *cda) : disc_cdaccess(cda)
 
    if(disc_toc.first_track < 1 || disc_toc.last_track > 99 || disc_toc.first_track > disc_toc.last_track)
       throw(MDFN_Error(0, _("TOC first(%d)/last(%d) track numbers bad."), disc_toc.first_track, disc_toc.last_track));
+
+   if(CD_VerifyOnLoad)
+      VerifyDisc(disc_cdaccess);
 }
 
 CDIF_ST::~CDIF_ST()
@@ -614,6 +970,7 @@ bool CDIF_ST::ReadRawSector(uint8 *buf, uint32 lba)
    }
 
    disc_cdaccess->Read_Raw_Sector(buf, lba);
+   PatchRepairedSector(buf, lba);
 
    return(true);
 }
@@ -657,6 +1014,10 @@ bool CDIF_ST::Eject(bool eject_status)
    {
       disc_cdaccess->Eject(eject_status);
 
+      // Same as CDIF_MT::RT_EjectDisc(); don't carry the last disc's verify results over to this one.
+      VerifiedMap.clear();
+      RepairedSectors.clear();
+
       if(!eject_status)     // Re-read the TOC
       {
          disc_cdaccess->Read_TOC(&disc_toc);
@@ -667,6 +1028,9 @@ bool CDIF_ST::Eject(bool eject_status)
             return false;
          }
       }
+
+      if(!eject_status && CD_VerifyOnLoad)
+         VerifyDisc(disc_cdaccess);
    }
 
    return(true);
@@ -21,10 +21,17 @@
 #include "CDUtility.h"
 #include "../Stream.h"
 
+#include <map>
 #include <queue>
+#include <vector>
 
 typedef TOC CD_TOC;
 
+class CDAccess;
+
+// Check every data sector of a disc when it's opened or changed(see CDIF::VerifyDisc()).
+extern bool CD_VerifyOnLoad;
+
 class CDIF
 {
    public:
@@ -44,6 +51,13 @@ class CDIF
       // Call for mode 1 or mode 2 form 1 only.
       bool ValidateRawSector(uint8_t *buf);
 
+      // True if the sector at "lba" passed its EDC check when the disc was opened, or was repaired then(in which case
+      // ReadRawSector() returns the repaired data); ValidateRawSector() on it would be wasted work.
+      inline bool IsSectorVerified(uint32_t lba) const
+      {
+         return (lba >> 3) < VerifiedMap.size() && ((VerifiedMap[lba >> 3] >> (lba & 7)) & 1);
+      }
+
       // Utility/Wrapped functions
       // Reads mode 1 and mode2 form 1 sectors(2048 bytes per sector returned)
       // Will return the type(1, 2) of the first sector read to the buffer supplied, 0 on error
@@ -61,6 +75,21 @@ class CDIF
       bool UnrecoverableError;
       TOC disc_toc;
       bool DiscEjected;
+
+      // Reads through all the data tracks, checking EDCs and L-EC correcting what it can on a few threads; fills in
+      // VerifiedMap and RepairedSectors.  disc_toc must be loaded, and nothing else may be using "cda" meanwhile.
+      void VerifyDisc(CDAccess *cda);
+      void PatchRepairedSector(uint8_t *buf, uint32_t lba);
+
+      // One bit per LBA.
+      std::vector<uint8_t> VerifiedMap;
+
+      struct RepairedSector
+      {
+         uint8_t data[2352];
+      };
+
+      std::map<uint32_t, RepairedSector> RepairedSectors;
 };
 
 CDIF *CDIF_Open(bool *success, const char *path, const bool is_device, bool image_memcache);
@@ -115,6 +115,540 @@ unsigned long  edctable[256] =
  0x71C0FC00L, 0xE151FD01L, 0xE0E1FE01L, 0x7070FF00L
 };
 
+/* edctable[] extended for slice-by-8: edctable_slice[k][n] is the CRC of byte n followed by k zero bytes. */
+
+static const uint32_t edctable_slice[8][256] =
+{
+ {
+  0x00000000U, 0x90910101U, 0x91210201U, 0x01B00300U,
+  0x92410401U, 0x02D00500U, 0x03600600U, 0x93F10701U,
+  0x94810801U, 0x04100900U, 0x05A00A00U, 0x95310B01U,
+  0x06C00C00U, 0x96510D01U, 0x97E10E01U, 0x07700F00U,
+  0x99011001U, 0x09901100U, 0x08201200U, 0x98B11301U,
+  0x0B401400U, 0x9BD11501U, 0x9A611601U, 0x0AF01700U,
+  0x0D801800U, 0x9D111901U, 0x9CA11A01U, 0x0C301B00U,
+  0x9FC11C01U, 0x0F501D00U, 0x0EE01E00U, 0x9E711F01U,
+  0x82012001U, 0x12902100U, 0x13202200U, 0x83B12301U,
+  0x10402400U, 0x80D12501U, 0x81612601U, 0x11F02700U,
+  0x16802800U, 0x86112901U, 0x87A12A01U, 0x17302B00U,
+  0x84C12C01U, 0x14502D00U, 0x15E02E00U, 0x85712F01U,
+  0x1B003000U, 0x8B913101U, 0x8A213201U, 0x1AB03300U,
+  0x89413401U, 0x19D03500U, 0x18603600U, 0x88F13701U,
+  0x8F813801U, 0x1F103900U, 0x1EA03A00U, 0x8E313B01U,
+  0x1DC03C00U, 0x8D513D01U, 0x8CE13E01U, 0x1C703F00U,
+  0xB4014001U, 0x24904100U, 0x25204200U, 0xB5B14301U,
+  0x26404400U, 0xB6D14501U, 0xB7614601U, 0x27F04700U,
+  0x20804800U, 0xB0114901U, 0xB1A14A01U, 0x21304B00U,
+  0xB2C14C01U, 0x22504D00U, 0x23E04E00U, 0xB3714F01U,
+  0x2D005000U, 0xBD915101U, 0xBC215201U, 0x2CB05300U,
+  0xBF415401U, 0x2FD05500U, 0x2E605600U, 0xBEF15701U,
+  0xB9815801U, 0x29105900U, 0x28A05A00U, 0xB8315B01U,
+  0x2BC05C00U, 0xBB515D01U, 0xBAE15E01U, 0x2A705F00U,
+  0x36006000U, 0xA6916101U, 0xA7216201U, 0x37B06300U,
+  0xA4416401U, 0x34D06500U, 0x35606600U, 0xA5F16701U,
+  0xA2816801U, 0x32106900U, 0x33A06A00U, 0xA3316B01U,
+  0x30C06C00U, 0xA0516D01U, 0xA1E16E01U, 0x31706F00U,
+  0xAF017001U, 0x3F907100U, 0x3E207200U, 0xAEB17301U,
+  0x3D407400U, 0xADD17501U, 0xAC617601U, 0x3CF07700U,
+  0x3B807800U, 0xAB117901U, 0xAAA17A01U, 0x3A307B00U,
+  0xA9C17C01U, 0x39507D00U, 0x38E07E00U, 0xA8717F01U,
+  0xD8018001U, 0x48908100U, 0x49208200U, 0xD9B18301U,
+  0x4A408400U, 0xDAD18501U, 0xDB618601U, 0x4BF08700U,
+  0x4C808800U, 0xDC118901U, 0xDDA18A01U, 0x4D308B00U,
+  0xDEC18C01U, 0x4E508D00U, 0x4FE08E00U, 0xDF718F01U,
+  0x41009000U, 0xD1919101U, 0xD0219201U, 0x40B09300U,
+  0xD3419401U, 0x43D09500U, 0x42609600U, 0xD2F19701U,
+  0xD5819801U, 0x45109900U, 0x44A09A00U, 0xD4319B01U,
+  0x47C09C00U, 0xD7519D01U, 0xD6E19E01U, 0x46709F00U,
+  0x5A00A000U, 0xCA91A101U, 0xCB21A201U, 0x5BB0A300U,
+  0xC841A401U, 0x58D0A500U, 0x5960A600U, 0xC9F1A701U,
+  0xCE81A801U, 0x5E10A900U, 0x5FA0AA00U, 0xCF31AB01U,
+  0x5CC0AC00U, 0xCC51AD01U, 0xCDE1AE01U, 0x5D70AF00U,
+  0xC301B001U, 0x5390B100U, 0x5220B200U, 0xC2B1B301U,
+  0x5140B400U, 0xC1D1B501U, 0xC061B601U, 0x50F0B700U,
+  0x5780B800U, 0xC711B901U, 0xC6A1BA01U, 0x5630BB00U,
+  0xC5C1BC01U, 0x5550BD00U, 0x54E0BE00U, 0xC471BF01U,
+  0x6C00C000U, 0xFC91C101U, 0xFD21C201U, 0x6DB0C300U,
+  0xFE41C401U, 0x6ED0C500U, 0x6F60C600U, 0xFFF1C701U,
+  0xF881C801U, 0x6810C900U, 0x69A0CA00U, 0xF931CB01U,
+  0x6AC0CC00U, 0xFA51CD01U, 0xFBE1CE01U, 0x6B70CF00U,
+  0xF501D001U, 0x6590D100U, 0x6420D200U, 0xF4B1D301U,
+  0x6740D400U, 0xF7D1D501U, 0xF661D601U, 0x66F0D700U,
+  0x6180D800U, 0xF111D901U, 0xF0A1DA01U, 0x6030DB00U,
+  0xF3C1DC01U, 0x6350DD00U, 0x62E0DE00U, 0xF271DF01U,
+  0xEE01E001U, 0x7E90E100U, 0x7F20E200U, 0xEFB1E301U,
+  0x7C40E400U, 0xECD1E501U, 0xED61E601U, 0x7DF0E700U,
+  0x7A80E800U, 0xEA11E901U, 0xEBA1EA01U, 0x7B30EB00U,
+  0xE8C1EC01U, 0x7850ED00U, 0x79E0EE00U, 0xE971EF01U,
+  0x7700F000U, 0xE791F101U, 0xE621F201U, 0x76B0F300U,
+  0xE541F401U, 0x75D0F500U, 0x7460F600U, 0xE4F1F701U,
+  0xE381F801U, 0x7310F900U, 0x72A0FA00U, 0xE231FB01U,
+  0x71C0FC00U, 0xE151FD01U, 0xE0E1FE01U, 0x7070FF00U
+ },
+ {
+  0x00000000U, 0x90019000U, 0x90002003U, 0x0001B003U,
+  0x90034005U, 0x0002D005U, 0x00036006U, 0x9002F006U,
+  0x90058009U, 0x00041009U, 0x0005A00AU, 0x9004300AU,
+  0x0006C00CU, 0x9007500CU, 0x9006E00FU, 0x0007700FU,
+  0x90080011U, 0x00099011U, 0x00082012U, 0x9009B012U,
+  0x000B4014U, 0x900AD014U, 0x900B6017U, 0x000AF017U,
+  0x000D8018U, 0x900C1018U, 0x900DA01BU, 0x000C301BU,
+  0x900EC01DU, 0x000F501DU, 0x000EE01EU, 0x900F701EU,
+  0x90130021U, 0x00129021U, 0x00132022U, 0x9012B022U,
+  0x00104024U, 0x9011D024U, 0x90106027U, 0x0011F027U,
+  0x00168028U, 0x90171028U, 0x9016A02BU, 0x0017302BU,
+  0x9015C02DU, 0x0014502DU, 0x0015E02EU, 0x9014702EU,
+  0x001B0030U, 0x901A9030U, 0x901B2033U, 0x001AB033U,
+  0x90184035U, 0x0019D035U, 0x00186036U, 0x9019F036U,
+  0x901E8039U, 0x001F1039U, 0x001EA03AU, 0x901F303AU,
+  0x001DC03CU, 0x901C503CU, 0x901DE03FU, 0x001C703FU,
+  0x90250041U, 0x00249041U, 0x00252042U, 0x9024B042U,
+  0x00264044U, 0x9027D044U, 0x90266047U, 0x0027F047U,
+  0x00208048U, 0x90211048U, 0x9020A04BU, 0x0021304BU,
+  0x9023C04DU, 0x0022504DU, 0x0023E04EU, 0x9022704EU,
+  0x002D0050U, 0x902C9050U, 0x902D2053U, 0x002CB053U,
+  0x902E4055U, 0x002FD055U, 0x002E6056U, 0x902FF056U,
+  0x90288059U, 0x00291059U, 0x0028A05AU, 0x9029305AU,
+  0x002BC05CU, 0x902A505CU, 0x902BE05FU, 0x002A705FU,
+  0x00360060U, 0x90379060U, 0x90362063U, 0x0037B063U,
+  0x90354065U, 0x0034D065U, 0x00356066U, 0x9034F066U,
+  0x90338069U, 0x00321069U, 0x0033A06AU, 0x9032306AU,
+  0x0030C06CU, 0x9031506CU, 0x9030E06FU, 0x0031706FU,
+  0x903E0071U, 0x003F9071U, 0x003E2072U, 0x903FB072U,
+  0x003D4074U, 0x903CD074U, 0x903D6077U, 0x003CF077U,
+  0x003B8078U, 0x903A1078U, 0x903BA07BU, 0x003A307BU,
+  0x9038C07DU, 0x0039507DU, 0x0038E07EU, 0x9039707EU,
+  0x90490081U, 0x00489081U, 0x00492082U, 0x9048B082U,
+  0x004A4084U, 0x904BD084U, 0x904A6087U, 0x004BF087U,
+  0x004C8088U, 0x904D1088U, 0x904CA08BU, 0x004D308BU,
+  0x904FC08DU, 0x004E508DU, 0x004FE08EU, 0x904E708EU,
+  0x00410090U, 0x90409090U, 0x90412093U, 0x0040B093U,
+  0x90424095U, 0x0043D095U, 0x00426096U, 0x9043F096U,
+  0x90448099U, 0x00451099U, 0x0044A09AU, 0x9045309AU,
+  0x0047C09CU, 0x9046509CU, 0x9047E09FU, 0x0046709FU,
+  0x005A00A0U, 0x905B90A0U, 0x905A20A3U, 0x005BB0A3U,
+  0x905940A5U, 0x0058D0A5U, 0x005960A6U, 0x9058F0A6U,
+  0x905F80A9U, 0x005E10A9U, 0x005FA0AAU, 0x905E30AAU,
+  0x005CC0ACU, 0x905D50ACU, 0x905CE0AFU, 0x005D70AFU,
+  0x905200B1U, 0x005390B1U, 0x005220B2U, 0x9053B0B2U,
+  0x005140B4U, 0x9050D0B4U, 0x905160B7U, 0x0050F0B7U,
+  0x005780B8U, 0x905610B8U, 0x9057A0BBU, 0x005630BBU,
+  0x9054C0BDU, 0x005550BDU, 0x0054E0BEU, 0x905570BEU,
+  0x006C00C0U, 0x906D90C0U, 0x906C20C3U, 0x006DB0C3U,
+  0x906F40C5U, 0x006ED0C5U, 0x006F60C6U, 0x906EF0C6U,
+  0x906980C9U, 0x006810C9U, 0x0069A0CAU, 0x906830CAU,
+  0x006AC0CCU, 0x906B50CCU, 0x906AE0CFU, 0x006B70CFU,
+  0x906400D1U, 0x006590D1U, 0x006420D2U, 0x9065B0D2U,
+  0x006740D4U, 0x9066D0D4U, 0x906760D7U, 0x0066F0D7U,
+  0x006180D8U, 0x906010D8U, 0x9061A0DBU, 0x006030DBU,
+  0x9062C0DDU, 0x006350DDU, 0x0062E0DEU, 0x906370DEU,
+  0x907F00E1U, 0x007E90E1U, 0x007F20E2U, 0x907EB0E2U,
+  0x007C40E4U, 0x907DD0E4U, 0x907C60E7U, 0x007DF0E7U,
+  0x007A80E8U, 0x907B10E8U, 0x907AA0EBU, 0x007B30EBU,
+  0x9079C0EDU, 0x007850EDU, 0x0079E0EEU, 0x907870EEU,
+  0x007700F0U, 0x907690F0U, 0x907720F3U, 0x0076B0F3U,
+  0x907440F5U, 0x0075D0F5U, 0x007460F6U, 0x9075F0F6U,
+  0x907280F9U, 0x007310F9U, 0x0072A0FAU, 0x907330FAU,
+  0x0071C0FCU, 0x907050FCU, 0x9071E0FFU, 0x007070FFU
+ },
+ {
+  0x00000000U, 0x00900190U, 0x01200320U, 0x01B002B0U,
+  0x02400640U, 0x02D007D0U, 0x03600560U, 0x03F004F0U,
+  0x04800C80U, 0x04100D10U, 0x05A00FA0U, 0x05300E30U,
+  0x06C00AC0U, 0x06500B50U, 0x07E009E0U, 0x07700870U,
+  0x09001900U, 0x09901890U, 0x08201A20U, 0x08B01BB0U,
+  0x0B401F40U, 0x0BD01ED0U, 0x0A601C60U, 0x0AF01DF0U,
+  0x0D801580U, 0x0D101410U, 0x0CA016A0U, 0x0C301730U,
+  0x0FC013C0U, 0x0F501250U, 0x0EE010E0U, 0x0E701170U,
+  0x12003200U, 0x12903390U, 0x13203120U, 0x13B030B0U,
+  0x10403440U, 0x10D035D0U, 0x11603760U, 0x11F036F0U,
+  0x16803E80U, 0x16103F10U, 0x17A03DA0U, 0x17303C30U,
+  0x14C038C0U, 0x14503950U, 0x15E03BE0U, 0x15703A70U,
+  0x1B002B00U, 0x1B902A90U, 0x1A202820U, 0x1AB029B0U,
+  0x19402D40U, 0x19D02CD0U, 0x18602E60U, 0x18F02FF0U,
+  0x1F802780U, 0x1F102610U, 0x1EA024A0U, 0x1E302530U,
+  0x1DC021C0U, 0x1D502050U, 0x1CE022E0U, 0x1C702370U,
+  0x24006400U, 0x24906590U, 0x25206720U, 0x25B066B0U,
+  0x26406240U, 0x26D063D0U, 0x27606160U, 0x27F060F0U,
+  0x20806880U, 0x20106910U, 0x21A06BA0U, 0x21306A30U,
+  0x22C06EC0U, 0x22506F50U, 0x23E06DE0U, 0x23706C70U,
+  0x2D007D00U, 0x2D907C90U, 0x2C207E20U, 0x2CB07FB0U,
+  0x2F407B40U, 0x2FD07AD0U, 0x2E607860U, 0x2EF079F0U,
+  0x29807180U, 0x29107010U, 0x28A072A0U, 0x28307330U,
+  0x2BC077C0U, 0x2B507650U, 0x2AE074E0U, 0x2A707570U,
+  0x36005600U, 0x36905790U, 0x37205520U, 0x37B054B0U,
+  0x34405040U, 0x34D051D0U, 0x35605360U, 0x35F052F0U,
+  0x32805A80U, 0x32105B10U, 0x33A059A0U, 0x33305830U,
+  0x30C05CC0U, 0x30505D50U, 0x31E05FE0U, 0x31705E70U,
+  0x3F004F00U, 0x3F904E90U, 0x3E204C20U, 0x3EB04DB0U,
+  0x3D404940U, 0x3DD048D0U, 0x3C604A60U, 0x3CF04BF0U,
+  0x3B804380U, 0x3B104210U, 0x3AA040A0U, 0x3A304130U,
+  0x39C045C0U, 0x39504450U, 0x38E046E0U, 0x38704770U,
+  0x4800C800U, 0x4890C990U, 0x4920CB20U, 0x49B0CAB0U,
+  0x4A40CE40U, 0x4AD0CFD0U, 0x4B60CD60U, 0x4BF0CCF0U,
+  0x4C80C480U, 0x4C10C510U, 0x4DA0C7A0U, 0x4D30C630U,
+  0x4EC0C2C0U, 0x4E50C350U, 0x4FE0C1E0U, 0x4F70C070U,
+  0x4100D100U, 0x4190D090U, 0x4020D220U, 0x40B0D3B0U,
+  0x4340D740U, 0x43D0D6D0U, 0x4260D460U, 0x42F0D5F0U,
+  0x4580DD80U, 0x4510DC10U, 0x44A0DEA0U, 0x4430DF30U,
+  0x47C0DBC0U, 0x4750DA50U, 0x46E0D8E0U, 0x4670D970U,
+  0x5A00FA00U, 0x5A90FB90U, 0x5B20F920U, 0x5BB0F8B0U,
+  0x5840FC40U, 0x58D0FDD0U, 0x5960FF60U, 0x59F0FEF0U,
+  0x5E80F680U, 0x5E10F710U, 0x5FA0F5A0U, 0x5F30F430U,
+  0x5CC0F0C0U, 0x5C50F150U, 0x5DE0F3E0U, 0x5D70F270U,
+  0x5300E300U, 0x5390E290U, 0x5220E020U, 0x52B0E1B0U,
+  0x5140E540U, 0x51D0E4D0U, 0x5060E660U, 0x50F0E7F0U,
+  0x5780EF80U, 0x5710EE10U, 0x56A0ECA0U, 0x5630ED30U,
+  0x55C0E9C0U, 0x5550E850U, 0x54E0EAE0U, 0x5470EB70U,
+  0x6C00AC00U, 0x6C90AD90U, 0x6D20AF20U, 0x6DB0AEB0U,
+  0x6E40AA40U, 0x6ED0ABD0U, 0x6F60A960U, 0x6FF0A8F0U,
+  0x6880A080U, 0x6810A110U, 0x69A0A3A0U, 0x6930A230U,
+  0x6AC0A6C0U, 0x6A50A750U, 0x6BE0A5E0U, 0x6B70A470U,
+  0x6500B500U, 0x6590B490U, 0x6420B620U, 0x64B0B7B0U,
+  0x6740B340U, 0x67D0B2D0U, 0x6660B060U, 0x66F0B1F0U,
+  0x6180B980U, 0x6110B810U, 0x60A0BAA0U, 0x6030BB30U,
+  0x63C0BFC0U, 0x6350BE50U, 0x62E0BCE0U, 0x6270BD70U,
+  0x7E009E00U, 0x7E909F90U, 0x7F209D20U, 0x7FB09CB0U,
+  0x7C409840U, 0x7CD099D0U, 0x7D609B60U, 0x7DF09AF0U,
+  0x7A809280U, 0x7A109310U, 0x7BA091A0U, 0x7B309030U,
+  0x78C094C0U, 0x78509550U, 0x79E097E0U, 0x79709670U,
+  0x77008700U, 0x77908690U, 0x76208420U, 0x76B085B0U,
+  0x75408140U, 0x75D080D0U, 0x74608260U, 0x74F083F0U,
+  0x73808B80U, 0x73108A10U, 0x72A088A0U, 0x72308930U,
+  0x71C08DC0U, 0x71508C50U, 0x70E08EE0U, 0x70708F70U
+ },
+ {
+  0x00000000U, 0x41000001U, 0x82000002U, 0xC3000003U,
+  0xB4030007U, 0xF5030006U, 0x36030005U, 0x77030004U,
+  0xD805000DU, 0x9905000CU, 0x5A05000FU, 0x1B05000EU,
+  0x6C06000AU, 0x2D06000BU, 0xEE060008U, 0xAF060009U,
+  0x00090019U, 0x41090018U, 0x8209001BU, 0xC309001AU,
+  0xB40A001EU, 0xF50A001FU, 0x360A001CU, 0x770A001DU,
+  0xD80C0014U, 0x990C0015U, 0x5A0C0016U, 0x1B0C0017U,
+  0x6C0F0013U, 0x2D0F0012U, 0xEE0F0011U, 0xAF0F0010U,
+  0x00120032U, 0x41120033U, 0x82120030U, 0xC3120031U,
+  0xB4110035U, 0xF5110034U, 0x36110037U, 0x77110036U,
+  0xD817003FU, 0x9917003EU, 0x5A17003DU, 0x1B17003CU,
+  0x6C140038U, 0x2D140039U, 0xEE14003AU, 0xAF14003BU,
+  0x001B002BU, 0x411B002AU, 0x821B0029U, 0xC31B0028U,
+  0xB418002CU, 0xF518002DU, 0x3618002EU, 0x7718002FU,
+  0xD81E0026U, 0x991E0027U, 0x5A1E0024U, 0x1B1E0025U,
+  0x6C1D0021U, 0x2D1D0020U, 0xEE1D0023U, 0xAF1D0022U,
+  0x00240064U, 0x41240065U, 0x82240066U, 0xC3240067U,
+  0xB4270063U, 0xF5270062U, 0x36270061U, 0x77270060U,
+  0xD8210069U, 0x99210068U, 0x5A21006BU, 0x1B21006AU,
+  0x6C22006EU, 0x2D22006FU, 0xEE22006CU, 0xAF22006DU,
+  0x002D007DU, 0x412D007CU, 0x822D007FU, 0xC32D007EU,
+  0xB42E007AU, 0xF52E007BU, 0x362E0078U, 0x772E0079U,
+  0xD8280070U, 0x99280071U, 0x5A280072U, 0x1B280073U,
+  0x6C2B0077U, 0x2D2B0076U, 0xEE2B0075U, 0xAF2B0074U,
+  0x00360056U, 0x41360057U, 0x82360054U, 0xC3360055U,
+  0xB4350051U, 0xF5350050U, 0x36350053U, 0x77350052U,
+  0xD833005BU, 0x9933005AU, 0x5A330059U, 0x1B330058U,
+  0x6C30005CU, 0x2D30005DU, 0xEE30005EU, 0xAF30005FU,
+  0x003F004FU, 0x413F004EU, 0x823F004DU, 0xC33F004CU,
+  0xB43C0048U, 0xF53C0049U, 0x363C004AU, 0x773C004BU,
+  0xD83A0042U, 0x993A0043U, 0x5A3A0040U, 0x1B3A0041U,
+  0x6C390045U, 0x2D390044U, 0xEE390047U, 0xAF390046U,
+  0x004800C8U, 0x414800C9U, 0x824800CAU, 0xC34800CBU,
+  0xB44B00CFU, 0xF54B00CEU, 0x364B00CDU, 0x774B00CCU,
+  0xD84D00C5U, 0x994D00C4U, 0x5A4D00C7U, 0x1B4D00C6U,
+  0x6C4E00C2U, 0x2D4E00C3U, 0xEE4E00C0U, 0xAF4E00C1U,
+  0x004100D1U, 0x414100D0U, 0x824100D3U, 0xC34100D2U,
+  0xB44200D6U, 0xF54200D7U, 0x364200D4U, 0x774200D5U,
+  0xD84400DCU, 0x994400DDU, 0x5A4400DEU, 0x1B4400DFU,
+  0x6C4700DBU, 0x2D4700DAU, 0xEE4700D9U, 0xAF4700D8U,
+  0x005A00FAU, 0x415A00FBU, 0x825A00F8U, 0xC35A00F9U,
+  0xB45900FDU, 0xF55900FCU, 0x365900FFU, 0x775900FEU,
+  0xD85F00F7U, 0x995F00F6U, 0x5A5F00F5U, 0x1B5F00F4U,
+  0x6C5C00F0U, 0x2D5C00F1U, 0xEE5C00F2U, 0xAF5C00F3U,
+  0x005300E3U, 0x415300E2U, 0x825300E1U, 0xC35300E0U,
+  0xB45000E4U, 0xF55000E5U, 0x365000E6U, 0x775000E7U,
+  0xD85600EEU, 0x995600EFU, 0x5A5600ECU, 0x1B5600EDU,
+  0x6C5500E9U, 0x2D5500E8U, 0xEE5500EBU, 0xAF5500EAU,
+  0x006C00ACU, 0x416C00ADU, 0x826C00AEU, 0xC36C00AFU,
+  0xB46F00ABU, 0xF56F00AAU, 0x366F00A9U, 0x776F00A8U,
+  0xD86900A1U, 0x996900A0U, 0x5A6900A3U, 0x1B6900A2U,
+  0x6C6A00A6U, 0x2D6A00A7U, 0xEE6A00A4U, 0xAF6A00A5U,
+  0x006500B5U, 0x416500B4U, 0x826500B7U, 0xC36500B6U,
+  0xB46600B2U, 0xF56600B3U, 0x366600B0U, 0x776600B1U,
+  0xD86000B8U, 0x996000B9U, 0x5A6000BAU, 0x1B6000BBU,
+  0x6C6300BFU, 0x2D6300BEU, 0xEE6300BDU, 0xAF6300BCU,
+  0x007E009EU, 0x417E009FU, 0x827E009CU, 0xC37E009DU,
+  0xB47D0099U, 0xF57D0098U, 0x367D009BU, 0x777D009AU,
+  0xD87B0093U, 0x997B0092U, 0x5A7B0091U, 0x1B7B0090U,
+  0x6C780094U, 0x2D780095U, 0xEE780096U, 0xAF780097U,
+  0x00770087U, 0x41770086U, 0x82770085U, 0xC3770084U,
+  0xB4740080U, 0xF5740081U, 0x36740082U, 0x77740083U,
+  0xD872008AU, 0x9972008BU, 0x5A720088U, 0x1B720089U,
+  0x6C71008DU, 0x2D71008CU, 0xEE71008FU, 0xAF71008EU
+ },
+ {
+  0x00000000U, 0x90D00101U, 0x91A30201U, 0x01730300U,
+  0x93450401U, 0x03950500U, 0x02E60600U, 0x92360701U,
+  0x96890801U, 0x06590900U, 0x072A0A00U, 0x97FA0B01U,
+  0x05CC0C00U, 0x951C0D01U, 0x946F0E01U, 0x04BF0F00U,
+  0x9D111001U, 0x0DC11100U, 0x0CB21200U, 0x9C621301U,
+  0x0E541400U, 0x9E841501U, 0x9FF71601U, 0x0F271700U,
+  0x0B981800U, 0x9B481901U, 0x9A3B1A01U, 0x0AEB1B00U,
+  0x98DD1C01U, 0x080D1D00U, 0x097E1E00U, 0x99AE1F01U,
+  0x8A212001U, 0x1AF12100U, 0x1B822200U, 0x8B522301U,
+  0x19642400U, 0x89B42501U, 0x88C72601U, 0x18172700U,
+  0x1CA82800U, 0x8C782901U, 0x8D0B2A01U, 0x1DDB2B00U,
+  0x8FED2C01U, 0x1F3D2D00U, 0x1E4E2E00U, 0x8E9E2F01U,
+  0x17303000U, 0x87E03101U, 0x86933201U, 0x16433300U,
+  0x84753401U, 0x14A53500U, 0x15D63600U, 0x85063701U,
+  0x81B93801U, 0x11693900U, 0x101A3A00U, 0x80CA3B01U,
+  0x12FC3C00U, 0x822C3D01U, 0x835F3E01U, 0x138F3F00U,
+  0xA4414001U, 0x34914100U, 0x35E24200U, 0xA5324301U,
+  0x37044400U, 0xA7D44501U, 0xA6A74601U, 0x36774700U,
+  0x32C84800U, 0xA2184901U, 0xA36B4A01U, 0x33BB4B00U,
+  0xA18D4C01U, 0x315D4D00U, 0x302E4E00U, 0xA0FE4F01U,
+  0x39505000U, 0xA9805101U, 0xA8F35201U, 0x38235300U,
+  0xAA155401U, 0x3AC55500U, 0x3BB65600U, 0xAB665701U,
+  0xAFD95801U, 0x3F095900U, 0x3E7A5A00U, 0xAEAA5B01U,
+  0x3C9C5C00U, 0xAC4C5D01U, 0xAD3F5E01U, 0x3DEF5F00U,
+  0x2E606000U, 0xBEB06101U, 0xBFC36201U, 0x2F136300U,
+  0xBD256401U, 0x2DF56500U, 0x2C866600U, 0xBC566701U,
+  0xB8E96801U, 0x28396900U, 0x294A6A00U, 0xB99A6B01U,
+  0x2BAC6C00U, 0xBB7C6D01U, 0xBA0F6E01U, 0x2ADF6F00U,
+  0xB3717001U, 0x23A17100U, 0x22D27200U, 0xB2027301U,
+  0x20347400U, 0xB0E47501U, 0xB1977601U, 0x21477700U,
+  0x25F87800U, 0xB5287901U, 0xB45B7A01U, 0x248B7B00U,
+  0xB6BD7C01U, 0x266D7D00U, 0x271E7E00U, 0xB7CE7F01U,
+  0xF8818001U, 0x68518100U, 0x69228200U, 0xF9F28301U,
+  0x6BC48400U, 0xFB148501U, 0xFA678601U, 0x6AB78700U,
+  0x6E088800U, 0xFED88901U, 0xFFAB8A01U, 0x6F7B8B00U,
+  0xFD4D8C01U, 0x6D9D8D00U, 0x6CEE8E00U, 0xFC3E8F01U,
+  0x65909000U, 0xF5409101U, 0xF4339201U, 0x64E39300U,
+  0xF6D59401U, 0x66059500U, 0x67769600U, 0xF7A69701U,
+  0xF3199801U, 0x63C99900U, 0x62BA9A00U, 0xF26A9B01U,
+  0x605C9C00U, 0xF08C9D01U, 0xF1FF9E01U, 0x612F9F00U,
+  0x72A0A000U, 0xE270A101U, 0xE303A201U, 0x73D3A300U,
+  0xE1E5A401U, 0x7135A500U, 0x7046A600U, 0xE096A701U,
+  0xE429A801U, 0x74F9A900U, 0x758AAA00U, 0xE55AAB01U,
+  0x776CAC00U, 0xE7BCAD01U, 0xE6CFAE01U, 0x761FAF00U,
+  0xEFB1B001U, 0x7F61B100U, 0x7E12B200U, 0xEEC2B301U,
+  0x7CF4B400U, 0xEC24B501U, 0xED57B601U, 0x7D87B700U,
+  0x7938B800U, 0xE9E8B901U, 0xE89BBA01U, 0x784BBB00U,
+  0xEA7DBC01U, 0x7AADBD00U, 0x7BDEBE00U, 0xEB0EBF01U,
+  0x5CC0C000U, 0xCC10C101U, 0xCD63C201U, 0x5DB3C300U,
+  0xCF85C401U, 0x5F55C500U, 0x5E26C600U, 0xCEF6C701U,
+  0xCA49C801U, 0x5A99C900U, 0x5BEACA00U, 0xCB3ACB01U,
+  0x590CCC00U, 0xC9DCCD01U, 0xC8AFCE01U, 0x587FCF00U,
+  0xC1D1D001U, 0x5101D100U, 0x5072D200U, 0xC0A2D301U,
+  0x5294D400U, 0xC244D501U, 0xC337D601U, 0x53E7D700U,
+  0x5758D800U, 0xC788D901U, 0xC6FBDA01U, 0x562BDB00U,
+  0xC41DDC01U, 0x54CDDD00U, 0x55BEDE00U, 0xC56EDF01U,
+  0xD6E1E001U, 0x4631E100U, 0x4742E200U, 0xD792E301U,
+  0x45A4E400U, 0xD574E501U, 0xD407E601U, 0x44D7E700U,
+  0x4068E800U, 0xD0B8E901U, 0xD1CBEA01U, 0x411BEB00U,
+  0xD32DEC01U, 0x43FDED00U, 0x428EEE00U, 0xD25EEF01U,
+  0x4BF0F000U, 0xDB20F101U, 0xDA53F201U, 0x4A83F300U,
+  0xD8B5F401U, 0x4865F500U, 0x4916F600U, 0xD9C6F701U,
+  0xDD79F801U, 0x4DA9F900U, 0x4CDAFA00U, 0xDC0AFB01U,
+  0x4E3CFC00U, 0xDEECFD01U, 0xDF9FFE01U, 0x4F4FFF00U
+ },
+ {
+  0x00000000U, 0x9001D100U, 0x9000A203U, 0x00017303U,
+  0x90024405U, 0x00039505U, 0x0002E606U, 0x90033706U,
+  0x90078809U, 0x00065909U, 0x00072A0AU, 0x9006FB0AU,
+  0x0005CC0CU, 0x90041D0CU, 0x90056E0FU, 0x0004BF0FU,
+  0x900C1011U, 0x000DC111U, 0x000CB212U, 0x900D6312U,
+  0x000E5414U, 0x900F8514U, 0x900EF617U, 0x000F2717U,
+  0x000B9818U, 0x900A4918U, 0x900B3A1BU, 0x000AEB1BU,
+  0x9009DC1DU, 0x00080D1DU, 0x00097E1EU, 0x9008AF1EU,
+  0x901B2021U, 0x001AF121U, 0x001B8222U, 0x901A5322U,
+  0x00196424U, 0x9018B524U, 0x9019C627U, 0x00181727U,
+  0x001CA828U, 0x901D7928U, 0x901C0A2BU, 0x001DDB2BU,
+  0x901EEC2DU, 0x001F3D2DU, 0x001E4E2EU, 0x901F9F2EU,
+  0x00173030U, 0x9016E130U, 0x90179233U, 0x00164333U,
+  0x90157435U, 0x0014A535U, 0x0015D636U, 0x90140736U,
+  0x9010B839U, 0x00116939U, 0x00101A3AU, 0x9011CB3AU,
+  0x0012FC3CU, 0x90132D3CU, 0x90125E3FU, 0x00138F3FU,
+  0x90354041U, 0x00349141U, 0x0035E242U, 0x90343342U,
+  0x00370444U, 0x9036D544U, 0x9037A647U, 0x00367747U,
+  0x0032C848U, 0x90331948U, 0x90326A4BU, 0x0033BB4BU,
+  0x90308C4DU, 0x00315D4DU, 0x00302E4EU, 0x9031FF4EU,
+  0x00395050U, 0x90388150U, 0x9039F253U, 0x00382353U,
+  0x903B1455U, 0x003AC555U, 0x003BB656U, 0x903A6756U,
+  0x903ED859U, 0x003F0959U, 0x003E7A5AU, 0x903FAB5AU,
+  0x003C9C5CU, 0x903D4D5CU, 0x903C3E5FU, 0x003DEF5FU,
+  0x002E6060U, 0x902FB160U, 0x902EC263U, 0x002F1363U,
+  0x902C2465U, 0x002DF565U, 0x002C8666U, 0x902D5766U,
+  0x9029E869U, 0x00283969U, 0x00294A6AU, 0x90289B6AU,
+  0x002BAC6CU, 0x902A7D6CU, 0x902B0E6FU, 0x002ADF6FU,
+  0x90227071U, 0x0023A171U, 0x0022D272U, 0x90230372U,
+  0x00203474U, 0x9021E574U, 0x90209677U, 0x00214777U,
+  0x0025F878U, 0x90242978U, 0x90255A7BU, 0x00248B7BU,
+  0x9027BC7DU, 0x00266D7DU, 0x00271E7EU, 0x9026CF7EU,
+  0x90698081U, 0x00685181U, 0x00692282U, 0x9068F382U,
+  0x006BC484U, 0x906A1584U, 0x906B6687U, 0x006AB787U,
+  0x006E0888U, 0x906FD988U, 0x906EAA8BU, 0x006F7B8BU,
+  0x906C4C8DU, 0x006D9D8DU, 0x006CEE8EU, 0x906D3F8EU,
+  0x00659090U, 0x90644190U, 0x90653293U, 0x0064E393U,
+  0x9067D495U, 0x00660595U, 0x00677696U, 0x9066A796U,
+  0x90621899U, 0x0063C999U, 0x0062BA9AU, 0x90636B9AU,
+  0x00605C9CU, 0x90618D9CU, 0x9060FE9FU, 0x00612F9FU,
+  0x0072A0A0U, 0x907371A0U, 0x907202A3U, 0x0073D3A3U,
+  0x9070E4A5U, 0x007135A5U, 0x007046A6U, 0x907197A6U,
+  0x907528A9U, 0x0074F9A9U, 0x00758AAAU, 0x90745BAAU,
+  0x00776CACU, 0x9076BDACU, 0x9077CEAFU, 0x00761FAFU,
+  0x907EB0B1U, 0x007F61B1U, 0x007E12B2U, 0x907FC3B2U,
+  0x007CF4B4U, 0x907D25B4U, 0x907C56B7U, 0x007D87B7U,
+  0x007938B8U, 0x9078E9B8U, 0x90799ABBU, 0x00784BBBU,
+  0x907B7CBDU, 0x007AADBDU, 0x007BDEBEU, 0x907A0FBEU,
+  0x005CC0C0U, 0x905D11C0U, 0x905C62C3U, 0x005DB3C3U,
+  0x905E84C5U, 0x005F55C5U, 0x005E26C6U, 0x905FF7C6U,
+  0x905B48C9U, 0x005A99C9U, 0x005BEACAU, 0x905A3BCAU,
+  0x00590CCCU, 0x9058DDCCU, 0x9059AECFU, 0x00587FCFU,
+  0x9050D0D1U, 0x005101D1U, 0x005072D2U, 0x9051A3D2U,
+  0x005294D4U, 0x905345D4U, 0x905236D7U, 0x0053E7D7U,
+  0x005758D8U, 0x905689D8U, 0x9057FADBU, 0x00562BDBU,
+  0x90551CDDU, 0x0054CDDDU, 0x0055BEDEU, 0x90546FDEU,
+  0x9047E0E1U, 0x004631E1U, 0x004742E2U, 0x904693E2U,
+  0x0045A4E4U, 0x904475E4U, 0x904506E7U, 0x0044D7E7U,
+  0x004068E8U, 0x9041B9E8U, 0x9040CAEBU, 0x00411BEBU,
+  0x90422CEDU, 0x0043FDEDU, 0x00428EEEU, 0x90435FEEU,
+  0x004BF0F0U, 0x904A21F0U, 0x904B52F3U, 0x004A83F3U,
+  0x9049B4F5U, 0x004865F5U, 0x004916F6U, 0x9048C7F6U,
+  0x904C78F9U, 0x004DA9F9U, 0x004CDAFAU, 0x904D0BFAU,
+  0x004E3CFCU, 0x904FEDFCU, 0x904E9EFFU, 0x004F4FFFU
+ },
+ {
+  0x00000000U, 0x009001D1U, 0x012003A2U, 0x01B00273U,
+  0x02400744U, 0x02D00695U, 0x036004E6U, 0x03F00537U,
+  0x04800E88U, 0x04100F59U, 0x05A00D2AU, 0x05300CFBU,
+  0x06C009CCU, 0x0650081DU, 0x07E00A6EU, 0x07700BBFU,
+  0x09001D10U, 0x09901CC1U, 0x08201EB2U, 0x08B01F63U,
+  0x0B401A54U, 0x0BD01B85U, 0x0A6019F6U, 0x0AF01827U,
+  0x0D801398U, 0x0D101249U, 0x0CA0103AU, 0x0C3011EBU,
+  0x0FC014DCU, 0x0F50150DU, 0x0EE0177EU, 0x0E7016AFU,
+  0x12003A20U, 0x12903BF1U, 0x13203982U, 0x13B03853U,
+  0x10403D64U, 0x10D03CB5U, 0x11603EC6U, 0x11F03F17U,
+  0x168034A8U, 0x16103579U, 0x17A0370AU, 0x173036DBU,
+  0x14C033ECU, 0x1450323DU, 0x15E0304EU, 0x1570319FU,
+  0x1B002730U, 0x1B9026E1U, 0x1A202492U, 0x1AB02543U,
+  0x19402074U, 0x19D021A5U, 0x186023D6U, 0x18F02207U,
+  0x1F8029B8U, 0x1F102869U, 0x1EA02A1AU, 0x1E302BCBU,
+  0x1DC02EFCU, 0x1D502F2DU, 0x1CE02D5EU, 0x1C702C8FU,
+  0x24007440U, 0x24907591U, 0x252077E2U, 0x25B07633U,
+  0x26407304U, 0x26D072D5U, 0x276070A6U, 0x27F07177U,
+  0x20807AC8U, 0x20107B19U, 0x21A0796AU, 0x213078BBU,
+  0x22C07D8CU, 0x22507C5DU, 0x23E07E2EU, 0x23707FFFU,
+  0x2D006950U, 0x2D906881U, 0x2C206AF2U, 0x2CB06B23U,
+  0x2F406E14U, 0x2FD06FC5U, 0x2E606DB6U, 0x2EF06C67U,
+  0x298067D8U, 0x29106609U, 0x28A0647AU, 0x283065ABU,
+  0x2BC0609CU, 0x2B50614DU, 0x2AE0633EU, 0x2A7062EFU,
+  0x36004E60U, 0x36904FB1U, 0x37204DC2U, 0x37B04C13U,
+  0x34404924U, 0x34D048F5U, 0x35604A86U, 0x35F04B57U,
+  0x328040E8U, 0x32104139U, 0x33A0434AU, 0x3330429BU,
+  0x30C047ACU, 0x3050467DU, 0x31E0440EU, 0x317045DFU,
+  0x3F005370U, 0x3F9052A1U, 0x3E2050D2U, 0x3EB05103U,
+  0x3D405434U, 0x3DD055E5U, 0x3C605796U, 0x3CF05647U,
+  0x3B805DF8U, 0x3B105C29U, 0x3AA05E5AU, 0x3A305F8BU,
+  0x39C05ABCU, 0x39505B6DU, 0x38E0591EU, 0x387058CFU,
+  0x4800E880U, 0x4890E951U, 0x4920EB22U, 0x49B0EAF3U,
+  0x4A40EFC4U, 0x4AD0EE15U, 0x4B60EC66U, 0x4BF0EDB7U,
+  0x4C80E608U, 0x4C10E7D9U, 0x4DA0E5AAU, 0x4D30E47BU,
+  0x4EC0E14CU, 0x4E50E09DU, 0x4FE0E2EEU, 0x4F70E33FU,
+  0x4100F590U, 0x4190F441U, 0x4020F632U, 0x40B0F7E3U,
+  0x4340F2D4U, 0x43D0F305U, 0x4260F176U, 0x42F0F0A7U,
+  0x4580FB18U, 0x4510FAC9U, 0x44A0F8BAU, 0x4430F96BU,
+  0x47C0FC5CU, 0x4750FD8DU, 0x46E0FFFEU, 0x4670FE2FU,
+  0x5A00D2A0U, 0x5A90D371U, 0x5B20D102U, 0x5BB0D0D3U,
+  0x5840D5E4U, 0x58D0D435U, 0x5960D646U, 0x59F0D797U,
+  0x5E80DC28U, 0x5E10DDF9U, 0x5FA0DF8AU, 0x5F30DE5BU,
+  0x5CC0DB6CU, 0x5C50DABDU, 0x5DE0D8CEU, 0x5D70D91FU,
+  0x5300CFB0U, 0x5390CE61U, 0x5220CC12U, 0x52B0CDC3U,
+  0x5140C8F4U, 0x51D0C925U, 0x5060CB56U, 0x50F0CA87U,
+  0x5780C138U, 0x5710C0E9U, 0x56A0C29AU, 0x5630C34BU,
+  0x55C0C67CU, 0x5550C7ADU, 0x54E0C5DEU, 0x5470C40FU,
+  0x6C009CC0U, 0x6C909D11U, 0x6D209F62U, 0x6DB09EB3U,
+  0x6E409B84U, 0x6ED09A55U, 0x6F609826U, 0x6FF099F7U,
+  0x68809248U, 0x68109399U, 0x69A091EAU, 0x6930903BU,
+  0x6AC0950CU, 0x6A5094DDU, 0x6BE096AEU, 0x6B70977FU,
+  0x650081D0U, 0x65908001U, 0x64208272U, 0x64B083A3U,
+  0x67408694U, 0x67D08745U, 0x66608536U, 0x66F084E7U,
+  0x61808F58U, 0x61108E89U, 0x60A08CFAU, 0x60308D2BU,
+  0x63C0881CU, 0x635089CDU, 0x62E08BBEU, 0x62708A6FU,
+  0x7E00A6E0U, 0x7E90A731U, 0x7F20A542U, 0x7FB0A493U,
+  0x7C40A1A4U, 0x7CD0A075U, 0x7D60A206U, 0x7DF0A3D7U,
+  0x7A80A868U, 0x7A10A9B9U, 0x7BA0ABCAU, 0x7B30AA1BU,
+  0x78C0AF2CU, 0x7850AEFDU, 0x79E0AC8EU, 0x7970AD5FU,
+  0x7700BBF0U, 0x7790BA21U, 0x7620B852U, 0x76B0B983U,
+  0x7540BCB4U, 0x75D0BD65U, 0x7460BF16U, 0x74F0BEC7U,
+  0x7380B578U, 0x7310B4A9U, 0x72A0B6DAU, 0x7230B70BU,
+  0x71C0B23CU, 0x7150B3EDU, 0x70E0B19EU, 0x7070B04FU
+ },
+ {
+  0x00000000U, 0x65904101U, 0xCB208202U, 0xAEB0C303U,
+  0x26420407U, 0x43D24506U, 0xED628605U, 0x88F2C704U,
+  0x4C84080EU, 0x2914490FU, 0x87A48A0CU, 0xE234CB0DU,
+  0x6AC60C09U, 0x0F564D08U, 0xA1E68E0BU, 0xC476CF0AU,
+  0x9908101CU, 0xFC98511DU, 0x5228921EU, 0x37B8D31FU,
+  0xBF4A141BU, 0xDADA551AU, 0x746A9619U, 0x11FAD718U,
+  0xD58C1812U, 0xB01C5913U, 0x1EAC9A10U, 0x7B3CDB11U,
+  0xF3CE1C15U, 0x965E5D14U, 0x38EE9E17U, 0x5D7EDF16U,
+  0x8213203BU, 0xE783613AU, 0x4933A239U, 0x2CA3E338U,
+  0xA451243CU, 0xC1C1653DU, 0x6F71A63EU, 0x0AE1E73FU,
+  0xCE972835U, 0xAB076934U, 0x05B7AA37U, 0x6027EB36U,
+  0xE8D52C32U, 0x8D456D33U, 0x23F5AE30U, 0x4665EF31U,
+  0x1B1B3027U, 0x7E8B7126U, 0xD03BB225U, 0xB5ABF324U,
+  0x3D593420U, 0x58C97521U, 0xF679B622U, 0x93E9F723U,
+  0x579F3829U, 0x320F7928U, 0x9CBFBA2BU, 0xF92FFB2AU,
+  0x71DD3C2EU, 0x144D7D2FU, 0xBAFDBE2CU, 0xDF6DFF2DU,
+  0xB4254075U, 0xD1B50174U, 0x7F05C277U, 0x1A958376U,
+  0x92674472U, 0xF7F70573U, 0x5947C670U, 0x3CD78771U,
+  0xF8A1487BU, 0x9D31097AU, 0x3381CA79U, 0x56118B78U,
+  0xDEE34C7CU, 0xBB730D7DU, 0x15C3CE7EU, 0x70538F7FU,
+  0x2D2D5069U, 0x48BD1168U, 0xE60DD26BU, 0x839D936AU,
+  0x0B6F546EU, 0x6EFF156FU, 0xC04FD66CU, 0xA5DF976DU,
+  0x61A95867U, 0x04391966U, 0xAA89DA65U, 0xCF199B64U,
+  0x47EB5C60U, 0x227B1D61U, 0x8CCBDE62U, 0xE95B9F63U,
+  0x3636604EU, 0x53A6214FU, 0xFD16E24CU, 0x9886A34DU,
+  0x10746449U, 0x75E42548U, 0xDB54E64BU, 0xBEC4A74AU,
+  0x7AB26840U, 0x1F222941U, 0xB192EA42U, 0xD402AB43U,
+  0x5CF06C47U, 0x39602D46U, 0x97D0EE45U, 0xF240AF44U,
+  0xAF3E7052U, 0xCAAE3153U, 0x641EF250U, 0x018EB351U,
+  0x897C7455U, 0xECEC3554U, 0x425CF657U, 0x27CCB756U,
+  0xE3BA785CU, 0x862A395DU, 0x289AFA5EU, 0x4D0ABB5FU,
+  0xC5F87C5BU, 0xA0683D5AU, 0x0ED8FE59U, 0x6B48BF58U,
+  0xD84980E9U, 0xBDD9C1E8U, 0x136902EBU, 0x76F943EAU,
+  0xFE0B84EEU, 0x9B9BC5EFU, 0x352B06ECU, 0x50BB47EDU,
+  0x94CD88E7U, 0xF15DC9E6U, 0x5FED0AE5U, 0x3A7D4BE4U,
+  0xB28F8CE0U, 0xD71FCDE1U, 0x79AF0EE2U, 0x1C3F4FE3U,
+  0x414190F5U, 0x24D1D1F4U, 0x8A6112F7U, 0xEFF153F6U,
+  0x670394F2U, 0x0293D5F3U, 0xAC2316F0U, 0xC9B357F1U,
+  0x0DC598FBU, 0x6855D9FAU, 0xC6E51AF9U, 0xA3755BF8U,
+  0x2B879CFCU, 0x4E17DDFDU, 0xE0A71EFEU, 0x85375FFFU,
+  0x5A5AA0D2U, 0x3FCAE1D3U, 0x917A22D0U, 0xF4EA63D1U,
+  0x7C18A4D5U, 0x1988E5D4U, 0xB73826D7U, 0xD2A867D6U,
+  0x16DEA8DCU, 0x734EE9DDU, 0xDDFE2ADEU, 0xB86E6BDFU,
+  0x309CACDBU, 0x550CEDDAU, 0xFBBC2ED9U, 0x9E2C6FD8U,
+  0xC352B0CEU, 0xA6C2F1CFU, 0x087232CCU, 0x6DE273CDU,
+  0xE510B4C9U, 0x8080F5C8U, 0x2E3036CBU, 0x4BA077CAU,
+  0x8FD6B8C0U, 0xEA46F9C1U, 0x44F63AC2U, 0x21667BC3U,
+  0xA994BCC7U, 0xCC04FDC6U, 0x62B43EC5U, 0x07247FC4U,
+  0x6C6CC09CU, 0x09FC819DU, 0xA74C429EU, 0xC2DC039FU,
+  0x4A2EC49BU, 0x2FBE859AU, 0x810E4699U, 0xE49E0798U,
+  0x20E8C892U, 0x45788993U, 0xEBC84A90U, 0x8E580B91U,
+  0x06AACC95U, 0x633A8D94U, 0xCD8A4E97U, 0xA81A0F96U,
+  0xF564D080U, 0x90F49181U, 0x3E445282U, 0x5BD41383U,
+  0xD326D487U, 0xB6B69586U, 0x18065685U, 0x7D961784U,
+  0xB9E0D88EU, 0xDC70998FU, 0x72C05A8CU, 0x17501B8DU,
+  0x9FA2DC89U, 0xFA329D88U, 0x54825E8BU, 0x31121F8AU,
+  0xEE7FE0A7U, 0x8BEFA1A6U, 0x255F62A5U, 0x40CF23A4U,
+  0xC83DE4A0U, 0xADADA5A1U, 0x031D66A2U, 0x668D27A3U,
+  0xA2FBE8A9U, 0xC76BA9A8U, 0x69DB6AABU, 0x0C4B2BAAU,
+  0x84B9ECAEU, 0xE129ADAFU, 0x4F996EACU, 0x2A092FADU,
+  0x7777F0BBU, 0x12E7B1BAU, 0xBC5772B9U, 0xD9C733B8U,
+  0x5135F4BCU, 0x34A5B5BDU, 0x9A1576BEU, 0xFF8537BFU,
+  0x3BF3F8B5U, 0x5E63B9B4U, 0xF0D37AB7U, 0x95433BB6U,
+  0x1DB1FCB2U, 0x7821BDB3U, 0xD6917EB0U, 0xB3013FB1U
+ }
+};
+
 /*
  * CDROM EDC calculation
  */
@@ -123,6 +657,20 @@ uint32_t EDCCrc32(const unsigned char *data, int len)
 {
    uint32_t crc = 0;
 
+   /* Eight bytes per step; the loads are byte-wise so this doesn't care about host endianness or alignment. */
+   while(len >= 8)
+   {
+      const uint32_t lo = crc ^ (data[0] | (data[1] << 8) | (data[2] << 16) | ((uint32_t)data[3] << 24));
+
+      crc = edctable_slice[7][lo & 0xFF] ^ edctable_slice[6][(lo >> 8) & 0xFF] ^
+            edctable_slice[5][(lo >> 16) & 0xFF] ^ edctable_slice[4][lo >> 24] ^
+            edctable_slice[3][data[4]] ^ edctable_slice[2][data[5]] ^
+            edctable_slice[1][data[6]] ^ edctable_slice[0][data[7]];
+
+      data += 8;
+      len -= 8;
+   }
+
    while(len--)
       crc = edctable[(crc ^ *data++) & 0xFF] ^ (crc >> 8);
 
@@ -0,0 +1,484 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ FLAC frame decoder, for the CD audio codec of CHD images: just what it takes to turn a run of frames of 16-bit audio
+ back into samples, with the frame CRCs checked.
+*/
+
+#include <string.h>
+
+#include "flacdec.h"
+
+typedef struct
+{
+   const uint8_t *src;
+   size_t len;
+   size_t pos;       // Next byte to go into "cache"
+   uint64_t cache;   // Bits not read yet, MSB-first
+   unsigned bits;
+} bitreader;
+
+static void br_refill(bitreader *br)
+{
+   while(br->bits <= 56)
+   {
+      // Past the end, the cache is filled out with 0s; that's only an error if they get read.
+      const uint64_t b = (br->pos < br->len) ? br->src[br->pos] : 0;
+
+      br->pos++;
+      br->cache |= b << (56 - br->bits);
+      br->bits += 8;
+   }
+}
+
+static int br_overrun(const bitreader *br)
+{
+   return ((uint64_t)br->pos * 8 - br->bits) > ((uint64_t)br->len * 8);
+}
+
+static uint32_t br_read(bitreader *br, unsigned count)
+{
+   uint32_t v;
+
+   if(!count)
+      return 0;
+
+   if(br->bits < count)
+      br_refill(br);
+
+   v = br->cache >> (64 - count);
+   br->cache <<= count;
+   br->bits -= count;
+
+   return v;
+}
+
+static int32_t br_read_signed(bitreader *br, unsigned count)
+{
+   uint32_t v;
+
+   if(!count)
+      return 0;
+
+   v = br_read(br, count);
+
+   if(count < 32 && (v & (1U << (count - 1))))
+      v -= 1U << count;
+
+   return (int32_t)v;
+}
+
+// Number of 0 bits before the next 1, which is read too.
+static uint32_t br_unary(bitreader *br)
+{
+   uint32_t count = 0;
+   unsigned zeros;
+
+   if(br->bits < 32)
+      br_refill(br);
+
+   while(!br->cache)
+   {
+      count += br->bits;
+      br->bits = 0;
+      br_refill(br);
+
+      if(br->pos > (br->len + 8))
+         return count;
+   }
+
+#if defined(__GNUC__)
+   zeros = __builtin_clzll(br->cache);
+#else
+   for(zeros = 0; !(br->cache & ((uint64_t)1 << (63 - zeros))); zeros++);
+#endif
+
+   br->cache <<= zeros + 1;
+   br->bits -= zeros + 1;
+
+   return count + zeros;
+}
+
+// Position of the next bit to be read, in bytes(rounded down).
+static size_t br_byte_pos(const bitreader *br)
+{
+   return br->pos - (br->bits + 7) / 8;
+}
+
+static void br_align(bitreader *br)
+{
+   br_read(br, br->bits & 7);
+}
+
+static uint8_t crc8_table[256];
+static uint16_t crc16_table[256];
+static int crc_tables_init = 0;
+
+static void init_crc_tables(void)
+{
+   unsigned i, j;
+
+   for(i = 0; i < 256; i++)
+   {
+      uint8_t c8 = i;
+      uint16_t c16 = i << 8;
+
+      for(j = 0; j < 8; j++)
+      {
+         c8 = (c8 << 1) ^ ((c8 & 0x80) ? 0x07 : 0);
+         c16 = (c16 << 1) ^ ((c16 & 0x8000) ? 0x8005 : 0);
+      }
+
+      crc8_table[i] = c8;
+      crc16_table[i] = c16;
+   }
+
+   crc_tables_init = 1;
+}
+
+static uint8_t calc_crc8(const uint8_t *data, size_t len)
+{
+   uint8_t crc = 0;
+
+   while(len--)
+      crc = crc8_table[crc ^ *data++];
+
+   return crc;
+}
+
+static uint16_t calc_crc16(const uint8_t *data, size_t len)
+{
+   uint16_t crc = 0;
+
+   while(len--)
+      crc = (crc << 8) ^ crc16_table[(crc >> 8) ^ *data++];
+
+   return crc;
+}
+
+static int decode_residual(bitreader *br, int32_t *out, unsigned blocksize, unsigned order)
+{
+   const unsigned method = br_read(br, 2);
+   const unsigned param_bits = method ? 5 : 4;
+   const unsigned escape = (1 << param_bits) - 1;
+   const unsigned part_order = br_read(br, 4);
+   const unsigned part_size = blocksize >> part_order;
+   unsigned part;
+   unsigned i = order;
+
+   if(method > 1 || (part_size << part_order) != blocksize || part_size < order)
+      return 0;
+
+   for(part = 0; part < (1U << part_order); part++)
+   {
+      const unsigned k = br_read(br, param_bits);
+      unsigned n = part_size - (part ? 0 : order);
+
+      if(k == escape)
+      {
+         const unsigned raw_bits = br_read(br, 5);
+
+         while(n--)
+            out[i++] = br_read_signed(br, raw_bits);
+      }
+      else
+      {
+         while(n--)
+         {
+            const uint32_t q = br_unary(br);
+            const uint32_t v = (q << k) | br_read(br, k);
+
+            out[i++] = (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+         }
+      }
+
+      if(br_overrun(br))
+         return 0;
+   }
+
+   return 1;
+}
+
+static int decode_subframe(bitreader *br, int32_t *s, unsigned blocksize, unsigned bps)
+{
+   unsigned type;
+   unsigned wasted = 0;
+   unsigned order;
+   unsigned i;
+
+   if(br_read(br, 1))
+      return 0;
+
+   type = br_read(br, 6);
+
+   if(br_read(br, 1))
+   {
+      wasted = br_unary(br) + 1;
+
+      if(wasted >= bps)
+         return 0;
+
+      bps -= wasted;
+   }
+
+   if(type == 0)	// Constant
+   {
+      const int32_t v = br_read_signed(br, bps);
+
+      for(i = 0; i < blocksize; i++)
+         s[i] = v;
+   }
+   else if(type == 1)	// Verbatim
+   {
+      for(i = 0; i < blocksize; i++)
+         s[i] = br_read_signed(br, bps);
+   }
+   else if(type >= 8 && type <= 12)	// Fixed predictor
+   {
+      order = type - 8;
+
+      if(order > blocksize)
+         return 0;
+
+      for(i = 0; i < order; i++)
+         s[i] = br_read_signed(br, bps);
+
+      if(!decode_residual(br, s, blocksize, order))
+         return 0;
+
+      switch(order)
+      {
+         case 1:
+            for(i = 1; i < blocksize; i++)
+               s[i] += s[i - 1];
+            break;
+
+         case 2:
+            for(i = 2; i < blocksize; i++)
+               s[i] += 2 * s[i - 1] - s[i - 2];
+            break;
+
+         case 3:
+            for(i = 3; i < blocksize; i++)
+               s[i] += 3 * s[i - 1] - 3 * s[i - 2] + s[i - 3];
+            break;
+
+         case 4:
+            for(i = 4; i < blocksize; i++)
+               s[i] += 4 * s[i - 1] - 6 * s[i - 2] + 4 * s[i - 3] - s[i - 4];
+            break;
+      }
+   }
+   else if(type >= 32)	// LPC
+   {
+      int32_t coefs[32];
+      unsigned precision;
+      int shift;
+      unsigned j;
+
+      order = (type & 31) + 1;
+
+      if(order > blocksize)
+         return 0;
+
+      for(i = 0; i < order; i++)
+         s[i] = br_read_signed(br, bps);
+
+      precision = br_read(br, 4) + 1;
+      shift = br_read_signed(br, 5);
+
+      if(precision == 16 || shift < 0)
+         return 0;
+
+      for(i = 0; i < order; i++)
+         coefs[i] = br_read_signed(br, precision);
+
+      if(!decode_residual(br, s, blocksize, order))
+         return 0;
+
+      for(i = order; i < blocksize; i++)
+      {
+         int64_t sum = 0;
+
+         for(j = 0; j < order; j++)
+            sum += (int64_t)coefs[j] * s[i - 1 - j];
+
+         s[i] += (int32_t)(sum >> shift);
+      }
+   }
+   else
+      return 0;
+
+   if(wasted)
+   {
+      for(i = 0; i < blocksize; i++)
+         s[i] = (int32_t)((uint32_t)s[i] << wasted);
+   }
+
+   return !br_overrun(br);
+}
+
+// Returns the number of samples decoded(per channel), 0 on error.
+static unsigned decode_frame(bitreader *br, flacdec_work *work, unsigned channels)
+{
+   static const unsigned bps_table[8] = { 16, 8, 12, 0, 16, 20, 24, 0 };
+   const size_t start = br_byte_pos(br);
+   unsigned blocksize, bs_code, sr_code, ch_code, bps;
+   unsigned frame_channels;
+   uint32_t b;
+   unsigned ch;
+   size_t end;
+   uint16_t crc;
+
+   if(br_read(br, 15) != 0x7FFC)	// Sync code, and the reserved bit
+      return 0;
+
+   br_read(br, 1);	// Blocking strategy
+   bs_code = br_read(br, 4);
+   sr_code = br_read(br, 4);
+   ch_code = br_read(br, 4);
+   bps = bps_table[br_read(br, 3)];
+
+   if(br_read(br, 1) || !bps || bps > 24 || !bs_code || sr_code == 15)
+      return 0;
+
+   // Frame/sample number, UTF-8-style
+   b = br_read(br, 8);
+
+   if(b & 0x80)
+   {
+      unsigned extra = 0;
+
+      while(b & (0x40 >> extra))
+         extra++;
+
+      if(!extra || extra > 6)
+         return 0;
+
+      while(extra--)
+      {
+         if((br_read(br, 8) & 0xC0) != 0x80)
+            return 0;
+      }
+   }
+
+   if(bs_code == 1)
+      blocksize = 192;
+   else if(bs_code <= 5)
+      blocksize = 576 << (bs_code - 2);
+   else if(bs_code == 6)
+      blocksize = br_read(br, 8) + 1;
+   else if(bs_code == 7)
+      blocksize = br_read(br, 16) + 1;
+   else
+      blocksize = 256 << (bs_code - 8);
+
+   if(sr_code == 12)
+      br_read(br, 8);
+   else if(sr_code == 13 || sr_code == 14)
+      br_read(br, 16);
+
+   if(br_overrun(br) || calc_crc8(br->src + start, br_byte_pos(br) - start) != br_read(br, 8))
+      return 0;
+
+   if(ch_code < 8)
+      frame_channels = ch_code + 1;
+   else if(ch_code <= 10)
+      frame_channels = 2;
+   else
+      return 0;
+
+   if(frame_channels != channels || blocksize > FLACDEC_MAX_BLOCKSIZE)
+      return 0;
+
+   for(ch = 0; ch < channels; ch++)
+   {
+      // The side channel has an extra bit.
+      const unsigned side = (ch_code == 8 && ch == 1) || (ch_code == 9 && ch == 0) || (ch_code == 10 && ch == 1);
+
+      if(!decode_subframe(br, work->residual[ch], blocksize, bps + side))
+         return 0;
+   }
+
+   br_align(br);
+   end = br_byte_pos(br);
+   crc = br_read(br, 16);
+
+   if(br_overrun(br) || calc_crc16(br->src + start, end - start) != crc)
+      return 0;
+
+   if(ch_code >= 8)
+   {
+      int32_t *l = work->residual[0];
+      int32_t *r = work->residual[1];
+      unsigned i;
+
+      for(i = 0; i < blocksize; i++)
+      {
+         if(ch_code == 8)	// Left/side
+            r[i] = l[i] - r[i];
+         else if(ch_code == 9)	// Side/right
+            l[i] += r[i];
+         else	// Mid/side
+         {
+            const int32_t mid = ((uint32_t)l[i] << 1) | (r[i] & 1);
+            const int32_t side = r[i];
+
+            l[i] = (mid + side) >> 1;
+            r[i] = (mid - side) >> 1;
+         }
+      }
+   }
+
+   return blocksize;
+}
+
+long flacdec_decode(flacdec_work *work, int16_t *dest, unsigned channels, uint32_t samples, const uint8_t *src, size_t src_len)
+{
+   bitreader br;
+
+   if(!crc_tables_init)
+      init_crc_tables();
+
+   if(!channels || channels > FLACDEC_MAX_CHANNELS)
+      return -1;
+
+   memset(&br, 0, sizeof(br));
+   br.src = src;
+   br.len = src_len;
+
+   while(samples)
+   {
+      const unsigned blocksize = decode_frame(&br, work, channels);
+      const unsigned count = (blocksize < samples) ? blocksize : samples;
+      unsigned i, ch;
+
+      if(!blocksize)
+         return -1;
+
+      for(i = 0; i < count; i++)
+      {
+         for(ch = 0; ch < channels; ch++)
+            *dest++ = work->residual[ch][i];
+      }
+
+      samples -= count;
+   }
+
+   return br_byte_pos(&br);
+}
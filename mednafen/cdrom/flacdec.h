@@ -0,0 +1,30 @@
+#ifndef __MDFN_CDROM_FLACDEC_H
+#define __MDFN_CDROM_FLACDEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FLACDEC_MAX_CHANNELS  2
+#define FLACDEC_MAX_BLOCKSIZE 4608
+
+typedef struct flacdec_work
+{
+   int32_t residual[FLACDEC_MAX_CHANNELS][FLACDEC_MAX_BLOCKSIZE];
+} flacdec_work;
+
+/* Decodes FLAC frames, as they come in a stream but with no "fLaC" marker or metadata blocks before them, from "src" into
+ * "dest" as interleaved 16-bit samples, until "samples"(per channel) have been.  Frame headers that refer to the
+ * STREAMINFO block for the sample rate or size get 16 bits.  "work" is scratch space.  Returns how many bytes of "src"
+ * the frames took up, or -1 if they're corrupt or don't match "channels".
+ */
+long flacdec_decode(flacdec_work *work, int16_t *dest, unsigned channels, uint32_t samples, const uint8_t *src, size_t src_len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -476,6 +476,18 @@ void lec_encode_mode1_sector(uint32_t adr, uint8_t *sector)
    calc_Q_parity(sector);
 }
 
+/* Rewrites the sync pattern and the P and Q parities of a sector, from
+ * the header and data already in it.
+ * 'sector' must be 2352 byte wide
+ */
+void lec_encode_ecc(uint8_t *sector)
+{
+   set_sync_pattern(sector);
+
+   calc_P_parity(sector);
+   calc_Q_parity(sector);
+}
+
 /* Encodes a MODE 2 sector.
  * 'adr' is the current physical sector address
  * 'sector' must be 2352 byte wide containing 2336 bytes user data at
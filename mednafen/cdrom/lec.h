@@ -65,6 +65,12 @@ void lec_encode_mode2_form1_sector(uint32_t adr, uint8_t *sector);
  */
 void lec_encode_mode2_form2_sector(uint32_t adr, uint8_t *sector);
 
+/* Rewrites the sync pattern and the P and Q parities of a sector, from
+ * the header and data already in it.
+ * 'sector' must be 2352 byte wide
+ */
+void lec_encode_ecc(uint8_t *sector);
+
 /* Scrambles and byte swaps an encoded sector.
  * 'sector' must be 2352 byte wide.
  */
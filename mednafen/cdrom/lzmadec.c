@@ -0,0 +1,319 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+/*
+ LZMA decoder, for the CD codecs of CHD images.  It follows the decoder in the LZMA specification, less everything
+ streaming needs: the whole of the input and output are at hand, and the output buffer is the dictionary.
+*/
+
+#include <string.h>
+
+#include "lzmadec.h"
+
+#define PROB_BITS    11
+#define PROB_INIT    (1 << (PROB_BITS - 1))
+#define MOVE_BITS    5
+#define TOP_VALUE    (1U << 24)
+
+#define NUM_STATES         12
+#define NUM_LEN_TO_POS     4
+#define END_POS_MODEL      14
+#define NUM_ALIGN_BITS     4
+
+#define LEN_CHOICE   0
+#define LEN_CHOICE2  1
+#define LEN_LOW      2
+#define LEN_MID      (LEN_LOW + (16 << 3))
+#define LEN_HIGH     (LEN_MID + (16 << 3))
+
+typedef struct
+{
+   uint32_t range;
+   uint32_t code;
+   const uint8_t *src;
+   const uint8_t *src_end;
+   int overrun;
+} range_dec;
+
+static uint8_t rc_byte(range_dec *rc)
+{
+   if(rc->src == rc->src_end)
+   {
+      rc->overrun = 1;
+      return 0;
+   }
+
+   return *rc->src++;
+}
+
+static void rc_normalize(range_dec *rc)
+{
+   if(rc->range < TOP_VALUE)
+   {
+      rc->range <<= 8;
+      rc->code = (rc->code << 8) | rc_byte(rc);
+   }
+}
+
+static unsigned rc_bit(range_dec *rc, uint16_t *prob)
+{
+   const uint32_t bound = (rc->range >> PROB_BITS) * *prob;
+   unsigned bit;
+
+   if(rc->code < bound)
+   {
+      *prob += ((1 << PROB_BITS) - *prob) >> MOVE_BITS;
+      rc->range = bound;
+      bit = 0;
+   }
+   else
+   {
+      *prob -= *prob >> MOVE_BITS;
+      rc->code -= bound;
+      rc->range -= bound;
+      bit = 1;
+   }
+
+   rc_normalize(rc);
+
+   return bit;
+}
+
+static uint32_t rc_direct_bits(range_dec *rc, unsigned count)
+{
+   uint32_t res = 0;
+
+   while(count--)
+   {
+      uint32_t t;
+
+      rc->range >>= 1;
+      rc->code -= rc->range;
+      t = 0 - (rc->code >> 31);
+      rc->code += rc->range & t;
+      rc_normalize(rc);
+      res = (res << 1) + (t + 1);
+   }
+
+   return res;
+}
+
+static unsigned rc_tree(range_dec *rc, uint16_t *probs, unsigned bits)
+{
+   unsigned m = 1;
+   unsigned i;
+
+   for(i = 0; i < bits; i++)
+      m = (m << 1) + rc_bit(rc, &probs[m]);
+
+   return m - (1 << bits);
+}
+
+static unsigned rc_tree_reverse(range_dec *rc, uint16_t *probs, unsigned bits)
+{
+   unsigned m = 1;
+   unsigned sym = 0;
+   unsigned i;
+
+   for(i = 0; i < bits; i++)
+   {
+      const unsigned bit = rc_bit(rc, &probs[m]);
+
+      m = (m << 1) + bit;
+      sym |= bit << i;
+   }
+
+   return sym;
+}
+
+static unsigned decode_len(range_dec *rc, uint16_t *probs, unsigned pos_state)
+{
+   if(!rc_bit(rc, &probs[LEN_CHOICE]))
+      return rc_tree(rc, &probs[LEN_LOW + (pos_state << 3)], 3);
+
+   if(!rc_bit(rc, &probs[LEN_CHOICE2]))
+      return 8 + rc_tree(rc, &probs[LEN_MID + (pos_state << 3)], 3);
+
+   return 16 + rc_tree(rc, &probs[LEN_HIGH], 8);
+}
+
+static uint32_t decode_distance(range_dec *rc, lzmadec_probs *p, unsigned len)
+{
+   const unsigned len_state = (len < NUM_LEN_TO_POS - 1) ? len : (NUM_LEN_TO_POS - 1);
+   const unsigned pos_slot = rc_tree(rc, p->pos_slot[len_state], 6);
+   unsigned direct_bits;
+   uint32_t dist;
+
+   if(pos_slot < 4)
+      return pos_slot;
+
+   direct_bits = (pos_slot >> 1) - 1;
+   dist = (2 | (pos_slot & 1)) << direct_bits;
+
+   if(pos_slot < END_POS_MODEL)
+      return dist + rc_tree_reverse(rc, p->pos_special + dist - pos_slot, direct_bits);
+
+   dist += rc_direct_bits(rc, direct_bits - NUM_ALIGN_BITS) << NUM_ALIGN_BITS;
+
+   return dist + rc_tree_reverse(rc, p->align, NUM_ALIGN_BITS);
+}
+
+long lzmadec_decode(lzmadec_probs *probs, uint8_t *dest, size_t dest_len, const uint8_t *src, size_t src_len,
+      unsigned lc, unsigned lp, unsigned pb)
+{
+   uint16_t *p = (uint16_t *)probs;
+   const size_t num_probs = (sizeof(*probs) - sizeof(probs->literal)) / sizeof(uint16_t) + (0x300 << (lc + lp));
+   const unsigned pb_mask = (1 << pb) - 1;
+   const unsigned lp_mask = (1 << lp) - 1;
+   uint32_t rep0 = 0, rep1 = 0, rep2 = 0, rep3 = 0;
+   unsigned state = 0;
+   size_t pos = 0;
+   size_t i;
+   range_dec rc;
+
+   if((lc + lp) > LZMADEC_MAX_LCLP || pb > 4)
+      return -1;
+
+   for(i = 0; i < num_probs; i++)
+      p[i] = PROB_INIT;
+
+   rc.src = src;
+   rc.src_end = src + src_len;
+   rc.overrun = 0;
+   rc.range = 0xFFFFFFFF;
+   rc.code = 0;
+
+   if(rc_byte(&rc) != 0)
+      return -1;
+
+   for(i = 0; i < 4; i++)
+      rc.code = (rc.code << 8) | rc_byte(&rc);
+
+   if(rc.code == rc.range)
+      return -1;
+
+   while(pos < dest_len)
+   {
+      const unsigned pos_state = pos & pb_mask;
+      unsigned len;
+
+      if(rc.overrun)
+         return -1;
+
+      if(!rc_bit(&rc, &probs->is_match[(state << 4) + pos_state]))
+      {
+         const unsigned prev = pos ? dest[pos - 1] : 0;
+         uint16_t *lit = &probs->literal[0x300 * (((pos & lp_mask) << lc) + (prev >> (8 - lc)))];
+         unsigned sym = 1;
+
+         if(state >= 7)
+         {
+            unsigned match_byte = dest[pos - rep0 - 1];
+
+            do
+            {
+               const unsigned match_bit = (match_byte >> 7) & 1;
+               const unsigned bit = rc_bit(&rc, &lit[((1 + match_bit) << 8) + sym]);
+
+               match_byte <<= 1;
+               sym = (sym << 1) | bit;
+
+               if(match_bit != bit)
+                  break;
+            } while(sym < 0x100);
+         }
+
+         while(sym < 0x100)
+            sym = (sym << 1) | rc_bit(&rc, &lit[sym]);
+
+         dest[pos++] = sym;
+         state = (state < 4) ? 0 : ((state < 10) ? (state - 3) : (state - 6));
+         continue;
+      }
+
+      if(!rc_bit(&rc, &probs->is_rep[state]))
+      {
+         rep3 = rep2;
+         rep2 = rep1;
+         rep1 = rep0;
+         len = decode_len(&rc, probs->len[0], pos_state);
+         state = (state < 7) ? 7 : 10;
+         rep0 = decode_distance(&rc, probs, len);
+
+         if(rep0 == 0xFFFFFFFF)	// End marker
+            break;
+      }
+      else
+      {
+         if(!pos)
+            return -1;
+
+         if(!rc_bit(&rc, &probs->is_rep_g0[state]))
+         {
+            if(!rc_bit(&rc, &probs->is_rep0_long[(state << 4) + pos_state]))
+            {
+               state = (state < 7) ? 9 : 11;
+               dest[pos] = dest[pos - rep0 - 1];
+               pos++;
+               continue;
+            }
+         }
+         else
+         {
+            uint32_t dist;
+
+            if(!rc_bit(&rc, &probs->is_rep_g1[state]))
+               dist = rep1;
+            else
+            {
+               if(!rc_bit(&rc, &probs->is_rep_g2[state]))
+                  dist = rep2;
+               else
+               {
+                  dist = rep3;
+                  rep3 = rep2;
+               }
+               rep2 = rep1;
+            }
+            rep1 = rep0;
+            rep0 = dist;
+         }
+
+         len = decode_len(&rc, probs->len[1], pos_state);
+         state = (state < 7) ? 8 : 11;
+      }
+
+      if(rep0 >= pos)
+         return -1;
+
+      len += 2;
+
+      if(len > (dest_len - pos))
+         len = dest_len - pos;
+
+      while(len--)
+      {
+         dest[pos] = dest[pos - rep0 - 1];
+         pos++;
+      }
+   }
+
+   if(rc.overrun)
+      return -1;
+
+   return pos;
+}
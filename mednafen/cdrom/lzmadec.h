@@ -0,0 +1,40 @@
+#ifndef __MDFN_CDROM_LZMADEC_H
+#define __MDFN_CDROM_LZMADEC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Probabilities for literal coding, for up to lc + lp = 4(as with LZMA2, and more than enough for CHD's lc = 3, lp = 0). */
+#define LZMADEC_MAX_LCLP 4
+
+typedef struct lzmadec_probs
+{
+   uint16_t is_match[12 << 4];
+   uint16_t is_rep[12];
+   uint16_t is_rep_g0[12];
+   uint16_t is_rep_g1[12];
+   uint16_t is_rep_g2[12];
+   uint16_t is_rep0_long[12 << 4];
+   uint16_t pos_slot[4][1 << 6];
+   uint16_t pos_special[1 + 128 - 14];
+   uint16_t align[1 << 4];
+   uint16_t len[2][2 + (16 << 3) * 2 + 256];
+   uint16_t literal[0x300 << LZMADEC_MAX_LCLP];
+} lzmadec_probs;
+
+/* Decodes a raw LZMA stream(no properties header, end marker optional) straight into "dest", which doubles as the
+ * dictionary, so it has to be big enough for all of the output; decoding stops once it's full.  "probs" is scratch
+ * space.  Returns the number of bytes decoded, or -1 if the stream is corrupt.
+ */
+long lzmadec_decode(lzmadec_probs *probs, uint8_t *dest, size_t dest_len, const uint8_t *src, size_t src_len,
+      unsigned lc, unsigned lp, unsigned pb);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -31,6 +31,7 @@
 #include "general.h"
 #include "md5.h"
 #include "mempatcher.h"
+#include "psx/psx.h"
 
 #include "../libretro.h"
 
@@ -417,6 +418,7 @@ void MDFNMP_ApplyPeriodicCheats(void)
                uint32 page = ((chit->addr + x) / PageSize) % NumPages;
                if(RAMPtrs[page])
                {
+                  uint8 *ptr = &RAMPtrs[page][(chit->addr + x) % PageSize];
                   uint64 tmpval = chit->val;
 
                   if(chit->bigendian)
@@ -424,7 +426,14 @@ void MDFNMP_ApplyPeriodicCheats(void)
                   else
                      tmpval >>= x * 8;
 
-                  RAMPtrs[page][(chit->addr + x) % PageSize] = tmpval;
+                  // Most frames this rewrites what's there already; only a real change needs to drop code
+                  // translated from the page(a cheat that patches an instruction would otherwise do so every frame).
+                  if(*ptr != (uint8)tmpval)
+                  {
+                     *ptr = tmpval;
+                     MDFNSS_MarkDirty(ptr, 1);
+                     CPU->CheckCodeWrite(chit->addr + x);
+                  }
                }
             }
       }
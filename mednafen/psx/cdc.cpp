@@ -62,9 +62,7 @@ PS_CDC::PS_CDC() : DMABuffer(4096)
    DriveStatus = DS_STOPPED;
    PendingCommandPhase = 0;
 
-#ifndef HAVE_CDROM_NEW
    TOC_Clear(&toc);
-#endif
 }
 
 PS_CDC::~PS_CDC()
@@ -119,9 +117,17 @@ void PS_CDC::SetDisc(bool tray_open, CDIF *cdif, const char *disc_id)
    }
 }
 
+// Whether the SPU needs to be run sample by sample rather than being left to fall behind until SyncSPU():  its IRQ
+// depends on which sample reaches the IRQ address, and an async IRQ that CheckAIP() can deliver goes out on the next
+// sample boundary.
+INLINE bool PS_CDC::SPUSampleEvents(void)
+{
+   return (AsyncIRQPending && CDCReadyReceiveCounter <= 0) || SPU->IRQEnabled();
+}
+
 int32 PS_CDC::CalcNextEvent(void)
 {
-   int32 next_event = SPUCounter;
+   int32 next_event = SPUSampleEvents() ? SPUCounter : PSX_EVENT_MAXTS;
 
    if(PSRCounter > 0 && next_event > PSRCounter)
       next_event = PSRCounter;
@@ -1006,7 +1012,8 @@ void PS_CDC::HandlePlayRead(void)
             else
             {
                // maybe if(!(Mode & 0x30)) too?
-               if(!(buf[12 + 6] & 0x20))
+               // Sectors that checked out when the disc was opened needn't be checked again.
+               if(!(buf[12 + 6] & 0x20) && !Cur_CDIF->IsSectorVerified(CurSector))
                {
                   if(!edc_lec_check_and_correct(buf, true))
                   {
@@ -1075,13 +1082,17 @@ void PS_CDC::HandlePlayRead(void)
 
 int32_t PS_CDC::Update(const int32_t timestamp)
 {
+   PSX_PROFILE(PSX_PROF_CDC);
    int32 clocks = timestamp - lastts;
 
+   PSX_PROFILE_CYCLES(PSX_PROF_CDC, clocks);
+
    //doom_ts = timestamp;
 
    while(clocks > 0)
    {
       int32 chunk_clocks = clocks;
+      int32 spu_clocks;
 
       if(PSRCounter > 0 && chunk_clocks > PSRCounter)
          chunk_clocks = PSRCounter;
@@ -1089,7 +1100,7 @@ int32_t PS_CDC::Update(const int32_t timestamp)
       if(PendingCommandCounter > 0 && chunk_clocks > PendingCommandCounter)
          chunk_clocks = PendingCommandCounter;
 
-      if(chunk_clocks > SPUCounter)
+      if(chunk_clocks > SPUCounter && SPUSampleEvents())
          chunk_clocks = SPUCounter;
 
       if(DiscStartupDelay > 0)
@@ -1116,6 +1127,16 @@ int32_t PS_CDC::Update(const int32_t timestamp)
 
       CheckAIP();
 
+      // Samples due before the end of the chunk are generated before any of the events below, which happen at its end.
+      // Usually there are none, as the chunk ends on the next sample when they're generated one at a time.
+      spu_clocks = chunk_clocks;
+
+      if(chunk_clocks > SPUCounter)
+      {
+         SPUCounter = SPU->UpdateFromCDC(chunk_clocks - 1);
+         spu_clocks = 1;
+      }
+
       if(PSRCounter > 0)
       {
 
@@ -1304,7 +1325,7 @@ int32_t PS_CDC::Update(const int32_t timestamp)
          }
       }
 
-      SPUCounter = SPU->UpdateFromCDC(chunk_clocks);
+      SPUCounter = SPU->UpdateFromCDC(spu_clocks);
 
       clocks -= chunk_clocks;
    } // end while(clocks > 0)
@@ -1314,12 +1335,29 @@ int32_t PS_CDC::Update(const int32_t timestamp)
    return(timestamp + CalcNextEvent());
 }
 
+void PS_CDC::SyncSPU(const int32_t timestamp)
+{
+   const int32 behind = timestamp - (lastts + SPUCounter);
+
+   if(behind >= 0)
+      PSX_SetEventNT(PSX_EVENT_CDC, Update(timestamp - behind % 768));
+}
+
+void PS_CDC::SPUSampleEventsChanged(void)
+{
+   PSX_SetEventNT(PSX_EVENT_CDC, lastts + CalcNextEvent());
+}
+
 void PS_CDC::Write(const int32_t timestamp, uint32 A, uint8 V)
 {
    A &= 0x3;
 
    //printf("Write: %08x %02x\n", A, V);
 
+   // Besides the SPU reading CD audio state, the event rescheduling below is relative to the last update, which has
+   // always been no more than a sample ago.
+   SyncSPU(timestamp);
+
    if(A == 0x00)
    {
       RegSelector = V & 0x3;
@@ -1580,6 +1618,9 @@ int32 PS_CDC::Command_Setloc(const int arg_count, const uint8 *args)
    CommandLoc = f + 75 * s + 75 * 60 * m - 150;
    CommandLoc_Dirty = true;
 
+   // A read or seek to here usually follows shortly.
+   HintRead(CommandLoc);
+
    WriteResult(MakeStatus());
    WriteIRQ(CDCIRQ_ACKNOWLEDGE);
 
@@ -1630,6 +1671,14 @@ int32 PS_CDC::CalcSeekTime(int32 initial, int32 target, bool motor_on, bool paus
    return(ret);
 }
 
+// Lets the CD read thread start fetching from "lba" before the sectors are actually needed, so that by the time the
+// emulated seek is done they're(hopefully) in its buffer.
+void PS_CDC::HintRead(int32 lba)
+{
+   if(Cur_CDIF && lba >= 0 && lba < (int32)toc.tracks[100].lba)
+      Cur_CDIF->HintReadSector(lba);
+}
+
 // Remove this function when we have better seek emulation; it's here because the Rockman complete works games(at least 2 and 4) apparently have finicky fubared CD
 // access code.
 void PS_CDC::PreSeekHack(uint32 target)
@@ -1766,6 +1815,8 @@ void PS_CDC::ReadBase(void)
    WriteResult(MakeStatus());
    WriteIRQ(CDCIRQ_ACKNOWLEDGE);
 
+   HintRead(CommandLoc_Dirty ? CommandLoc : CurSector);
+
    if(DriveStatus == DS_SEEKING_LOGICAL && SeekTarget == CommandLoc && StatusAfterSeek == DS_READING)
    {
       CommandLoc_Dirty = false;
@@ -2106,6 +2157,7 @@ int32 PS_CDC::Command_SeekL(const int arg_count, const uint8 *args)
    WriteIRQ(CDCIRQ_ACKNOWLEDGE);
 
    SeekTarget = CommandLoc;
+   HintRead(SeekTarget);
 
    PSRCounter = (33868800 / (75 * ((Mode & MODE_SPEED) ? 2 : 1))) + CalcSeekTime(CurSector, SeekTarget, DriveStatus != DS_STOPPED, DriveStatus == DS_PAUSED);
    HeaderBufValid = false;
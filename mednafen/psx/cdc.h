@@ -30,6 +30,14 @@ class PS_CDC
 
       int32_t Update(const int32_t timestamp);
 
+      // The SPU is clocked from here, but normally runs behind, a block of samples at a time; this catches it up to the
+      // last sample due at or before "timestamp", and must be called before anything outside of the SPU looks at or
+      // changes its state.
+      void SyncSPU(const int32_t timestamp);
+
+      // Called by the SPU after a change to the condition SPUSampleEvents() checks.
+      void SPUSampleEventsChanged(void);
+
       void Write(const int32_t timestamp, uint32 A, uint8 V);
       uint8 Read(const int32_t timestamp, uint32 A);
 
@@ -171,6 +179,8 @@ class PS_CDC
 
       int32 CalcSeekTime(int32 initial, int32 target, bool motor_on, bool paused);
 
+      bool SPUSampleEvents(void);
+
       void ClearAIP(void);
       void CheckAIP(void);
       void SetAIP(unsigned irq, unsigned result_count, uint8 *r);
@@ -216,6 +226,7 @@ class PS_CDC
       };
 
       void PreSeekHack(uint32_t target);
+      void HintRead(int32 lba);
       void ReadBase(void);
 
       static CDC_CTEntry Commands[0x20];
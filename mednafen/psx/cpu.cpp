@@ -25,6 +25,9 @@
 // int pgxpMode = PGXP_GetModes();
 
 extern bool psx_cpu_overclock;
+#ifdef HAVE_JIT
+extern bool psx_cpu_dynarec;
+#endif
 
 #define BIU_ENABLE_ICACHE_S1	0x00000800	// Enable I-cache, set 1
 #define BIU_ICACHE_FSIZE_MASK	0x00000300  // I-cache fill size mask; 0x000 = 2 words, 0x100 = 4 words, 0x200 = 8 words, 0x300 = 16 words
@@ -42,13 +45,26 @@ PS_CPU::PS_CPU()
 
    memset(FastMap, 0, sizeof(FastMap));
    memset(DummyPage, 0xFF, sizeof(DummyPage));	// 0xFF to trigger an illegal instruction exception, so we'll know what's up when debugging.
+   memset(CodePages, 0, sizeof(CodePages));
 
    for(a = 0x00000000; a < (UINT64_C(1) << 32); a += FAST_MAP_PSIZE)
       SetFastMap(DummyPage, a, FAST_MAP_PSIZE);
 
+   for(i = 0; i < 256; i++)
+   {
+      Uncached_Decoded[i].instr = 0;
+      DecodeInstr(&Uncached_Decoded[i].dec, 0);
+   }
+
    CPUHook = NULL;
    ADDBT = NULL;
 
+#ifdef HAVE_JIT
+   jit_cache = NULL;
+   jit_code_copy = NULL;
+   jit_block_pc = 0;
+#endif
+
    GTE_Init();
 
    for(i = 0; i < 24; i++)
@@ -67,8 +83,16 @@ PS_CPU::PS_CPU()
 
 PS_CPU::~PS_CPU()
 {
-
-
+#ifdef HAVE_JIT
+   if(jit_cache)
+   {
+      free(jit_cache);
+      jit_cache = NULL;
+      free(jit_code_copy);
+      jit_code_copy = NULL;
+      decomp_kill();
+   }
+#endif
 }
 
 void PS_CPU::SetFastMap(void *region_mem, uint32_t region_address, uint32_t region_size)
@@ -81,6 +105,91 @@ void PS_CPU::SetFastMap(void *region_mem, uint32_t region_address, uint32_t regi
       FastMap[A >> FAST_MAP_SHIFT] = ((uint8_t *)region_mem - region_address);
 }
 
+// Returns the code page map index for a physical address, or -1 if nothing executed from there is cached.
+int PS_CPU::CodePageIndex(uint32_t address)
+{
+   if(address < 0x00800000)
+      return (address & 0x1FFFFF) >> CODE_PAGE_SHIFT;
+
+   if(address >= 0x1FC00000 && address < 0x1FC80000)
+      return (2048 * 1024 + (address & 0x7FFFF)) >> CODE_PAGE_SHIFT;
+
+   return -1;
+}
+
+// The reverse of CodePageIndex(); the physical address of the start of a code page.
+uint32_t PS_CPU::CodePageAddress(unsigned page)
+{
+   if(page < (2048 >> (CODE_PAGE_SHIFT - 10)))
+      return page << CODE_PAGE_SHIFT;
+
+   return 0x1FC00000 + ((page << CODE_PAGE_SHIFT) - 2048 * 1024);
+}
+
+void PS_CPU::MarkCodePage(uint32_t address)
+{
+   const int page = CodePageIndex(address);
+
+   if(page < 0 || ((CodePages[page >> 5] >> (page & 0x1F)) & 1))
+      return;
+
+   CodePages[page >> 5] |= 1U << (page & 0x1F);
+
+#ifdef HAVE_JIT
+   {
+      const uint32_t base = CodePageAddress(page);
+
+      memcpy(&jit_code_copy[page << CODE_PAGE_SHIFT], &FastMap[base >> FAST_MAP_SHIFT][base], 1U << CODE_PAGE_SHIFT);
+   }
+#endif
+}
+
+void PS_CPU::InvalidateCodePage(unsigned page)
+{
+   CodePages[page >> 5] &= ~(1U << (page & 0x1F));
+
+#ifdef HAVE_JIT
+   JIT_InvalidatePage(CodePageAddress(page));
+#endif
+}
+
+void PS_CPU::InvalidateCode(uint32_t address, uint32_t length)
+{
+   uint32_t A;
+
+   for(A = address & ~((1U << CODE_PAGE_SHIFT) - 1); A < (uint64)address + length; A += 1U << CODE_PAGE_SHIFT)
+   {
+      const int page = CodePageIndex(A);
+
+      if(page >= 0 && ((CodePages[page >> 5] >> (page & 0x1F)) & 1))
+         InvalidateCodePage(page);
+   }
+}
+
+void PS_CPU::CheckCodePages(void)
+{
+#ifdef HAVE_JIT
+   unsigned page;
+
+   // Every write the emulator makes to a marked page unmarks it(CheckCodeWrite()), so a marked page that doesn't
+   // match its copy was written from outside.
+   for(page = 0; page < CODE_PAGE_COUNT; page++)
+   {
+      const uint32_t base = CodePageAddress(page);
+
+      if(!CodePages[page >> 5])
+      {
+         page |= 0x1F;
+         continue;
+      }
+
+      if(((CodePages[page >> 5] >> (page & 0x1F)) & 1) &&
+            memcmp(&jit_code_copy[page << CODE_PAGE_SHIFT], &FastMap[base >> FAST_MAP_SHIFT][base], 1U << CODE_PAGE_SHIFT))
+         InvalidateCodePage(page);
+   }
+#endif
+}
+
 INLINE void PS_CPU::RecalcIPCache(void)
 {
    IPCache = 0;
@@ -133,6 +242,8 @@ void PS_CPU::Power(void)
 
    BIU = 0;
 
+   memset(CodePages, 0, sizeof(CodePages));
+
    memset(ScratchRAM.data8, 0, 1024);
 
    PGXP_Init();
@@ -141,9 +252,13 @@ void PS_CPU::Power(void)
    for(i = 0; i < 1024; i++)
    {
       ICache[i].TV = 0x2 | ((BIU & 0x800) ? 0x0 : 0x1);
-      ICache[i].Data = 0;
+      SetICacheData(i, 0);
    }
 
+#ifdef HAVE_JIT
+   JIT_Flush();
+#endif
+
    GTE_Power();
 }
 
@@ -189,7 +304,12 @@ int PS_CPU::StateAction(StateMem *sm, int load, int data_only)
 
    if(load)
    {
+      for(unsigned i = 0; i < 1024; i++)
+         DecodeInstr(&ICache_Decoded[i], ICache[i].Data);
 
+#ifdef HAVE_JIT
+      JIT_Flush();
+#endif
    }
 
    return(ret);
@@ -338,6 +458,8 @@ INLINE void PS_CPU::WriteMemory(int32_t &timestamp, uint32_t address, uint32_t v
          return;
       }
 
+      CheckCodeWrite(address);
+
       if(sizeof(T) == 1)
          PSX_MemWrite8(timestamp, address, value);
       else if(sizeof(T) == 2)
@@ -367,7 +489,7 @@ INLINE void PS_CPU::WriteMemory(int32_t &timestamp, uint32_t address, uint32_t v
 		   }
 		   else
          {
-            ICache[(address & 0xFFC) >> 2].Data = value << ((address & 0x3) * 8);
+            SetICacheData((address & 0xFFC) >> 2, value << ((address & 0x3) * 8));
          }
       }
 
@@ -382,10 +504,12 @@ INLINE void PS_CPU::WriteMemory(int32_t &timestamp, uint32_t address, uint32_t v
    }
 }
 
-INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address)
+INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address, const __ICacheDecoded *&dec)
 {
 	uint32 instr = ICache[(address & 0xFFC) >> 2].Data;
 
+	dec = &ICache_Decoded[(address & 0xFFC) >> 2];
+
 	if(ICache[(address & 0xFFC) >> 2].TV != address)
 	{
 		ReadAbsorb[ReadAbsorbWhich] = 0;
@@ -394,8 +518,17 @@ INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 addre
 		// FIXME: Handle executing out of scratchpad.
 		if(address >= 0xA0000000 || !(BIU & 0x800))
 		{
+			__UncachedDecoded *ud = &Uncached_Decoded[(address >> 2) & 0xFF];
+
 			instr = LoadU32_LE((uint32_t *)&FastMap[address >> FAST_MAP_SHIFT][address]);
 
+			if(MDFN_UNLIKELY(ud->instr != instr))
+			{
+				ud->instr = instr;
+				DecodeInstr(&ud->dec, instr);
+			}
+			dec = &ud->dec;
+
 			if (!psx_cpu_overclock)
 			{
 				// Approximate best-case cache-disabled time, per PS1 tests
@@ -426,22 +559,22 @@ INLINE uint32 PS_CPU::ReadInstruction(pscpu_timestamp_t &timestamp, uint32 addre
 				if (!psx_cpu_overclock)
 					timestamp++;
 				ICI[0x00].TV &= ~0x2;
-				ICI[0x00].Data = LoadU32_LE(&FMP[0]);
+				SetICacheData(((address & 0xFF0) >> 2) + 0, LoadU32_LE(&FMP[0]));
 			case 0x4:
 				if (!psx_cpu_overclock)
 					timestamp++;
 				ICI[0x01].TV &= ~0x2;
-				ICI[0x01].Data = LoadU32_LE(&FMP[1]);
+				SetICacheData(((address & 0xFF0) >> 2) + 1, LoadU32_LE(&FMP[1]));
 			case 0x8:
 				if (!psx_cpu_overclock)
 					timestamp++;
 				ICI[0x02].TV &= ~0x2;
-				ICI[0x02].Data = LoadU32_LE(&FMP[2]);
+				SetICacheData(((address & 0xFF0) >> 2) + 2, LoadU32_LE(&FMP[2]));
 			case 0xC:
 				if (!psx_cpu_overclock)
 					timestamp++;
 				ICI[0x03].TV &= ~0x2;
-				ICI[0x03].Data = LoadU32_LE(&FMP[3]);
+				SetICacheData(((address & 0xFF0) >> 2) + 3, LoadU32_LE(&FMP[3]));
 				break;
 			}
 			instr = ICache[(address & 0xFFC) >> 2].Data;
@@ -510,7 +643,9 @@ uint32_t PS_CPU::Exception(uint32_t code, uint32_t PC, const uint32 NP, const ui
 #define GPR_RES(n) { unsigned tn = (n); ReadAbsorb[tn] = 0; }
 #define GPR_DEPRES_END ReadAbsorb[0] = back; }
 
-template<bool DebugMode>
+// With BlockStep, returns as soon as the CPU is at an instruction boundary outside of any branch or load
+// delay slot, so that RunJIT() can take over again; events are then left to the caller.
+template<bool DebugMode, bool BlockStep>
 int32_t PS_CPU::RunReal(int32_t timestamp_in)
 {
    uint32_t PC;
@@ -534,6 +669,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
       {
          uint32_t instr;
          uint32_t opf;
+         const __ICacheDecoded *dec;
 
          // Zero must be zero...until the Master Plan is enacted.
          GPR[0] = 0;
@@ -569,7 +705,7 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
             goto OpDone;
          }
 
-		 instr = ReadInstruction(timestamp, PC);
+		 instr = ReadInstruction(timestamp, PC, dec);
 
 
          //printf("PC=%08x, SP=%08x - op=0x%02x - funct=0x%02x - instr=0x%08x\n", PC, GPR[29], instr >> 26, instr & 0x3F, instr);
@@ -578,14 +714,9 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
          //printf("\n");
 
 		 //
-		 // Instruction decode
+		 // Instruction decode(done by ReadInstruction(), see DecodeInstr())
 		 //
-         opf = instr & 0x3F;
-
-         if(instr & (0x3F << 26))
-            opf = 0x40 | (instr >> 26);
-
-         opf |= IPCache;
+         opf = dec->opf | IPCache;
 
          if(ReadAbsorb[ReadAbsorbWhich])
             ReadAbsorb[ReadAbsorbWhich]--;
@@ -607,10 +738,10 @@ int32_t PS_CPU::RunReal(int32_t timestamp_in)
 	}
 
 
-   #define ITYPE uint32 rs MDFN_NOWARN_UNUSED = (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = (instr >> 16) & 0x1F; uint32 immediate = (int32)(int16)(instr & 0xFFFF); /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
-   #define ITYPE_ZE uint32 rs MDFN_NOWARN_UNUSED = (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = (instr >> 16) & 0x1F; uint32 immediate = instr & 0xFFFF; /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
+   #define ITYPE uint32 rs MDFN_NOWARN_UNUSED = dec->rs; uint32 rt MDFN_NOWARN_UNUSED = dec->rt; uint32 immediate = (int32)dec->immediate; /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
+   #define ITYPE_ZE uint32 rs MDFN_NOWARN_UNUSED = dec->rs; uint32 rt MDFN_NOWARN_UNUSED = dec->rt; uint32 immediate = (uint16)dec->immediate; /*printf(" rs=%02x(%08x), rt=%02x(%08x), immediate=(%08x) ", rs, GPR[rs], rt, GPR[rt], immediate);*/
    #define JTYPE uint32 target = instr & ((1 << 26) - 1); /*printf(" target=(%08x) ", target);*/
-   #define RTYPE uint32 rs MDFN_NOWARN_UNUSED = (instr >> 21) & 0x1F; uint32 rt MDFN_NOWARN_UNUSED = (instr >> 16) & 0x1F; uint32 rd MDFN_NOWARN_UNUSED = (instr >> 11) & 0x1F; uint32 shamt MDFN_NOWARN_UNUSED = (instr >> 6) & 0x1F; /*printf(" rs=%02x(%08x), rt=%02x(%08x), rd=%02x(%08x) ", rs, GPR[rs], rt, GPR[rt], rd, GPR[rd]);*/
+   #define RTYPE uint32 rs MDFN_NOWARN_UNUSED = dec->rs; uint32 rt MDFN_NOWARN_UNUSED = dec->rt; uint32 rd MDFN_NOWARN_UNUSED = dec->rd; uint32 shamt MDFN_NOWARN_UNUSED = dec->shamt; /*printf(" rs=%02x(%08x), rt=%02x(%08x), rd=%02x(%08x) ", rs, GPR[rs], rt, GPR[rt], rd, GPR[rd]);*/
 
 #if !defined(__GNUC__) || defined(NO_COMPUTED_GOTO)
    /* (uint8) cast for cheaper alternative to generated branch+compare bounds check instructions, but still more
@@ -2424,7 +2555,12 @@ OpDone: ;
 SkipNPCStuff:	;
 
                //printf("\n");
+         if(BlockStep && (new_PC_mask & 3) && LDWhich == 0x20 && !IPCache)
+            break;
       }
+
+      if(BlockStep)
+         break;
    } while(MDFN_LIKELY(PSX_EventHandler(timestamp)));
 
    if(gte_ts_done > 0)
@@ -2440,13 +2576,302 @@ SkipNPCStuff:	;
 
 int32_t PS_CPU::Run(int32_t timestamp_in)
 {
+   PSX_PROFILE(PSX_PROF_CPU);
+   int32_t timestamp;
+
 #ifdef HAVE_DEBUG
    if(CPUHook || ADDBT)
-      return(RunReal<true>(timestamp_in));
+      timestamp = RunReal<true, false>(timestamp_in);
+   else
 #endif
-   return(RunReal<false>(timestamp_in));
+#ifdef HAVE_JIT
+   if(psx_cpu_dynarec)
+      timestamp = RunJIT(timestamp_in);
+   else
+#endif
+      timestamp = RunReal<false, false>(timestamp_in);
+
+   PSX_PROFILE_CYCLES(PSX_PROF_CPU, timestamp - timestamp_in);
+
+   return(timestamp);
+}
+
+#ifdef HAVE_JIT
+//
+// Block recompiler.  Straight-line runs of code in RAM and BIOS are translated with decomp_block() and
+// run natively against a copy of the register file; everything the blocks can't express(exceptions,
+// interrupts, COP0, MULT/DIV, load delay hazards, unaligned loads/stores) is left to the interpreter,
+// which RunJIT() steps until the CPU is back at a clean instruction boundary.
+//
+// Block timing is one cycle per instruction plus memory and GTE stalls; instruction fetch and the
+// I-cache aren't modelled.
+//
+void PS_CPU::JIT_Flush(void)
+{
+   unsigned i;
+
+   if(!jit_cache)
+      return;
+
+   for(i = 0; i < JIT_CACHE_SIZE; i++)
+   {
+      jit_cache[i].pc = 1;	// Never a valid PC.
+      jit_cache[i].count = 0;
+      jit_cache[i].code = NULL;
+   }
+
+   memset(CodePages, 0, sizeof(CodePages));
+
+   // Frees all generated code.
+   decomp_kill();
+   decomp_init();
 }
 
+// Drops every block translated from the code page at physical address "base".  Blocks never straddle a page,
+// and all of a page's KUSEG/KSEG0/KSEG1 aliases fall in the same run of cache slots.
+void PS_CPU::JIT_InvalidatePage(uint32_t base)
+{
+   JITBlock *block;
+   unsigned i;
+
+   if(!jit_cache)
+      return;
+
+   block = &jit_cache[(base >> 2) & (JIT_CACHE_SIZE - 1)];
+
+   for(i = 0; i < (1U << CODE_PAGE_SHIFT) >> 2; i++, block++)
+   {
+      if(CodePageIndex(block->pc & addr_mask[block->pc >> 29]) == CodePageIndex(base))
+      {
+         block->pc = 1;
+         block->count = 0;
+         block->code = NULL;
+      }
+   }
+}
+
+INLINE int32_t PS_CPU::JIT_Now(void)
+{
+   // Blocks store the PC of each instruction in jit_state before running it.
+   return jit_timestamp + ((jit_state.pc - jit_block_pc) >> 2) + 1;
+}
+
+void PS_CPU::JIT_Store(unsigned bits, uint32_t address, uint32_t value)
+{
+   const int32_t now = JIT_Now();
+   int32_t timestamp = now;
+
+   if(bits == 8)
+      WriteMemory<uint8>(timestamp, address, value);
+   else if(bits == 16)
+      WriteMemory<uint16>(timestamp, address, value);
+   else
+      WriteMemory<uint32>(timestamp, address, value);
+
+   jit_timestamp += timestamp - now;
+}
+
+uint32_t PS_CPU::JIT_Load(unsigned bits, uint32_t address)
+{
+   const int32_t now = JIT_Now();
+   int32_t timestamp = now;
+   uint32_t ret;
+
+   if(bits == 8)
+      ret = ReadMemory<uint8>(timestamp, address);
+   else if(bits == 16)
+      ret = ReadMemory<uint16>(timestamp, address);
+   else
+      ret = ReadMemory<uint32>(timestamp, address);
+
+   jit_timestamp += timestamp - now;
+
+   return ret;
+}
+
+uint32_t PS_CPU::JIT_ReadCop(unsigned cop, unsigned reg, bool control)
+{
+   const int32_t now = JIT_Now();
+
+   assert(cop == 2);
+
+   if(now < gte_ts_done)
+      jit_timestamp += gte_ts_done - now;
+
+   return control ? GTE_ReadCR(reg) : GTE_ReadDR(reg);
+}
+
+void PS_CPU::JIT_WriteCop(unsigned cop, unsigned reg, bool control, uint32_t value)
+{
+   const int32_t now = JIT_Now();
+
+   assert(cop == 2);
+
+   if(now < gte_ts_done)
+      jit_timestamp += gte_ts_done - now;
+
+   if(control)
+      GTE_WriteCR(reg, value);
+   else
+      GTE_WriteDR(reg, value);
+}
+
+void PS_CPU::JIT_CopFun(unsigned cop, uint32_t cofun)
+{
+   int32_t timestamp = JIT_Now();
+
+   assert(cop == 2);
+
+   if(timestamp < gte_ts_done)
+   {
+      jit_timestamp += gte_ts_done - timestamp;
+      timestamp = gte_ts_done;
+   }
+
+   gte_ts_done = timestamp + GTE_Instruction((0x12 << 26) | (1 << 25) | cofun);
+}
+
+void PS_CPU::JIT_Branch(uint32_t target)
+{
+   jit_branch_taken = true;
+   jit_branch_target = target;
+}
+
+const PS_CPU::JITBlock *PS_CPU::JIT_Lookup(uint32_t pc)
+{
+   JITBlock *block = &jit_cache[(pc >> 2) & (JIT_CACHE_SIZE - 1)];
+   const uint32_t *code = (const uint32_t *)&FastMap[pc >> FAST_MAP_SHIFT][pc];
+   uint32_t words[DECOMP_MAX_BLOCK_INSTS];
+   unsigned max_count;
+   unsigned count;
+   unsigned i;
+
+   // Writes to the page(CheckCodeWrite()) evict its blocks, so a hit is always current.
+   if(block->pc == pc)
+      return block->count ? block : NULL;
+
+   if(decomp_full())
+      JIT_Flush();
+
+   // Don't run off the end of a page; what follows may be mapped elsewhere, or not be code at all.
+   max_count = (0x1000 - (pc & 0xFFF)) >> 2;
+   if(max_count > DECOMP_MAX_BLOCK_INSTS)
+      max_count = DECOMP_MAX_BLOCK_INSTS;
+
+   for(i = 0; i < max_count; i++)
+      words[i] = LoadU32_LE(&code[i]);
+
+   block->pc = pc;
+   block->code = decomp_block(pc, words, max_count, &count);
+   block->count = block->code ? count : 0;
+   block->ends_in_branch = block->count >= 2 && decomp_is_branch(words[block->count - 2]);
+
+   // Untranslatable code is remembered too, so it has to be forgotten on writes all the same.
+   MarkCodePage(pc & addr_mask[pc >> 29]);
+
+   return block->count ? block : NULL;
+}
+
+int32_t PS_CPU::JIT_Execute(const JITBlock *block, int32_t timestamp)
+{
+   // The block may evict itself by storing to its own page, so take what's needed up front.
+   const uint32_t block_pc = block->pc;
+   const unsigned count = block->count;
+   const bool ends_in_branch = block->ends_in_branch;
+   const decomp_block_t code = block->code;
+   unsigned executed = count;
+
+   memcpy(jit_state.reg, GPR, sizeof(jit_state.reg));
+   jit_state.reg[0] = 0;
+   jit_state.hi = HI;
+   jit_state.lo = LO;
+   jit_state.bail = 0;
+
+   jit_block_pc = block_pc;
+   jit_branch_taken = false;
+   jit_timestamp = timestamp;
+
+   gte_ts_done += timestamp;
+
+   // MULT/DIV are never translated, so rather than tracking the unit per instruction, wait out any
+   // operation still in flight before the block starts.
+   if(muldiv_ts_done > 0)
+   {
+      jit_timestamp += muldiv_ts_done;
+      muldiv_ts_done = 0;
+   }
+
+   code((uint32_t *)&jit_state);
+
+   memcpy(GPR, jit_state.reg, sizeof(jit_state.reg));
+   HI = jit_state.hi;
+   LO = jit_state.lo;
+
+   BACKED_new_PC = 4;
+   BACKED_new_PC_mask = ~0U;
+
+   if(jit_state.bail)
+   {
+      // The instruction at jit_state.pc didn't run; the interpreter will redo it(and raise the exception).
+      executed = (jit_state.pc - block_pc) >> 2;
+      BACKED_PC = jit_state.pc;
+
+      if(ends_in_branch && executed == count - 1)
+      {
+         BACKED_new_PC = jit_branch_taken ? jit_branch_target : 4;
+         BACKED_new_PC_mask = jit_branch_taken ? 0 : ~3U;
+      }
+   }
+   else if(jit_branch_taken)
+      BACKED_PC = jit_branch_target;
+   else
+      BACKED_PC = block_pc + (count << 2);
+
+   timestamp = jit_timestamp + executed;
+
+   if(gte_ts_done > 0)
+      gte_ts_done -= timestamp;
+
+   return timestamp;
+}
+
+int32_t PS_CPU::RunJIT(int32_t timestamp_in)
+{
+   int32_t timestamp = timestamp_in;
+
+   if(!jit_cache)
+   {
+      jit_cache = (JITBlock *)calloc(JIT_CACHE_SIZE, sizeof(JITBlock));
+      jit_code_copy = (uint8_t *)malloc(CODE_PAGE_COUNT << CODE_PAGE_SHIFT);
+      JIT_Flush();
+   }
+
+   do
+   {
+      while(MDFN_LIKELY(timestamp < next_event_ts))
+      {
+         const uint32_t pc = BACKED_PC;
+         const uint32_t phys = pc & addr_mask[pc >> 29];
+         const JITBlock *block = NULL;
+
+         // Blocks can only be entered at a clean instruction boundary, with no interrupt pending, the
+         // cache not isolated, and executing out of RAM or BIOS.  PGXP needs to see every instruction.
+         if(!IPCache && BACKED_new_PC_mask == ~0U && BACKED_LDWhich == 0x20 && !(CP0.SR & 0x10000) && !(pc & 3)
+               && (phys < 0x00800000 || (phys >= 0x1FC00000 && phys < 0x1FC80000))
+               && !(PGXP_GetModes() & (PGXP_MODE_MEMORY | PGXP_MODE_CPU | PGXP_MODE_GTE)))
+            block = JIT_Lookup(pc);
+
+         if(block)
+            timestamp = JIT_Execute(block, timestamp);
+         else
+            timestamp = RunReal<false, true>(timestamp);
+      }
+   } while(MDFN_LIKELY(PSX_EventHandler(timestamp)));
+
+   return(timestamp);
+}
+#endif
+
 void PS_CPU::SetCPUHook(void (*cpuh)(const int32_t timestamp, uint32_t pc), void (*addbt)(uint32_t from, uint32_t to, bool exception))
 {
    ADDBT = addbt;
@@ -2568,15 +2993,12 @@ void PS_CPU::PokeMem32(uint32 A, uint32 V)
 // FIXME: should we breakpoint on an illegal address?  And with LWC2/SWC2 if CP2 isn't enabled?
 void PS_CPU::CheckBreakpoints(void (*callback)(bool write, uint32_t address, unsigned int len), uint32_t instr)
 {
-   uint32 opf;
-
-   opf = instr & 0x3F;
-
-   if(instr & (0x3F << 26))
-      opf = 0x40 | (instr >> 26);
+   __ICacheDecoded decoded;
+   const __ICacheDecoded *dec = &decoded;
 
+   DecodeInstr(&decoded, instr);
 
-   switch(opf)
+   switch(dec->opf)
    {
       default:
          break;
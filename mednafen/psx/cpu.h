@@ -3,9 +3,17 @@
 
 #include "gte.h"
 
+#ifdef HAVE_JIT
+#include "decomp.h"
+#endif
+
 #define FAST_MAP_SHIFT        16
 #define FAST_MAP_PSIZE        (1 << FAST_MAP_SHIFT)
 
+// Granularity of the code page map; 2MiB of RAM followed by 512KiB of BIOS.
+#define CODE_PAGE_SHIFT       12
+#define CODE_PAGE_COUNT       ((2048 + 512) >> (CODE_PAGE_SHIFT - 10))
+
 #define CP0REG_BPC            3   /* PC breakpoint address */
 #define CP0REG_BDA            5   /* Data load/store breakpoint address */
 #define CP0REG_TAR            6   /* Target address */
@@ -72,6 +80,30 @@ class PS_CPU
 
       int StateAction(StateMem *sm, int load, int data_only);
 
+      // Writes to RAM from inside the emulator that bypass the CPU(DMA, EXE loading, cheats, debugger pokes) must be
+      // reported here, so that translated code for the pages they touch is thrown away.  Physical addresses.
+      INLINE void CheckCodeWrite(uint32_t address)
+      {
+         if(MDFN_UNLIKELY(address < 0x00800000 && ((CodePages[(address >> 17) & 0xF] >> ((address >> CODE_PAGE_SHIFT) & 0x1F)) & 1)))
+            InvalidateCodePage((address & 0x1FFFFF) >> CODE_PAGE_SHIFT);
+      }
+
+      void InvalidateCode(uint32_t address, uint32_t length);
+
+      // The frontend can write to RAM(retro_get_memory_data()) between frames without telling anyone; call before
+      // each frame to throw away translated code for pages that no longer hold what it was translated from.
+      void CheckCodePages(void);
+
+#ifdef HAVE_JIT
+      // Services for recompiled blocks(see decomp.cpp).  Only valid while a block is running.
+      void JIT_Store(unsigned bits, uint32_t address, uint32_t value);
+      uint32_t JIT_Load(unsigned bits, uint32_t address);
+      uint32_t JIT_ReadCop(unsigned cop, unsigned reg, bool control);
+      void JIT_WriteCop(unsigned cop, unsigned reg, bool control, uint32_t value);
+      void JIT_CopFun(unsigned cop, uint32_t cofun);
+      void JIT_Branch(uint32_t target);
+#endif
+
    private:
 
       uint32_t GPR[32 + 1];	// GPR[32] Used as dummy in load delay simulation(indexing past the end of real GPR)
@@ -109,6 +141,48 @@ class PS_CPU
          uint32_t ICache_Bulk[2048];
       };
 
+      // What RunReal() needs of an instruction word besides the word itself:  its dispatch index and operand fields,
+      // decoded once when the word enters the I-cache rather than on every fetch.  Every write to ICache[].Data goes
+      // through SetICacheData(), so an entry never disagrees with its word whatever happens to the tags.
+      struct __ICacheDecoded
+      {
+         uint8_t opf;	// Dispatch index(see RunReal())
+         uint8_t rs;
+         uint8_t rt;
+         uint8_t rd;
+         uint8_t shamt;
+         int16_t immediate;
+      };
+
+      __ICacheDecoded ICache_Decoded[1024];
+
+      // Words fetched around the I-cache(KSEG1, or with it disabled) are read from memory every time, but a loop
+      // fetches the same ones over and over; keep the last word seen at each slot and its decoding.  Decoding
+      // depends on nothing but the word, so an entry is good for whatever address it's used for.
+      struct __UncachedDecoded
+      {
+         uint32_t instr;
+         __ICacheDecoded dec;
+      };
+
+      __UncachedDecoded Uncached_Decoded[256];
+
+      static INLINE void DecodeInstr(__ICacheDecoded *d, uint32_t instr)
+      {
+         d->opf = (instr & (0x3F << 26)) ? (0x40 | (instr >> 26)) : (instr & 0x3F);
+         d->rs = (instr >> 21) & 0x1F;
+         d->rt = (instr >> 16) & 0x1F;
+         d->rd = (instr >> 11) & 0x1F;
+         d->shamt = (instr >> 6) & 0x1F;
+         d->immediate = (int16_t)(instr & 0xFFFF);
+      }
+
+      INLINE void SetICacheData(unsigned index, uint32_t instr)
+      {
+         ICache[index].Data = instr;
+         DecodeInstr(&ICache_Decoded[index], instr);
+      }
+
 
       struct
       {
@@ -149,17 +223,51 @@ class PS_CPU
       uint8_t *FastMap[1 << (32 - FAST_MAP_SHIFT)];
       uint8_t DummyPage[FAST_MAP_PSIZE];
 
+      // One bit per page of RAM/BIOS that translated code was built from.
+      uint32_t CodePages[CODE_PAGE_COUNT / 32];
+      static int CodePageIndex(uint32_t address);
+      static uint32_t CodePageAddress(unsigned page);
+      void MarkCodePage(uint32_t address);
+      void InvalidateCodePage(unsigned page);
+
 
       uint32_t Exception(uint32_t code, uint32_t PC, const uint32_t NP, const uint32_t NPM, const uint32_t instr) MDFN_WARN_UNUSED_RESULT;
 
-      template<bool DebugMode> int32_t RunReal(int32_t timestamp_in);
+      template<bool DebugMode, bool BlockStep> int32_t RunReal(int32_t timestamp_in);
+
+#ifdef HAVE_JIT
+      #define JIT_CACHE_SIZE 8192
+
+      struct JITBlock
+      {
+         uint32_t pc;
+         uint32_t count;		// 0 if the code at pc couldn't be translated.
+         decomp_block_t code;
+         bool ends_in_branch;	// Last instruction is a branch delay slot.
+      };
+
+      JITBlock *jit_cache;
+      uint8_t *jit_code_copy;	// What each page in CodePages held when it was marked, for CheckCodePages().
+      state_t jit_state;
+      uint32_t jit_block_pc;
+      int32_t jit_timestamp;
+      bool jit_branch_taken;
+      uint32_t jit_branch_target;
+
+      int32_t RunJIT(int32_t timestamp_in);
+      const JITBlock *JIT_Lookup(uint32_t pc);
+      int32_t JIT_Execute(const JITBlock *block, int32_t timestamp);
+      int32_t JIT_Now(void);
+      void JIT_Flush(void);
+      void JIT_InvalidatePage(uint32_t base);
+#endif
 
       template<typename T> T PeekMemory(uint32_t address) MDFN_COLD;
       template<typename T> void PokeMemory(uint32 address, T value) MDFN_COLD;
       template<typename T> T ReadMemory(int32_t &timestamp, uint32_t address, bool DS24 = false, bool LWC_timing = false);
       template<typename T> void WriteMemory(int32_t &timestamp, uint32_t address, uint32_t value, bool DS24 = false);
 
-      uint32 ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address);
+      uint32 ReadInstruction(pscpu_timestamp_t &timestamp, uint32 address, const __ICacheDecoded *&dec);
 
       // Mednafen debugger stuff follows:
    public:
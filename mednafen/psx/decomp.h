@@ -0,0 +1,36 @@
+#ifndef __MDFN_PSX_DECOMP_H
+#define __MDFN_PSX_DECOMP_H
+
+#include <stdint.h>
+
+// Register file handed to recompiled blocks.  The offsets of pc, hi and lo
+// are baked into the code generated from insts.td, so don't reorder.
+typedef struct state_s {
+	uint32_t reg[32];
+	uint32_t pc;
+	uint32_t hi, lo;
+	uint32_t bail;	// Set when the block returned early, before executing the instruction at pc.
+} state_t;
+
+typedef void (*decomp_block_t)(uint32_t *state);
+
+// Longest run of instructions translated into a single block.
+#define DECOMP_MAX_BLOCK_INSTS 64
+
+void decomp_init(void);
+void decomp_kill(void);
+
+// True once enough code has been generated that the caller should drop every
+// cached block and call decomp_init() again to release it.
+bool decomp_full(void);
+
+// True for jumps and branches, i.e. instructions followed by a delay slot.
+bool decomp_is_branch(uint32_t inst);
+
+// Translates the basic block starting at "pc", whose instruction words are at
+// "code"(at most "max_count" of them).  On success, *count is set to the
+// number of instructions covered, including a trailing branch's delay slot.
+// Returns NULL if the first instruction can't be translated.
+decomp_block_t decomp_block(uint32_t pc, const uint32_t *code, unsigned max_count, unsigned *count);
+
+#endif
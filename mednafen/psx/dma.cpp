@@ -297,6 +297,10 @@ static INLINE void RunChannelI(const unsigned ch, const uint32_t CRModeCache, in
 
 static INLINE void RunChannel(int32_t timestamp, int32_t clocks, int ch)
 {
+   // The SPU runs behind the rest of the system, so catch it up before moving anything to or from it.
+   if(ch == 4 && (DMACH[ch].WordCounter || (DMACH[ch].ChanControl & (1 << 24))))
+      CDC->SyncSPU(timestamp);
+
    // Mask out the bits that the DMA controller will modify during the course of operation.
    uint32_t CRModeCache = DMACH[ch].ChanControl &~(0x11 << 24);
    uint32_t crmodecache = CRModeCache;
@@ -437,7 +441,13 @@ static INLINE void RunChannel(int32_t timestamp, int32_t clocks, int ch)
             ChRW(ch, CRModeCache, DMACH[ch].CurAddr, &vtmp, &voffs);
 
             if(!(CRModeCache & 0x1))
-               MainRAM.WriteU32((DMACH[ch].CurAddr + (voffs << 2)) & 0x1FFFFC, vtmp);
+            {
+               const uint32_t waddr = (DMACH[ch].CurAddr + (voffs << 2)) & 0x1FFFFC;
+
+               CPU->CheckCodeWrite(waddr);
+               PSX_MarkRAMDirty(waddr);
+               MainRAM.WriteU32(waddr, vtmp);
+            }
          }
 
          if(CRModeCache & 0x2)
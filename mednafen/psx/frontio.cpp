@@ -20,6 +20,7 @@
 #include <compat/msvc.h>
 
 #include "../video/surface.h"
+#include "../AsyncFileWriter.h"
 #include "input/gamepad.h"
 #include "input/dualanalog.h"
 #include "input/dualshock.h"
@@ -98,7 +99,7 @@ INLINE void InputDevice::DrawCrosshairs(uint32 *pixels, const MDFN_PixelFormat*
          int r, g, b, a;
          int nr, ng, nb;
 
-         format->DecodeColor(pixels[x], r, g, b, a);
+         format->DecodeColor(format->ReadPixel(pixels, x), r, g, b, a);
 
          nr = (r + chair_r * 3) >> 2;
          ng = (g + chair_g * 3) >> 2;
@@ -120,7 +121,7 @@ INLINE void InputDevice::DrawCrosshairs(uint32 *pixels, const MDFN_PixelFormat*
             }
          }
 
-         pixels[x] = MAKECOLOR(nr, ng, nb, a);
+         format->WritePixel(pixels, x, MAKECOLOR(nr, ng, nb, a));
       }
    }
 }
@@ -352,6 +353,8 @@ FrontIO::FrontIO(bool emulate_memcards_[8], bool emulate_multitap_[2])
    for(i = 0; i < 2; i++)
       DevicesTap[i] = new InputDevice_Multitap();
 
+   MemcardWriter = new AsyncFileWriter();
+
    MapDevicesToPorts();
 }
 
@@ -372,6 +375,15 @@ void FrontIO::SetCrosshairsColor(unsigned port, uint32_t color)
 FrontIO::~FrontIO()
 {
    int i;
+
+   // Before the memcards go away, so that the last saves' completions find them.
+   if(MemcardWriter)
+   {
+      FlushMemcardSaves();
+      delete MemcardWriter;
+   }
+   MemcardWriter = NULL;
+
    for(i = 0; i < 8; i++)
    {
       if(Devices[i])
@@ -908,17 +920,59 @@ void FrontIO::SaveMemcard(unsigned int which, const char *path)
 
  if(DevicesMC[which]->GetNVSize() && DevicesMC[which]->GetNVDirtyCount())
  {
-  FileStream mf(path, MODE_WRITE);	// TODO: MODE_WRITE_ATOMIC_OVERWRITE
-
   DevicesMC[which]->ReadNV(DevicesMC[which]->GetNVData(), 0, (1 << 17));
-  mf.write(DevicesMC[which]->GetNVData(), (1 << 17));
 
-  mf.close();	// Call before resetting the NV dirty count!
-
-  DevicesMC[which]->ResetNVDirtyCount();
+  if(MDFN_WriteFileAtomic(path, DevicesMC[which]->GetNVData(), (1 << 17)))
+   DevicesMC[which]->ResetNVDirtyCount();
  }
 }
 
+// The tag handed to MemcardWriter is the card number in the low 3 bits, and the card's dirty count at the time of the
+// snapshot above that.
+void FrontIO::QueueMemcardSave(unsigned int which, const char *path)
+{
+   uint64_t dirty_count;
+   std::vector<uint8> snapshot;
+
+   assert(which < 8);
+
+   dirty_count = DevicesMC[which]->GetNVDirtyCount();
+
+   if(!DevicesMC[which]->GetNVSize() || !dirty_count)
+      return;
+
+   snapshot.resize(1 << 17);
+   DevicesMC[which]->ReadNV(&snapshot[0], 0, (1 << 17));
+
+   MemcardWriter->Write(path, &snapshot[0], snapshot.size(), which | (dirty_count << 3));
+}
+
+void FrontIO::PollMemcardSaves(void)
+{
+   uint64_t tag;
+   bool success;
+
+   while(MemcardWriter->GetCompleted(&tag, &success))
+   {
+      const unsigned which = tag & 7;
+
+      if(!success)
+         continue;
+
+      // Written to since the snapshot went out; leave it dirty so the newer data gets saved too.
+      if(DevicesMC[which]->GetNVDirtyCount() != (tag >> 3))
+         continue;
+
+      DevicesMC[which]->ResetNVDirtyCount();
+   }
+}
+
+void FrontIO::FlushMemcardSaves(void)
+{
+   MemcardWriter->Wait();
+   PollMemcardSaves();
+}
+
 bool FrontIO::RequireNoFrameskip(void)
 {
    unsigned i;
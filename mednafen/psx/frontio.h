@@ -2,6 +2,7 @@
 #define __MDFN_PSX_FRONTIO_H
 
 class InputDevice_Multitap;
+class AsyncFileWriter;
 
 class InputDevice
 {
@@ -77,6 +78,14 @@ class FrontIO
       void SaveMemcard(unsigned int which, const char *path); //, bool force_save = false);
       void SaveMemcard(unsigned int which);
 
+      // Snapshots a dirty memcard and has it written to "path" on a thread, so the caller doesn't wait on the disk.
+      // The card's dirty count is reset by a later PollMemcardSaves() once the file is written, unless the card has
+      // been written to since the snapshot.
+      void QueueMemcardSave(unsigned int which, const char *path);
+      void PollMemcardSaves(void);
+      // Waits for every queued save to be written, then does PollMemcardSaves().
+      void FlushMemcardSaves(void);
+
       int StateAction(StateMem* sm, int load, int data_only);
 
    private:
@@ -99,6 +108,7 @@ class FrontIO
       void *DeviceData[8];
 
       InputDevice *DevicesMC[8];
+      AsyncFileWriter *MemcardWriter;
 
       int32_t ClockDivider;
 
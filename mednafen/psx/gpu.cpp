@@ -23,6 +23,10 @@
 #include "../pgxp/pgxp_gpu.h"
 #include "../pgxp/pgxp_mem.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 /*
    GPU display timing master clock is nominally 53.693182 MHz for NTSC PlayStations, and 53.203425 MHz for PAL PlayStations.
 
@@ -70,6 +74,9 @@ static const int8 dither_table[4][4] =
 
 PS_GPU::PS_GPU(bool pal_clock_and_tv, int sls, int sle, uint8_t upscale_shift)
 {
+   vram = (uint16*)(this + 1);
+   vram_dirty = (uint8*)(vram + (512 * 1024 << (upscale_shift * 2)));
+
    HardwarePALType = pal_clock_and_tv;
 
    BuildDitherTable();
@@ -93,6 +100,15 @@ PS_GPU::PS_GPU(bool pal_clock_and_tv, int sls, int sle, uint8_t upscale_shift)
 
    this->upscale_shift = upscale_shift;
    this->dither_upscale_shift = 0;
+
+   ScanoutDirty = true;
+   ScanoutFull = true;
+   scanout_skipped = false;
+   memset(ScanoutParams, 0xFF, sizeof(ScanoutParams));
+   ScanoutX = 0;
+   ScanoutY = 0;
+   ScanoutW = 1024;
+   ScanoutH = 512;
 }
 
 PS_GPU::PS_GPU(const PS_GPU &g, uint8 ushift)
@@ -100,8 +116,18 @@ PS_GPU::PS_GPU(const PS_GPU &g, uint8 ushift)
    // Recopy the GPU state in the new buffer
    *this = g;
 
+   vram = (uint16*)(this + 1);
+   TimingOnly = false;
+#ifdef HAVE_THREADS
+   RenderThread = NULL;
+#endif
+
    // Override the upscaling factor
    upscale_shift = ushift;
+   vram_dirty = (uint8*)(vram + vram_npixels());
+
+   // It goes with a new surface.
+   ScanoutDirty = true;
 
    //For simplicity we do the transfer at 1x internal resolution.
    for (unsigned y = 0; y < 512; y++)
@@ -113,6 +139,9 @@ PS_GPU::PS_GPU(const PS_GPU &g, uint8 ushift)
 
 PS_GPU::~PS_GPU()
 {
+#ifdef HAVE_THREADS
+   StopRenderThread();
+#endif
 }
 
 void PS_GPU::BuildDitherTable()
@@ -139,13 +168,13 @@ void PS_GPU::BuildDitherTable()
 	}
 }
 
-// Allocate enough room for the PS_GPU class and VRAM
+// Allocate enough room for the PS_GPU class, VRAM and its dirty lines
 void *PS_GPU::Alloc(uint8 upscale_shift)
 {
   unsigned width = 1024 << upscale_shift;
   unsigned height = 512 << upscale_shift;
 
-  unsigned size = sizeof(PS_GPU) + width * height * sizeof(uint16_t);
+  unsigned size = sizeof(PS_GPU) + width * height * sizeof(uint16_t) + 512;
 
   char *buffer = new char[size];
 
@@ -290,7 +319,13 @@ void PS_GPU::SoftReset(void) // Control command 0x00
 
 void PS_GPU::Power(void)
 {
+#ifdef HAVE_THREADS
+   SyncRenderThread();
+#endif
+
    memset(vram, 0, vram_npixels() * sizeof(*vram));
+   memset(vram_dirty, 1, 512);
+   ScanoutDirty = true;
 
    memset(CLUT_Cache, 0, sizeof(CLUT_Cache));
    CLUT_Cache_VB = ~0U;
@@ -387,6 +422,10 @@ void PS_GPU::Power(void)
 
    IRQ_Assert(IRQ_VBLANK, InVBlank);
    TIMER_SetVBlank(InVBlank);
+
+#ifdef HAVE_THREADS
+   ResyncRenderThread();
+#endif
 }
 
 void PS_GPU::ResetTS(void)
@@ -399,6 +438,10 @@ void PS_GPU::ResetTS(void)
 #include "gpu_sprite.cpp"
 #include "gpu_line.cpp"
 
+#ifdef HAVE_THREADS
+#include "gpu_thread.cpp"
+#endif
+
 /* C-style function wrappers so our command table isn't so ginormous(in memory usage). */
 template<int numvertices, bool shaded, bool textured,
 	 int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
@@ -467,6 +510,8 @@ static void G_Command_FBFill(PS_GPU* gpu, const uint32 *cb)
    //printf("[GPU] FB Fill %d:%d w=%d, h=%d\n", destX, destY, width, height);
    gpu->DrawTimeAvail       -= 46; // Approximate
 
+   gpu->MarkVRAMWrite(destX, destY, width, height);
+
    for(y = 0; y < height; y++)
    {
       unsigned x;
@@ -477,6 +522,9 @@ static void G_Command_FBFill(PS_GPU* gpu, const uint32 *cb)
 
       gpu->DrawTimeAvail -= (width >> 3) + 9;
 
+      if(gpu->TimingOnly || gpu->RowSkip(d_y))
+         continue;
+
       for(x = 0; x < width; x++)
       {
          const int32 d_x = (x + destX) & 1023;
@@ -505,14 +553,18 @@ static void G_Command_FBCopy(PS_GPU* g, const uint32 *cb)
       height = 0x200;
 
    g->InvalidateTexCache();
+   g->MarkVRAMWrite(destX, destY, width, height);
    //printf("FB Copy: %d %d %d %d %d %d\n", sourceX, sourceY, destX, destY, width, height);
 
    g->DrawTimeAvail -= (width * height) * 2;
 
-   for(y = 0; y < height; y++)
+   for(y = 0; y < height && !g->TimingOnly; y++)
    {
       unsigned x;
 
+      if(g->RowSkip(y + destY))
+         continue;
+
       for(x = 0; x < width; x += 128)
       {
          const int32 chunk_x_max = std::min<int32>(width - x, 128);
@@ -561,6 +613,7 @@ static void G_Command_FBWrite(PS_GPU* g, const uint32 *cb)
    g->FBRW_CurY = g->FBRW_Y;
 
    g->InvalidateTexCache();
+   g->MarkVRAMWrite(g->FBRW_X, g->FBRW_Y, g->FBRW_W, g->FBRW_H);
 
    if(g->FBRW_W != 0 && g->FBRW_H != 0)
       g->InCmd = INCMD_FBWRITE;
@@ -799,6 +852,7 @@ CTEntry PS_GPU::Commands[256] =
 
 void PS_GPU::ProcessFIFO(uint32_t in_count)
 {
+   PSX_PROFILE(PSX_PROF_GPU_FIFO);
    uint32_t CB[0x10], InData;
    unsigned i;
    unsigned command_len;
@@ -820,10 +874,17 @@ void PS_GPU::ProcessFIFO(uint32_t in_count)
 
          for(i = 0; i < 2; i++)
          {
-            bool fetch = texel_fetch(FBRW_CurX & 1023, FBRW_CurY & 511) & MaskEvalAND;
+#ifdef HAVE_THREADS
+            if(RenderThread)
+               QueueFBWrite(FBRW_CurX & 1023, FBRW_CurY & 511, InData | MaskSetOR);
+            else
+#endif
+            {
+               bool fetch = texel_fetch(FBRW_CurX & 1023, FBRW_CurY & 511) & MaskEvalAND;
 
-            if (!fetch)
-               texel_put(FBRW_CurX & 1023, FBRW_CurY & 511, InData | MaskSetOR);
+               if (!fetch)
+                  texel_put(FBRW_CurX & 1023, FBRW_CurY & 511, InData | MaskSetOR);
+            }
 
             FBRW_CurX++;
             if(FBRW_CurX == (FBRW_X + FBRW_W))
@@ -887,11 +948,23 @@ void PS_GPU::ProcessFIFO(uint32_t in_count)
 	   CB[i] = BlitterFIFO.Read();
    }
 
-   if (!read_fifo)
-   {
-      if(!command->ss_cmd)
-         DrawTimeAvail -= 2;
+   if (!read_fifo && !command->ss_cmd)
+      DrawTimeAvail -= 2;
 
+#ifdef HAVE_THREADS
+   if(RenderThread)
+      QueueCommand(cc, CB, command_len, !read_fifo);
+#endif
+
+   ExecuteCommand(cc, CB, !read_fifo);
+}
+
+INLINE void PS_GPU::ExecuteCommand(uint32 cc, const uint32 *CB, bool first)
+{
+   const CTEntry *command = &Commands[cc];
+
+   if (first)
+   {
       // A very very ugly kludge to support
       // texture mode specialization.
       // fixme/cleanup/SOMETHING in the future.
@@ -910,6 +983,10 @@ void PS_GPU::ProcessFIFO(uint32_t in_count)
       G_Command_FBRead(this, CB);
    else
    {
+      // Polygons, lines and sprites stay within the drawing area.
+      if (cc >= 0x20 && cc <= 0x7F && ClipX1 >= ClipX0 && ClipY1 >= ClipY0)
+         MarkVRAMWrite(ClipX0, ClipY0, ClipX1 + 1 - ClipX0, ClipY1 + 1 - ClipY0);
+
 	   if (command->func[abr][TexMode])
 		   command->func[abr][TexMode | (MaskEvalAND ? 0x4 : 0x0)](this, CB);
    }
@@ -988,6 +1065,10 @@ void PS_GPU::Write(const int32_t timestamp, uint32_t A, uint32_t V)
              rsx_intf_set_draw_area(this->ClipX0, this->ClipY0,
                    this->ClipX1, this->ClipY1);
              UpdateDisplayMode();
+#ifdef HAVE_THREADS
+            // Too much of the drawing state is reset to replay it on the render thread.
+            ResyncRenderThread();
+#endif
             break;
 
          case 0x01:	// Reset command buffer
@@ -1079,6 +1160,8 @@ void PS_GPU::Write(const int32_t timestamp, uint32_t A, uint32_t V)
             break;
 
       }
+
+      UpdateScanoutArea();
    }
    else		// GP0 ("Data")
    {
@@ -1099,6 +1182,9 @@ INLINE uint32_t PS_GPU::ReadData(void)
 {
    if(InCmd == INCMD_FBREAD)
    {
+#ifdef HAVE_THREADS
+      SyncRenderThread();
+#endif
       DataReadBufferEx = 0;
       for(int i = 0; i < 2; i++)
       {
@@ -1191,27 +1277,116 @@ uint32_t PS_GPU::Read(const int32_t timestamp, uint32_t A)
    return(ret >> ((A & 3) * 8));
 }
 
-INLINE void PS_GPU::ReorderRGB_Var(uint32_t out_Rshift,
-      uint32_t out_Gshift, uint32_t out_Bshift,
-      bool bpp24, const uint16_t *src, uint32_t *dest,
-      const int32 dx_start, const int32 dx_end, int32 fb_x)
+// Scanout pixel conversion, to XRGB8888 or RGB565.  15bpp pixels come out as RGB565 exactly as the top bits of what the XRGB8888
+// path gives; "srcpix" is a VRAM pixel, or the 3 bytes of a 24bpp one(R in the low byte).
+static INLINE uint32 ScanoutColor15(uint32 srcpix, uint32 *)
+{
+   return MAKECOLOR((((srcpix >> 0) & 0x1F) << 3), (((srcpix >> 5) & 0x1F) << 3), (((srcpix >> 10) & 0x1F) << 3), 0);
+}
+
+static INLINE uint16 ScanoutColor15(uint32 srcpix, uint16 *)
+{
+   return ((srcpix & 0x1F) << 11) | ((srcpix & 0x3E0) << 1) | ((srcpix >> 10) & 0x1F);
+}
+
+static INLINE uint32 ScanoutColor24(uint32 srcpix, uint32 *)
+{
+   return (((srcpix >> 0) & 0xFF) << RED_SHIFT) | (((srcpix >> 8) & 0xFF) << GREEN_SHIFT) | (((srcpix >> 16) & 0xFF) << BLUE_SHIFT);
+}
+
+static INLINE uint16 ScanoutColor24(uint32 srcpix, uint16 *)
+{
+   return ((srcpix & 0xF8) << 8) | ((srcpix >> 5) & 0x7E0) | ((srcpix >> 19) & 0x1F);
+}
+
+#if defined(__SSE2__)
+// 8 pixels at a time of the above.
+static INLINE void ScanoutColor15_SSE2(const uint16 *src, uint32 *dest)
+{
+   const __m128i p = _mm_loadu_si128((const __m128i*)src);
+   const __m128i gb = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(p, 6), _mm_set1_epi16((int16)0xF800)),
+         _mm_and_si128(_mm_srli_epi16(p, 7), _mm_set1_epi16(0xF8)));
+   const __m128i r = _mm_and_si128(_mm_slli_epi16(p, 3), _mm_set1_epi16(0xF8));
+
+   _mm_storeu_si128((__m128i*)dest + 0, _mm_unpacklo_epi16(gb, r));
+   _mm_storeu_si128((__m128i*)dest + 1, _mm_unpackhi_epi16(gb, r));
+}
+
+static INLINE void ScanoutColor15_SSE2(const uint16 *src, uint16 *dest)
+{
+   const __m128i p = _mm_loadu_si128((const __m128i*)src);
+   const __m128i r = _mm_slli_epi16(p, 11);
+   const __m128i g = _mm_slli_epi16(_mm_and_si128(p, _mm_set1_epi16(0x3E0)), 1);
+   const __m128i b = _mm_and_si128(_mm_srli_epi16(p, 10), _mm_set1_epi16(0x1F));
+
+   _mm_storeu_si128((__m128i*)dest, _mm_or_si128(_mm_or_si128(r, g), b));
+}
+
+// 4 packed 24bpp pixels from the low 12 bytes of "v", one per 32-bit lane(with junk in the top byte).
+static INLINE __m128i Unpack24_SSE2(__m128i v)
+{
+   const __m128i ab = _mm_unpacklo_epi32(v, _mm_srli_si128(v, 3));
+   const __m128i cd = _mm_unpacklo_epi32(_mm_srli_si128(v, 6), _mm_srli_si128(v, 9));
+
+   return _mm_unpacklo_epi64(ab, cd);
+}
+
+static INLINE __m128i Convert24_SSE2(__m128i p, uint32 *)
+{
+   return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFF)), 16),
+            _mm_and_si128(p, _mm_set1_epi32(0xFF00))), _mm_and_si128(_mm_srli_epi32(p, 16), _mm_set1_epi32(0xFF)));
+}
+
+static INLINE __m128i Convert24_SSE2(__m128i p, uint16 *)
+{
+   const __m128i c = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8),
+            _mm_and_si128(_mm_srli_epi32(p, 5), _mm_set1_epi32(0x7E0))), _mm_and_si128(_mm_srli_epi32(p, 19), _mm_set1_epi32(0x1F)));
+
+   // Sign-extend so the saturating pack leaves the values alone.
+   return _mm_srai_epi32(_mm_slli_epi32(c, 16), 16);
+}
+
+// 8 pixels from the 24 bytes at "src"; reads 28.
+static INLINE void ScanoutColor24_SSE2(const uint8 *src, uint32 *dest)
 {
+   _mm_storeu_si128((__m128i*)dest + 0, Convert24_SSE2(Unpack24_SSE2(_mm_loadu_si128((const __m128i*)src)), dest));
+   _mm_storeu_si128((__m128i*)dest + 1, Convert24_SSE2(Unpack24_SSE2(_mm_loadu_si128((const __m128i*)(src + 12))), dest));
+}
+
+static INLINE void ScanoutColor24_SSE2(const uint8 *src, uint16 *dest)
+{
+   const __m128i lo = Convert24_SSE2(Unpack24_SSE2(_mm_loadu_si128((const __m128i*)src)), dest);
+   const __m128i hi = Convert24_SSE2(Unpack24_SSE2(_mm_loadu_si128((const __m128i*)(src + 12))), dest);
 
-  int32_t fb_mask = ((0x7FF << upscale_shift) + upscale() - 1);
+   _mm_storeu_si128((__m128i*)dest, _mm_packs_epi32(lo, hi));
+}
+#endif
+
+template<typename T>
+INLINE void PS_GPU::ReorderRGB_Var(bool bpp24, const uint16_t *src, T *dest, const int32 dx_start, const int32 dx_end, int32 fb_x)
+{
+   int32_t fb_mask = ((0x7FF << upscale_shift) + upscale() - 1);
+   int32 x = dx_start;
 
    if(bpp24)	// 24bpp
    {
-      for(int32 x = dx_start; x < dx_end; x+= upscale())
+#if defined(__SSE2__)
+      // "fb_x" is a byte offset into the line at native resolution; stay clear of where it wraps.
+      if(!upscale_shift)
+      {
+         for(; (x + 8) <= dx_end && (fb_x + 28) <= 2048; x += 8, fb_x += 24)
+            ScanoutColor24_SSE2((const uint8*)src + fb_x, dest + x);
+      }
+#endif
+
+      for(; x < dx_end; x+= upscale())
       {
          int i;
-         uint32_t color;
          uint32_t srcpix = src[(fb_x >> 1) + 0]
             | (src[((fb_x >> 1) + (1 << upscale_shift)) & fb_mask] << 16);
          srcpix >>= ((fb_x >> upscale_shift) & 1) * 8;
 
-         color =   (((srcpix >> 0) << RED_SHIFT)   & (0xFF << RED_SHIFT))
-            | (((srcpix >> 8) << GREEN_SHIFT) & (0xFF << GREEN_SHIFT))
-            | (((srcpix >> 16) << BLUE_SHIFT) & (0xFF << BLUE_SHIFT));
+         T color = ScanoutColor24(srcpix, dest);
 
          for (i = 0; i < upscale(); i++)
             dest[x + i] = color;
@@ -1221,28 +1396,125 @@ INLINE void PS_GPU::ReorderRGB_Var(uint32_t out_Rshift,
    }				// 15bpp
    else
    {
-      for(int32 x = dx_start; x < dx_end; x++)
+      // Runs of consecutive VRAM pixels, up to where the line wraps around.
+      const int32 line_pixels = (fb_mask + 1) >> 1;
+
+      while(x < dx_end)
       {
-         uint32_t srcpix = src[(fb_x >> 1)];
-         dest[x] = MAKECOLOR(
-               (((srcpix >> 0) & 0x1F) << 3),
-               (((srcpix >> 5) & 0x1F) << 3),
-               (((srcpix >> 10) & 0x1F) << 3),
-               0);
-
-         fb_x = (fb_x + 2) & fb_mask;
+         int32 run = std::min<int32>(dx_end - x, line_pixels - (fb_x >> 1));
+
+#if defined(__SSE2__)
+         for(; run >= 8; run -= 8, x += 8, fb_x += 16)
+            ScanoutColor15_SSE2(src + (fb_x >> 1), dest + x);
+#endif
+
+         for(; run > 0; run--, x++, fb_x += 2)
+            dest[x] = ScanoutColor15(src[fb_x >> 1], dest);
+
+         fb_x &= fb_mask;
       }
    }
 }
 
+// Outputs one visible line to "dest", as upscale() rows starting at VRAM row "y"; all the coordinates are upscaled.
+template<typename T>
+void PS_GPU::OutputRows(T *dest, uint32 pitch, uint32 y, int32 dx_start, int32 dx_end, int32 fb_x, uint32 dmw, bool bpp24)
+{
+   for (uint32_t i = 0; i < upscale(); i++, dest += pitch)
+   {
+      const uint16_t *src = vram + ((y + i) << (10 + upscale_shift));
+
+      memset(dest, 0, dx_start * sizeof(T));
+
+      if (rsx_intf_is_type() == RSX_SOFTWARE)
+         ReorderRGB_Var(
+               bpp24,
+               src,
+               dest,
+               dx_start,
+               dx_end,
+               fb_x);
+
+      for(uint32_t x = dx_end; x < dmw; x++)
+         dest[x] = 0;
+   }
+}
+
+// "dest" is uint16s(RGB565) if "rgb565" is set, uint32s(XRGB8888) otherwise; "pitch" is in pixels.
+void PS_GPU::OutputLine(void *dest, uint32 pitch, uint32 y, int32 dx_start, int32 dx_end, int32 fb_x, uint32 dmw, bool bpp24, bool rgb565)
+{
+   if(rgb565)
+      OutputRows((uint16*)dest, pitch, y, dx_start, dx_end, fb_x, dmw, bpp24);
+   else
+      OutputRows((uint32*)dest, pitch, y, dx_start, dx_end, fb_x, dmw, bpp24);
+}
+
+INLINE void PS_GPU::ScanoutLine(void *dest, uint32 pitch, uint32 y, int32 dx_start, int32 dx_end, int32 fb_x, uint32 dmw, bool bpp24, bool rgb565)
+{
+#ifdef HAVE_THREADS
+   if(RenderThread)
+   {
+      // Light guns look at the line as soon as it's out.
+      if(!PSX_GPULineHookNeedsPixels())
+      {
+         const uint32 entry[] = { RT_SCANOUT | (11 << 8), (uint32)(uintptr_t)dest, (uint32)((uint64)(uintptr_t)dest >> 32), pitch, y,
+            (uint32)dx_start, (uint32)dx_end, (uint32)fb_x, dmw, bpp24, rgb565 };
+
+         RT_Push(RenderThread, entry, 11);
+         return;
+      }
+
+      SyncRenderThread();
+   }
+#endif
+
+   OutputLine(dest, pitch, y, dx_start, dx_end, fb_x, dmw, bpp24, rgb565);
+}
+
+// Works out the VRAM area scanout reads from the display setup, when that changes.
+void PS_GPU::UpdateScanoutArea(void)
+{
+   static const uint32 DotClockRatios[5] = { 10, 8, 5, 4, 7 };
+   const uint32 dmc = (DisplayMode & 0x40) ? 4 : (DisplayMode & 0x3);
+   const uint32 params[] = { DisplayMode, DisplayOff, DisplayFB_XStart, DisplayFB_YStart, HorizStart, HorizEnd,
+      VertStart, VertEnd, (uint32)LineVisFirst, (uint32)LineVisLast };
+
+   if(!memcmp(params, ScanoutParams, sizeof(params)))
+      return;
+
+   memcpy(ScanoutParams, params, sizeof(params));
+   ScanoutDirty = true;
+
+   // As Update() works out the lines' extents, plus a little for the rounding.
+   ScanoutX = DisplayFB_XStart;
+   ScanoutW = 0;
+
+   if(HorizEnd > HorizStart)
+   {
+      ScanoutW = (HorizEnd - HorizStart) / DotClockRatios[dmc] + 2;
+
+      if(DisplayMode & DISP_RGB24)
+         ScanoutW = ScanoutW * 3 / 2 + 2;
+   }
+
+   ScanoutY = DisplayFB_YStart;
+   ScanoutH = 512;
+
+   if(VertEnd > VertStart)
+      ScanoutH = (VertEnd - VertStart) << (bool)(DisplayMode & DISP_INTERLACED);
+}
+
 int32_t PS_GPU::Update(const int32_t sys_timestamp)
 {
+   PSX_PROFILE(PSX_PROF_GPU_UPDATE);
    int32 gpu_clocks;
    static const uint32_t DotClockRatios[5] = { 10, 8, 5, 4, 7 };
    const uint32_t dmc = (DisplayMode & 0x40) ? 4 : (DisplayMode & 0x3);
    const uint32_t dmw = 2800 / DotClockRatios[dmc];	// Must be <= 768
    int32_t sys_clocks = sys_timestamp - lastts;
 
+   PSX_PROFILE_CYCLES(PSX_PROF_GPU_UPDATE, sys_clocks);
+
    //printf("GPUISH: %d\n", sys_timestamp - lastts);
 
    if(!sys_clocks)
@@ -1370,6 +1642,9 @@ int32_t PS_GPU::Update(const int32_t sys_timestamp)
 
                if(espec)
                {
+#ifdef HAVE_THREADS
+                  SyncRenderThread();
+#endif
                   if((bool)(DisplayMode & DISP_PAL) != HardwarePALType)
                   {
                      DisplayRect->x = 0;
@@ -1379,13 +1654,15 @@ int32_t PS_GPU::Update(const int32_t sys_timestamp)
 
                      for(int32 y = 0; y < DisplayRect->h; y++)
                      {
-                        uint32_t *dest = surface->pixels + y * surface->pitch32;
+                        uint8_t *dest = (uint8_t*)surface->pixels + y * surface->pitchinpix * (surface->format.bpp / 8);
 
                         LineWidths[y] = 384;
 
-                        memset(dest, 0, 384 * sizeof(int32));
+                        memset(dest, 0, 384 * (surface->format.bpp / 8));
                      }
 
+                     ScanoutDirty = true;
+
                      //char buffer[256];
                      //snprintf(buffer, sizeof(buffer), _("VIDEO STANDARD MISMATCH"));
                      //DrawTextTrans(surface->pixels + ((DisplayRect->h / 2) - (13 / 2)) * surface->pitch32, surface->pitch32 << 2, DisplayRect->w, (UTF8*)buffer,
@@ -1401,13 +1678,35 @@ int32_t PS_GPU::Update(const int32_t sys_timestamp)
                      DisplayRect->w = 0;
                      DisplayRect->h = VisibleLineCount << (bool)(DisplayMode & DISP_INTERLACED);
 
+                     // An image upload spanning frames keeps the area it covers dirty.
+                     UpdateScanoutArea();
+
+                     if(InCmd == INCMD_FBWRITE)
+                        MarkVRAMWrite(FBRW_X, FBRW_Y, FBRW_W, FBRW_H);
+
+                     ScanoutFull = ScanoutDirty || (DisplayMode & DISP_INTERLACED);
+                     ScanoutDirty = false;
+                     scanout_skipped = true;
+
                      // Clear ~0 state.
                      LineWidths[0] = 0;
 
                      for(int i = 0; i < (DisplayRect->y + DisplayRect->h); i++)
                      {
-                        surface->pixels[i * surface->pitch32 + 0] =
-                           surface->pixels[i * surface->pitch32 + 1] = 0;
+                        // Otherwise the surface still has this from the last frame.
+                        if(ScanoutFull)
+                        {
+                           if(surface->format.bpp == 16)
+                           {
+                              surface->pixels16[i * surface->pitchinpix + 0] =
+                                 surface->pixels16[i * surface->pitchinpix + 1] = 0;
+                           }
+                           else
+                           {
+                              surface->pixels[i * surface->pitch32 + 0] =
+                                 surface->pixels[i * surface->pitch32 + 1] = 0;
+                           }
+                        }
                         LineWidths[i] = 2;
                      }
                   }
@@ -1523,46 +1822,26 @@ int32_t PS_GPU::Update(const int32_t sys_timestamp)
                //printf("dx_start base: %d, dmw: %d\n", dx_start, dmw);
 
                {
-                  // Convert the necessary variables to the upscaled version
-                  uint32_t x;
-                  uint32_t y      = DisplayFB_CurLineYReadout << upscale_shift;
-                  uint32_t udmw   = dmw      << upscale_shift;
-                  int32 udx_start = dx_start << upscale_shift;
-                  int32 udx_end   = dx_end   << upscale_shift;
-                  int32 ufb_x     = fb_x     << upscale_shift;
-
-                  for (uint32_t i = 0; i < upscale(); i++)
+                  const uint32 line_bytes = surface->pitchinpix * (surface->format.bpp / 8);
+                  uint8_t *line = (uint8_t*)surface->pixels + (dest_line << upscale_shift) * line_bytes;
+
+                  // Nothing that shows on this line has changed since the last frame, so neither has the line.
+                  if(ScanoutFull || ScanoutDirty || PSX_GPULineHookNeedsPixels())
                   {
-                     const uint16_t *src = vram +
-                        ((y + i) << (10 + upscale_shift));
-
-                     // printf("surface: %dx%d (%d) %u %u + %u\n",
-                     // 	   surface->w, surface->h, surface->pitchinpix,
-                     // 	   dest_line, y, i);
-
-                     dest = surface->pixels +
-                        ((dest_line << upscale_shift) + i) * surface->pitch32;
-
-                     memset(dest, 0, udx_start * sizeof(int32));
-
-                     if (rsx_intf_is_type() == RSX_SOFTWARE)
-                        //printf("%d %d %d - %d %d\n", scanline, dx_start, dx_end, HorizStart, HorizEnd);
-                        ReorderRGB_Var(
-                              RED_SHIFT,
-                              GREEN_SHIFT,
-                              BLUE_SHIFT,
-                              DisplayMode & DISP_RGB24,
-                              src,
-                              dest,
-                              udx_start,
-                              udx_end,
-                              ufb_x);
-
-                     //printf("dx_end: %d, dmw: %d\n", udx_end, udmw);
-                     //
-                     for(x = udx_end; x < udmw; x++)
-                        dest[x] = 0;
+                     // Convert the necessary variables to the upscaled version
+                     ScanoutLine(line, surface->pitchinpix,
+                           DisplayFB_CurLineYReadout << upscale_shift,
+                           dx_start << upscale_shift,
+                           dx_end << upscale_shift,
+                           fb_x << upscale_shift,
+                           dmw << upscale_shift,
+                           DisplayMode & DISP_RGB24,
+                           surface->format.bpp == 16);
+
+                     scanout_skipped = false;
                   }
+
+                  dest = (uint32_t*)(line + (upscale() - 1) * line_bytes);
                }
 
                //if(scanline == 64)
@@ -1615,6 +1894,7 @@ TheEnd:
 void PS_GPU::StartFrame(EmulateSpecStruct *espec_arg)
 {
    sl_zero_reached = false;
+   scanout_skipped = false;
 
    espec = espec_arg;
 
@@ -1629,12 +1909,25 @@ int PS_GPU::StateAction(StateMem *sm, int load, int data_only)
    uint16 TexCache_Data[256][4];
 
    uint16 *vram_new = NULL;
+   uint32 vram_size = 1024 * 512;
+
+#ifdef HAVE_THREADS
+   // Also waits for the drawing to be done.
+   FetchRenderThreadCaches();
+#endif
 
    if (upscale_shift == 0)
    {
       // No upscaling, we can dump the VRAM contents directly
       vram_new = vram;
    }
+   else if (data_only)
+   {
+      // Snapshots only go back into this same GPU, so they can have the
+      // upscaled VRAM as it is.
+      vram_new = vram;
+      vram_size <<= upscale_shift * 2;
+   }
    else
    {
       // We have increased internal resolution, savestates are always
@@ -1664,7 +1957,7 @@ int PS_GPU::StateAction(StateMem *sm, int load, int data_only)
    {
       // Hardcode entry name to remain backward compatible with the
       // previous fixed internal resolution code
-      SFARRAY16N(vram_new, 1024 * 512, "&GPURAM[0][0]"),
+      SFARRAY16N(vram_new, vram_size, "&GPURAM[0][0]"),
 
       SFVAR(DMAControl),
 
@@ -1765,7 +2058,7 @@ int PS_GPU::StateAction(StateMem *sm, int load, int data_only)
 
    int ret = MDFNSS_StateAction(sm, load, data_only, StateRegs, "GPU");
 
-   if (upscale_shift > 0)
+   if (vram_new != vram)
    {
       if (load)
       {
@@ -1825,7 +2118,14 @@ int PS_GPU::StateAction(StateMem *sm, int load, int data_only)
 			      1024, 512,
 			      this->vram, false, false);
 
+	  ScanoutDirty = true;
+	  UpdateScanoutArea();
+
 	  UpdateDisplayMode();
+
+#ifdef HAVE_THREADS
+	  ResyncRenderThread();
+#endif
    }
 
    return(ret);
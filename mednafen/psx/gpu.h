@@ -56,6 +56,8 @@ struct tri_vertex
 
 struct i_group;
 struct i_deltas;
+struct PS_GPU_RenderThread;
+struct PS_GPU_RenderWorker;
 
 struct line_point
 {
@@ -104,6 +106,15 @@ class PS_GPU
 
       void Write(const int32_t timestamp, uint32 A, uint32 V);
 
+#ifdef HAVE_THREADS
+      // Moves the drawing to "count" render threads(see gpu_thread.cpp), or back to the emulation thread with 0; only
+      // meant to be called between frames.
+      void SetRenderThreads(unsigned count) MDFN_COLD;
+
+      // Waits for the render threads to finish everything queued to them, so that VRAM and the output surface are current.
+      void SyncRenderThread(void);
+#endif
+
       INLINE bool CalcFIFOReadyBit(void)
       {
          if(InCmd & (INCMD_PLINE | INCMD_QUAD))
@@ -148,9 +159,26 @@ class PS_GPU
 
       INLINE void PokeRAM(uint32 A, uint16 V)
       {
+         MarkVRAMWrite(A & 0x3FF, (A >> 10) & 0x1FF, 1, 1);
          texel_put(A & 0x3FF, (A >> 10) & 0x1FF, V);
       }
 
+      // Whether [a, a + a_len) and [b, b + b_len) meet, both wrapping around at "size"(a power of 2).
+      static INLINE bool SpansOverlap(uint32 a, uint32 a_len, uint32 b, uint32 b_len, uint32 size)
+      {
+         if(!a_len || !b_len)
+            return false;
+
+         return a_len >= size || b_len >= size || ((b - a) & (size - 1)) < a_len || ((a - b) & (size - 1)) < b_len;
+      }
+
+      // Notes that the w by h VRAM rectangle at x, y(wrapping around) may be written to; see ScanoutDirty.
+      INLINE void MarkVRAMWrite(uint32 x, uint32 y, uint32 w, uint32 h)
+      {
+         if(SpansOverlap(x & 1023, w, ScanoutX, ScanoutW, 1024) && SpansOverlap(y & 511, h, ScanoutY, ScanoutH, 512))
+            ScanoutDirty = true;
+      }
+
       // Return a pixel from VRAM, ignoring the internal upscaling
       INLINE uint16 texel_fetch(uint32 x, uint32 y) const {
 	return vram_fetch(x << upscale_shift,
@@ -160,6 +188,8 @@ class PS_GPU
       // Set a pixel in VRAM, upscaling it if necessary
       INLINE void texel_put(uint32 x, uint32 y, uint16 v) {
 
+	vram_dirty[y & 511] = 1;
+
 	x <<= upscale_shift;
 	y <<= upscale_shift;
 
@@ -295,6 +325,18 @@ class PS_GPU
 
       bool InVBlank;
 
+      //
+      // Scanout skipping: a line is only converted into the surface again if the VRAM it comes from, or the display
+      // setup, may have changed since it last was.
+      //
+      bool ScanoutDirty;	// Set when either changes(the display setup, or a write over ScanoutX/Y/W/H) during a frame
+      bool ScanoutFull;	// ScanoutDirty at the start of the current frame; every line is converted
+      bool scanout_skipped;	// No line of the last frame was converted; the surface holds the same image as the frame before
+      uint32 ScanoutParams[10];
+      uint32 ScanoutX, ScanoutY, ScanoutW, ScanoutH;	// The VRAM area scanout reads, wrapping around
+
+      void UpdateScanoutArea(void);
+
       //
       //
       //
@@ -350,6 +392,20 @@ class PS_GPU
 
       uint8_t DitherLUT[4][4][512];	// Y, X, 8-bit source value(256 extra for saturation)
 
+      // Set while the render thread does the drawing: commands still go through the rasterizers for their effect
+      // on DrawTimeAvail, but VRAM is left alone.
+      bool TimingOnly;
+
+      // Set on the render workers' copies of the GPU state when the drawing is split between several of them:
+      // each only draws the native lines whose RowOwner entry is its own index.
+      const uint8 *RowOwner;
+      uint8 RowOwnerIndex;
+
+      INLINE bool RowSkip(uint32 y) const
+      {
+         return RowOwner && RowOwner[y & 511] != RowOwnerIndex;
+      }
+
    private:
 
       template<uint32 TexMode_TA>
@@ -357,6 +413,7 @@ class PS_GPU
 
 
       void ProcessFIFO(uint32_t in_count);
+      void ExecuteCommand(uint32 cc, const uint32 *CB, bool first);
       void WriteCB(uint32 data, uint32 addr);
       uint32 ReadData(void);
       void SoftReset(void);
@@ -378,6 +435,11 @@ class PS_GPU
       template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode, bool MaskEval_TA>
          void DrawSpan(int y, uint32 clut_offset, const int32 x_start, const int32 x_bound, i_group ig, const i_deltas &idl);
 
+#if defined(__SSE2__)
+      template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
+         int32 DrawSpan_SIMD(int y, uint32 clut_offset, int32 x, const int32 x_bound, i_group &ig, const i_deltas &idl);
+#endif
+
       template<bool shaded, bool textured, int BlendMode, bool TexMult, uint32 TexMode_TA, bool MaskEval_TA>
          void DrawTriangle(tri_vertex *vertices, uint32 clut);
 
@@ -417,20 +479,45 @@ class PS_GPU
    private:
 
 
-      void ReorderRGB_Var(uint32 out_Rshift, uint32 out_Gshift, uint32 out_Bshift, bool bpp24, const uint16 *src, uint32 *dest, const int32 dx_start, const int32 dx_end, int32 fb_x);
+      template<typename T>
+         void ReorderRGB_Var(bool bpp24, const uint16 *src, T *dest, const int32 dx_start, const int32 dx_end, int32 fb_x);
 
       template<uint32 out_Rshift, uint32 out_Gshift, uint32 out_Bshift>
          void ReorderRGB(bool bpp24, const uint16 *src, uint32 *dest, const int32 dx_start, const int32 dx_end, int32 fb_x) NO_INLINE;
 
       void UpdateDisplayMode();
 
+      template<typename T>
+         void OutputRows(T *dest, uint32 pitch, uint32 y, int32 dx_start, int32 dx_end, int32 fb_x, uint32 dmw, bool bpp24);
+      void OutputLine(void *dest, uint32 pitch, uint32 y, int32 dx_start, int32 dx_end, int32 fb_x, uint32 dmw, bool bpp24, bool rgb565);
+      void ScanoutLine(void *dest, uint32 pitch, uint32 y, int32 dx_start, int32 dx_end, int32 fb_x, uint32 dmw, bool bpp24, bool rgb565);
+
+#ifdef HAVE_THREADS
+      PS_GPU_RenderThread *RenderThread;
+
+      void StartRenderThread(unsigned count) MDFN_COLD;
+      void StopRenderThread(void) MDFN_COLD;
+      void ResyncRenderThread(void) MDFN_COLD;
+      void FetchRenderThreadCaches(void) MDFN_COLD;
+      void QueueCommand(uint32 cc, const uint32 *CB, uint32 len, bool first);
+      void QueueFBWrite(uint32 x, uint32 y, uint16 pix);
+      void RunQueued(const uint32 *entry, PS_GPU_RenderWorker *w);
+      void AddTexelSources(uint16 *mask, uint32 cc, const uint32 *CB, bool first);
+      static void RenderThreadMain(void *arg);
+#endif
+
    public:
 
-      // "Flexible" array at the end of the struct. This lets us
-      // having a dynamically sized vram (depending on the internal
-      // upscaling ratio) without having an additional level of
-      // indirection since it'll be allocated right after the struct
-      uint16 vram[0];
+      // VRAM is allocated right after the struct, its size depending
+      // on the internal upscaling ratio. It's reached through a
+      // pointer rather than a flexible array so that the render
+      // thread's copy of the GPU state can share it.
+      uint16 *vram;
+
+      // One byte per native VRAM line, right after VRAM, set whenever the
+      // line is drawn to(for rewinding).  Shared with the render thread
+      // like VRAM itself.
+      uint8 *vram_dirty;
 
 };
 
@@ -112,7 +112,7 @@ INLINE void PS_GPU::Update_CLUT_Cache(uint16 raw_clut)
 
          DrawTimeAvail -= count;
 
-         for(unsigned i = 0; i < count; i++)
+         for(unsigned i = 0; i < count && !TimingOnly; i++)
          {
             CLUT_Cache[i] = texel_fetch((cxo + i) & 0x3FF, y);
          }
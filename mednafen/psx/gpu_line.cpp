@@ -115,6 +115,9 @@ void PS_GPU::DrawLine(line_point *points)
 
    DrawTimeAvail -= k * 2;
 
+   if(TimingOnly)
+      return;
+
    line_points_to_fixed_point_step<goraud>(&points[0], &points[1], k, &step);
    line_point_to_fixed_point_coord<goraud>(&points[0], &step, &cur_point);
 
@@ -124,7 +127,7 @@ void PS_GPU::DrawLine(line_point *points)
       int32_t x = (cur_point.x >> LINE_XY_FRACTBITS) & 2047;
       int32_t y = (cur_point.y >> LINE_XY_FRACTBITS) & 2047;
 
-      if(!LineSkipTest(this, y))
+      if(!LineSkipTest(this, y) && !RowSkip(y))
       {
          uint8_t r, g, b;
          uint16_t pix = 0x8000;
@@ -165,6 +168,7 @@ void PS_GPU::DrawLine(line_point *points)
 template<bool polyline, bool goraud, int BlendMode, bool MaskEval_TA>
 INLINE void PS_GPU::Command_DrawLine(const uint32_t *cb)
 {
+   PSX_PROFILE_CLOCK(PSX_PROF_GPU_LINE, DrawTimeAvail);
    line_point points[2];
    const uint8_t cc = cb[0] >> 24; // For pline handling later.
 
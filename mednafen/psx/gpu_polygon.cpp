@@ -130,6 +130,273 @@ static INLINE void AddIDeltas_DY(i_group &ig, const i_deltas &idl, uint32_t coun
    }
 }
 
+#if defined(__SSE2__)
+/*
+ Interpolant for 8 consecutive pixels, as two vectors of 4 32-bit lanes.
+*/
+struct i_simd
+{
+   __m128i lo, hi;
+   __m128i step;
+};
+
+static INLINE void SIMD_InitInterp(i_simd &is, uint32_t base, uint32_t d)
+{
+   is.lo = _mm_setr_epi32(base, base + d, base + d * 2, base + d * 3);
+   is.hi = _mm_add_epi32(is.lo, _mm_set1_epi32(d * 4));
+   is.step = _mm_set1_epi32(d * 8);
+}
+
+static INLINE void SIMD_StepInterp(i_simd &is)
+{
+   is.lo = _mm_add_epi32(is.lo, is.step);
+   is.hi = _mm_add_epi32(is.hi, is.step);
+}
+
+// COORD_GET_INT() of all 8 lanes, as signed 16-bit.
+static INLINE __m128i SIMD_GetInt(const i_simd &is)
+{
+   return _mm_packs_epi32(_mm_srai_epi32(is.lo, COORD_FBS), _mm_srai_epi32(is.hi, COORD_FBS));
+}
+
+static INLINE __m128i SIMD_Select(__m128i mask, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+// Same as DitherLUT[][][v], with the dither_table entry for each lane in "offs".
+static INLINE __m128i SIMD_Dither(__m128i v, __m128i offs)
+{
+   v = _mm_srai_epi16(_mm_add_epi16(v, offs), 3);
+
+   return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(0x1F));
+}
+
+static INLINE __m128i SIMD_DitherOffsets(const int8 *row, int32_t x, unsigned shift)
+{
+   return _mm_setr_epi16(row[((x + 0) >> shift) & 3], row[((x + 1) >> shift) & 3],
+         row[((x + 2) >> shift) & 3], row[((x + 3) >> shift) & 3],
+         row[((x + 4) >> shift) & 3], row[((x + 5) >> shift) & 3],
+         row[((x + 6) >> shift) & 3], row[((x + 7) >> shift) & 3]);
+}
+
+// PlotPixelBlend(), on 4 pixels zero-extended to 32 bits so the carries work out exactly as they do there.
+template<int BlendMode>
+static INLINE __m128i SIMD_Blend32(__m128i bg_pix, __m128i fore_pix)
+{
+   __m128i sum, carry;
+
+   switch(BlendMode)
+   {
+      case BLEND_MODE_AVERAGE:
+         bg_pix   = _mm_or_si128(bg_pix, _mm_set1_epi32(0x8000));
+         fore_pix = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(fore_pix, bg_pix),
+                  _mm_and_si128(_mm_xor_si128(fore_pix, bg_pix), _mm_set1_epi32(0x0421))), 1);
+         break;
+
+      case BLEND_MODE_ADD_FOURTH:
+         fore_pix = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(fore_pix, 2), _mm_set1_epi32(0x1CE7)), _mm_set1_epi32(0x8000));
+         /* fall-through */
+      case BLEND_MODE_ADD:
+         bg_pix   = _mm_and_si128(bg_pix, _mm_set1_epi32(0x7FFF));
+         sum      = _mm_add_epi32(fore_pix, bg_pix);
+         carry    = _mm_and_si128(_mm_sub_epi32(sum, _mm_and_si128(_mm_xor_si128(fore_pix, bg_pix), _mm_set1_epi32(0x8421))),
+               _mm_set1_epi32(0x8420));
+         fore_pix = _mm_or_si128(_mm_sub_epi32(sum, carry), _mm_sub_epi32(carry, _mm_srli_epi32(carry, 5)));
+         break;
+
+      case BLEND_MODE_SUBTRACT:
+         {
+            __m128i diff, borrow;
+
+            bg_pix   = _mm_or_si128(bg_pix, _mm_set1_epi32(0x8000));
+            fore_pix = _mm_and_si128(fore_pix, _mm_set1_epi32(0x7FFF));
+            diff     = _mm_add_epi32(_mm_sub_epi32(bg_pix, fore_pix), _mm_set1_epi32(0x108420));
+            borrow   = _mm_and_si128(_mm_sub_epi32(diff, _mm_and_si128(_mm_xor_si128(bg_pix, fore_pix), _mm_set1_epi32(0x108420))),
+                  _mm_set1_epi32(0x108420));
+            fore_pix = _mm_and_si128(_mm_sub_epi32(diff, borrow), _mm_sub_epi32(borrow, _mm_srli_epi32(borrow, 5)));
+         }
+         break;
+   }
+
+   return fore_pix;
+}
+
+template<int BlendMode>
+static INLINE __m128i SIMD_Blend(__m128i bg_pix, __m128i fore_pix)
+{
+   const __m128i zero = _mm_setzero_si128();
+   __m128i lo = SIMD_Blend32<BlendMode>(_mm_unpacklo_epi16(bg_pix, zero), _mm_unpacklo_epi16(fore_pix, zero));
+   __m128i hi = SIMD_Blend32<BlendMode>(_mm_unpackhi_epi16(bg_pix, zero), _mm_unpackhi_epi16(fore_pix, zero));
+
+   // Truncate back to 16 bits(sign-extend first so the saturating pack leaves them alone).
+   lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+   hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+
+   return _mm_packs_epi32(lo, hi);
+}
+
+/*
+ Draws the span 8 pixels at a time, for as long as it can, and returns the x coordinate it stopped at with "ig" advanced to
+ match; DrawSpan()'s loop takes care of the rest.  The output is identical to what that loop would have produced: texels are
+ still fetched one at a time(there's no gather before AVX2), but everything else, including blending and mask evaluation, is
+ done across the whole group.
+*/
+template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
+INLINE int32_t PS_GPU::DrawSpan_SIMD(int y, uint32_t clut_offset, int32_t x, const int32_t x_bound, i_group &ig, const i_deltas &idl)
+{
+   const int32_t x_start = x;
+   const int32_t y_wrapped = y & ((512 << upscale_shift) - 1);
+   uint16_t *row = &vram[y_wrapped << (10 + upscale_shift)];
+   const int8 *dither_row = dither_table[(y >> dither_upscale_shift) & 3];
+   const bool dither = DitherEnabled() && (textured ? TexMult : goraud);
+   const __m128i mask_set_or = _mm_set1_epi16(MaskSetOR);
+   __m128i dither_offs = _mm_setzero_si128();
+   __m128i r, g, b;
+   i_simd i_r, i_g, i_b, i_u, i_v;
+   // Native VRAM row being drawn to, if texels can be fetched from it, -1 if not.
+   int32_t fb_row = -1;
+
+   if(textured && !(y_wrapped & (upscale() - 1)))
+   {
+      fb_row = y_wrapped >> upscale_shift;
+
+      // A texel fetch may see a pixel drawn earlier in the same group, which isn't worth handling here.
+      if(TexMode_TA != 2 && (int32_t)((clut_offset >> 10) & 511) == fb_row)
+         return(x);
+   }
+
+   if(goraud)
+   {
+      SIMD_InitInterp(i_r, ig.r, idl.dr_dx);
+      SIMD_InitInterp(i_g, ig.g, idl.dg_dx);
+      SIMD_InitInterp(i_b, ig.b, idl.db_dx);
+   }
+   else
+   {
+      r = _mm_set1_epi16(COORD_GET_INT(ig.r));
+      g = _mm_set1_epi16(COORD_GET_INT(ig.g));
+      b = _mm_set1_epi16(COORD_GET_INT(ig.b));
+   }
+
+   if(textured)
+   {
+      SIMD_InitInterp(i_u, ig.u, idl.du_dx);
+      SIMD_InitInterp(i_v, ig.v, idl.dv_dx);
+   }
+
+   // ModTexel() is handed an entry of the table even when dithering is off.
+   if(dither)
+      dither_offs = SIMD_DitherOffsets(dither_row, x, dither_upscale_shift);
+   else if(textured && TexMult)
+      dither_offs = _mm_set1_epi16(dither_table[2][3]);
+
+   for(; MDFN_LIKELY((x + 8) <= x_bound); x += 8)
+   {
+      __m128i fore_pix, bg_pix;
+      __m128i write = _mm_set1_epi16(-1);
+
+      if(goraud)
+      {
+         const __m128i zero = _mm_setzero_si128();
+         const __m128i max = _mm_set1_epi16(0xFF);
+
+         r = _mm_min_epi16(_mm_max_epi16(SIMD_GetInt(i_r), zero), max);
+         g = _mm_min_epi16(_mm_max_epi16(SIMD_GetInt(i_g), zero), max);
+         b = _mm_min_epi16(_mm_max_epi16(SIMD_GetInt(i_b), zero), max);
+      }
+
+      // The pattern only repeats every 8 pixels when it isn't stretched any further than 2x.
+      if(dither && dither_upscale_shift > 1)
+         dither_offs = SIMD_DitherOffsets(dither_row, x, dither_upscale_shift);
+
+      if(textured)
+      {
+         int16 u[8] MDFN_ALIGN(16);
+         int16 v[8] MDFN_ALIGN(16);
+         uint16 texels[8] MDFN_ALIGN(16);
+
+         _mm_store_si128((__m128i *)u, SIMD_GetInt(i_u));
+         _mm_store_si128((__m128i *)v, SIMD_GetInt(i_v));
+
+         for(unsigned i = 0; i < 8; i++)
+         {
+            if(MDFN_UNLIKELY((int32_t)(TexPageY + TexWindowYLUT[v[i]]) == fb_row))
+               goto Done;
+
+            texels[i] = GetTexel<TexMode_TA>(clut_offset, u[i], v[i]);
+         }
+
+         fore_pix = _mm_load_si128((__m128i *)texels);
+         write = _mm_xor_si128(_mm_cmpeq_epi16(fore_pix, _mm_setzero_si128()), write);
+
+         if(TexMult)
+         {
+            const __m128i c_mask = _mm_set1_epi16(0x1F);
+            __m128i tr = _mm_and_si128(fore_pix, c_mask);
+            __m128i tg = _mm_and_si128(_mm_srli_epi16(fore_pix, 5), c_mask);
+            __m128i tb = _mm_and_si128(_mm_srli_epi16(fore_pix, 10), c_mask);
+
+            tr = SIMD_Dither(_mm_srli_epi16(_mm_mullo_epi16(tr, r), 4), dither_offs);
+            tg = SIMD_Dither(_mm_srli_epi16(_mm_mullo_epi16(tg, g), 4), dither_offs);
+            tb = SIMD_Dither(_mm_srli_epi16(_mm_mullo_epi16(tb, b), 4), dither_offs);
+
+            fore_pix = _mm_or_si128(_mm_and_si128(fore_pix, _mm_set1_epi16(0x8000)),
+                  _mm_or_si128(tr, _mm_or_si128(_mm_slli_epi16(tg, 5), _mm_slli_epi16(tb, 10))));
+         }
+      }
+      else
+      {
+         fore_pix = _mm_or_si128(SIMD_Dither(r, dither_offs),
+               _mm_or_si128(_mm_slli_epi16(SIMD_Dither(g, dither_offs), 5), _mm_slli_epi16(SIMD_Dither(b, dither_offs), 10)));
+         fore_pix = _mm_or_si128(fore_pix, _mm_set1_epi16(0x8000));
+      }
+
+      if(!textured && BlendMode < 0 && !MaskEval_TA)
+      {
+         _mm_storeu_si128((__m128i *)&row[x], _mm_or_si128(_mm_and_si128(fore_pix, _mm_set1_epi16(0x7FFF)), mask_set_or));
+      }
+      else
+      {
+         bg_pix = _mm_loadu_si128((__m128i *)&row[x]);
+
+         if(BlendMode >= 0)
+         {
+            const __m128i semi = _mm_cmplt_epi16(fore_pix, _mm_setzero_si128());
+
+            fore_pix = SIMD_Select(semi, SIMD_Blend<BlendMode>(bg_pix, fore_pix), fore_pix);
+         }
+
+         if(MaskEval_TA)
+            write = _mm_andnot_si128(_mm_srai_epi16(bg_pix, 15), write);
+
+         if(!textured)
+            fore_pix = _mm_and_si128(fore_pix, _mm_set1_epi16(0x7FFF));
+
+         _mm_storeu_si128((__m128i *)&row[x], SIMD_Select(write, _mm_or_si128(fore_pix, mask_set_or), bg_pix));
+      }
+
+      if(goraud)
+      {
+         SIMD_StepInterp(i_r);
+         SIMD_StepInterp(i_g);
+         SIMD_StepInterp(i_b);
+      }
+
+      if(textured)
+      {
+         SIMD_StepInterp(i_u);
+         SIMD_StepInterp(i_v);
+      }
+   }
+
+Done:
+   AddIDeltas_DX<goraud, textured>(ig, idl, x - x_start);
+
+   return(x);
+}
+#endif
+
 template<bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
 INLINE void PS_GPU::DrawSpan(int y, uint32_t clut_offset, const int32_t x_start, const int32_t x_bound, i_group ig, const i_deltas &idl)
 {
@@ -137,7 +404,7 @@ INLINE void PS_GPU::DrawSpan(int y, uint32_t clut_offset, const int32_t x_start,
    int32 clipx0 = ClipX0 << upscale_shift;
    int32 clipx1 = ClipX1 << upscale_shift;
 
-   if(LineSkipTest(this, y >> upscale_shift))
+   if(LineSkipTest(this, y >> upscale_shift) || RowSkip(y >> upscale_shift))
       return;
 
    if(xs < xb)	// (xs != xb)
@@ -162,6 +429,11 @@ INLINE void PS_GPU::DrawSpan(int y, uint32_t clut_offset, const int32_t x_start,
          }
       }
 
+      if(TimingOnly)
+         return;
+
+      vram_dirty[(y >> upscale_shift) & 511] = 1;
+
       if(textured)
       {
          ig.u += (xs * idl.du_dx) + (y * idl.du_dy);
@@ -176,7 +448,13 @@ INLINE void PS_GPU::DrawSpan(int y, uint32_t clut_offset, const int32_t x_start,
       }
 
 
-      for(int32_t x = xs; MDFN_LIKELY(x < xb); x++)
+      int32_t x = xs;
+
+#if defined(__SSE2__)
+      x = DrawSpan_SIMD<goraud, textured, BlendMode, TexMult, TexMode_TA, MaskEval_TA>(y, clut_offset, xs, xb, ig, idl);
+#endif
+
+      for(; MDFN_LIKELY(x < xb); x++)
       {
          uint32_t r, g, b;
 
@@ -416,6 +694,7 @@ void PS_GPU::DrawTriangle(tri_vertex *vertices, uint32_t clut)
 template<int numvertices, bool goraud, bool textured, int BlendMode, bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA, bool pgxp>
 INLINE void PS_GPU::Command_DrawPolygon(const uint32_t *cb)
 {
+   PSX_PROFILE_CLOCK(PSX_PROF_GPU_POLYGON, DrawTimeAvail);
    tri_vertex vertices[3];
 	const uint32_t* baseCB = cb;
    const unsigned cb0     = cb[0];
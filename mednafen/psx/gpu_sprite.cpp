@@ -87,7 +87,10 @@ void PS_GPU::DrawSprite(int32_t x_arg, int32_t y_arg, int32_t w, int32_t h,
             DrawTimeAvail -= suck_time;
          }
 
-         for(int32_t x = x_start; MDFN_LIKELY(x < x_bound); x++)
+         // Nothing to draw when only the time is wanted, or when another render worker has the line.
+         const int32_t x_draw_bound = (TimingOnly || RowSkip(y)) ? x_start : x_bound;
+
+         for(int32_t x = x_start; MDFN_LIKELY(x < x_draw_bound); x++)
          {
             if(textured)
             {
@@ -148,6 +151,7 @@ template<uint8_t raw_size, bool textured, int BlendMode,
    bool TexMult, uint32_t TexMode_TA, bool MaskEval_TA>
 INLINE void PS_GPU::Command_DrawSprite(const uint32_t *cb)
 {
+   PSX_PROFILE_CLOCK(PSX_PROF_GPU_SPRITE, DrawTimeAvail);
    int32_t x, y;
    int32_t w, h;
    uint8_t     u    = 0;
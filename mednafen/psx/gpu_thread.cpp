@@ -0,0 +1,619 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Included from gpu.cpp
+
+/*
+ Threaded software rendering.
+
+ The emulation thread still runs every GP0 command itself, but with TimingOnly set, so the GPU state and DrawTimeAvail go
+ exactly as they otherwise would while VRAM is left alone.  Whatever touches VRAM(drawing commands and the state they
+ depend on, FB write data, and the scanout of visible lines) is also put in a single-producer ring, from which the render
+ workers replay it in order, each on its own copy of the GPU state, sharing VRAM with the emulated GPU.
+
+ With more than one worker, VRAM is split into bands of RT_BAND_LINES native lines dealt out to the workers in turn, and
+ each worker only draws(and scans out) the lines in its own bands, so primitives are still drawn in order on every line.
+ Everything else a primitive does is done by all of the workers.  That holds as long as nothing reads VRAM across bands,
+ so the workers all keep track of the VRAM written and the textures and CLUTs read since they were last in step, and
+ wait for each other(in the same places, as they all see the same commands) before a primitive uses textures or a CLUT
+ from what's been written, and before anything writes over what's been read, so that no worker can get far enough ahead
+ to change what another has yet to read.  FB copies, and primitives that can draw over their own texture page or
+ CLUT(where the order of the lines matters), are done by the first worker alone, with the others waiting on either side
+ of it; they only go through the motions to keep their state in step, and take the first worker's CLUT cache after.
+
+ The emulation thread waits for the workers to catch up only when it needs to look at VRAM or the output surface:
+ FB reads, light guns, savestates, resets, and the end of each frame.  The texture and CLUT caches are only valid on
+ the workers' side.
+*/
+
+#include <atomic>
+#include <rthreads/rthreads.h>
+
+enum
+{
+   RT_COMMAND = 0,
+   RT_FBWRITE,
+   RT_SCANOUT,
+   RT_QUIT
+};
+
+// Entries are a header word(type in the low 8 bits, length in words including the header above that), then:
+//
+//  RT_COMMAND:  cc | first << 8 | InCmd << 16,
+//               DisplayMode | DisplayFB_YStart << 8 | field_ram_readout << 17 | TexDisableAllowChange << 18,
+//               the command words
+//  RT_FBWRITE:  x | y << 16, pixel | MaskEvalAND << 16
+//  RT_SCANOUT:  dest(2 words), then the rest of OutputLine()'s arguments
+//
+#define RT_RING_SIZE    (1U << 20)	// In words
+#define RT_RING_MASK    (RT_RING_SIZE - 1)
+#define RT_MAX_ENTRY    (3 + 0x10)
+#define RT_SPIN_COUNT   2048
+#define RT_MAX_WORKERS  16
+#define RT_BAND_LINES   8
+
+struct PS_GPU_RenderWorker
+{
+   PS_GPU_RenderThread *rt;
+   PS_GPU *gpu;	// This worker's copy of the GPU state
+   sthread_t *thread;
+   unsigned index;
+
+   std::atomic<uint32> read_pos;
+
+   // VRAM written, and VRAM read as textures or CLUTs, since the workers were last in step, in 64x64 blocks(bit x of
+   // Dirty[y]).
+   uint16 Dirty[8];
+   uint16 Read[8];
+};
+
+struct PS_GPU_RenderThread
+{
+   unsigned count;
+   PS_GPU_RenderWorker workers[RT_MAX_WORKERS];
+   uint8 row_owner[512];
+
+   // The first worker's CLUT cache after a command it did alone, for the others to take.
+   uint16 clut_cache[256];
+   uint32 clut_cache_vb;
+
+   slock_t *lock;
+   scond_t *work_cond;	// Broadcast when something's queued while workers are sleeping
+   scond_t *done_cond;	// Signalled when entries are consumed while the emulation thread is sleeping
+   scond_t *barrier_cond;	// Broadcast when the last worker gets to a barrier
+
+   std::atomic<uint32> write_pos;
+   std::atomic<unsigned> render_sleeping;
+   std::atomic<bool> emu_sleeping;
+   std::atomic<unsigned> barrier_arrived;
+   std::atomic<uint32> barrier_gen;
+
+   uint32 ring[RT_RING_SIZE];
+};
+
+static uint32 RT_Pending(PS_GPU_RenderThread *rt, uint32 wp)
+{
+   uint32 ret = 0;
+
+   for(unsigned i = 0; i < rt->count; i++)
+      ret = std::max<uint32>(ret, wp - rt->workers[i].read_pos.load());
+
+   return ret;
+}
+
+// Waits until no worker has more than "max_pending" words left to read.
+static void RT_WaitPending(PS_GPU_RenderThread *rt, uint32 max_pending)
+{
+   const uint32 wp = rt->write_pos.load(std::memory_order_relaxed);
+
+   for(unsigned spins = 0; RT_Pending(rt, wp) > max_pending; spins++)
+   {
+      if(spins < RT_SPIN_COUNT)
+         continue;
+
+      slock_lock(rt->lock);
+      rt->emu_sleeping = true;
+
+      while(RT_Pending(rt, wp) > max_pending)
+         scond_wait(rt->done_cond, rt->lock);
+
+      rt->emu_sleeping = false;
+      slock_unlock(rt->lock);
+      break;
+   }
+}
+
+static void RT_Push(PS_GPU_RenderThread *rt, const uint32 *entry, uint32 count)
+{
+   uint32 wp = rt->write_pos.load(std::memory_order_relaxed);
+
+   RT_WaitPending(rt, RT_RING_SIZE - count);
+
+   for(uint32 i = 0; i < count; i++)
+      rt->ring[(wp + i) & RT_RING_MASK] = entry[i];
+
+   rt->write_pos.store(wp + count);
+
+   if(rt->render_sleeping.load())
+   {
+      slock_lock(rt->lock);
+      scond_broadcast(rt->work_cond);
+      slock_unlock(rt->lock);
+   }
+}
+
+// Waits for all of the workers to get here, after which everything they've drawn before is there for all of them.
+static void RT_Barrier(PS_GPU_RenderWorker *w)
+{
+   PS_GPU_RenderThread *rt = w->rt;
+   const uint32 gen = rt->barrier_gen.load();
+
+   memset(w->Dirty, 0, sizeof(w->Dirty));
+   memset(w->Read, 0, sizeof(w->Read));
+
+   if((rt->barrier_arrived.fetch_add(1) + 1) == rt->count)
+   {
+      rt->barrier_arrived = 0;
+      rt->barrier_gen.store(gen + 1);
+
+      slock_lock(rt->lock);
+      scond_broadcast(rt->barrier_cond);
+      slock_unlock(rt->lock);
+      return;
+   }
+
+   for(unsigned spins = 0; rt->barrier_gen.load() == gen; spins++)
+   {
+      if(spins < RT_SPIN_COUNT)
+         continue;
+
+      slock_lock(rt->lock);
+
+      while(rt->barrier_gen.load() == gen)
+         scond_wait(rt->barrier_cond, rt->lock);
+
+      slock_unlock(rt->lock);
+   }
+}
+
+// Adds the 64x64 blocks covering a VRAM rectangle to "mask"(bit x of mask[y]), wrapping around like VRAM addressing does.
+static void RT_AddBlocks(uint16 *mask, uint32 x, uint32 y, uint32 w, uint32 h)
+{
+   const uint32 bx_count = std::min<uint32>(((x & 63) + w + 63) >> 6, 16);
+   const uint32 by_count = std::min<uint32>(((y & 63) + h + 63) >> 6, 8);
+   uint16 xmask = 0;
+
+   if(!w || !h)
+      return;
+
+   for(uint32 i = 0; i < bx_count; i++)
+      xmask |= 1 << (((x >> 6) + i) & 15);
+
+   for(uint32 i = 0; i < by_count; i++)
+      mask[((y >> 6) + i) & 7] |= xmask;
+}
+
+static void RT_MergeBlocks(uint16 *mask, const uint16 *other)
+{
+   for(unsigned i = 0; i < 8; i++)
+      mask[i] |= other[i];
+}
+
+static bool RT_Overlap(const uint16 *a, const uint16 *b)
+{
+   for(unsigned i = 0; i < 8; i++)
+   {
+      if(a[i] & b[i])
+         return true;
+   }
+
+   return false;
+}
+
+void PS_GPU::RenderThreadMain(void *arg)
+{
+   PS_GPU_RenderWorker *w = (PS_GPU_RenderWorker*)arg;
+   PS_GPU_RenderThread *rt = w->rt;
+   uint32 rp = w->read_pos.load(std::memory_order_relaxed);
+   uint32 entry[RT_MAX_ENTRY];
+
+#ifdef HAVE_PROFILE
+   PSX_ProfileIgnoreThread();
+#endif
+
+   for(;;)
+   {
+      unsigned spins = 0;
+
+      while(rt->write_pos.load() == rp)
+      {
+         if(spins++ < RT_SPIN_COUNT)
+            continue;
+
+         slock_lock(rt->lock);
+         rt->render_sleeping++;
+
+         while(rt->write_pos.load() == rp)
+            scond_wait(rt->work_cond, rt->lock);
+
+         rt->render_sleeping--;
+         slock_unlock(rt->lock);
+      }
+
+      const uint32 header = rt->ring[rp & RT_RING_MASK];
+      const uint32 count = header >> 8;
+
+      entry[0] = header;
+      for(uint32 i = 1; i < count; i++)
+         entry[i] = rt->ring[(rp + i) & RT_RING_MASK];
+
+      if((header & 0xFF) != RT_QUIT)
+         w->gpu->RunQueued(entry, w);
+
+      rp += count;
+      w->read_pos.store(rp);
+
+      if(rt->emu_sleeping.load())
+      {
+         slock_lock(rt->lock);
+         scond_signal(rt->done_cond);
+         slock_unlock(rt->lock);
+      }
+
+      if((header & 0xFF) == RT_QUIT)
+         break;
+   }
+}
+
+// Adds the VRAM a textured polygon or sprite can take texels and CLUT entries from to "mask".
+void PS_GPU::AddTexelSources(uint16 *mask, uint32 cc, const uint32 *CB, bool first)
+{
+   uint32 tpx = TexPageX, tpy = TexPageY, tmode = TexMode;
+   uint32 clut = InQuad_clut;
+
+   if(first)
+   {
+      if(cc < 0x40)
+      {
+         const uint32 tp = CB[4 + ((cc >> 4) & 0x1)] >> 16;
+
+         tpx = (tp & 0xF) * 64;
+         tpy = (tp & 0x10) * 16;
+         tmode = (tp >> 7) & 0x3;
+      }
+
+      clut = (CB[2] >> 16) << 4;
+   }
+
+   RT_AddBlocks(mask, tpx, tpy, 64 << std::min<uint32>(tmode, 2), 256);
+
+   if(tmode < 2)
+      RT_AddBlocks(mask, clut & 0x3F0, (clut >> 10) & 0x1FF, tmode ? 256 : 16, 1);
+}
+
+void PS_GPU::RunQueued(const uint32 *entry, PS_GPU_RenderWorker *w)
+{
+   const bool banded = w->rt->count > 1;
+
+   switch(entry[0] & 0xFF)
+   {
+      case RT_COMMAND:
+         {
+            const uint32 cc = entry[1] & 0xFF;
+            const bool first = (entry[1] >> 8) & 1;
+            const uint32 *CB = &entry[3];
+            bool exclusive = false;
+
+            InCmd = entry[1] >> 16;
+            DisplayMode = entry[2] & 0xFF;
+            DisplayFB_YStart = (entry[2] >> 8) & 0x1FF;
+            field_ram_readout = (entry[2] >> 17) & 1;
+            TexDisableAllowChange = (entry[2] >> 18) & 1;
+
+            // Nothing's waiting on it here, just keep it from running away.
+            DrawTimeAvail = 0;
+
+            if(!banded)
+            {
+               ExecuteCommand(cc, CB, first);
+               break;
+            }
+
+            uint16 writes[8] = { 0 };
+
+            if(cc == 0x02)
+            {
+               RT_AddBlocks(writes, CB[1] & 0x3F0, (CB[1] >> 16) & 0x3FF,
+                     ((CB[2] & 0x3FF) + 0xF) & ~0xF, (CB[2] >> 16) & 0x1FF);
+            }
+            else if(cc >= 0x20 && cc <= 0x7F && ClipX1 >= ClipX0 && ClipY1 >= ClipY0)
+               RT_AddBlocks(writes, ClipX0, ClipY0, ClipX1 - ClipX0 + 1, ClipY1 - ClipY0 + 1);
+
+            if(cc >= 0x80 && cc <= 0x9F)
+               exclusive = true;
+            else if(cc >= 0x20 && cc <= 0x7F && (cc < 0x40 || cc >= 0x60) && (cc & 0x4))
+            {
+               uint16 sources[8] = { 0 };
+
+               AddTexelSources(sources, cc, CB, first);
+
+               // Drawing over its own texels has to be done in order, line after line.
+               if(RT_Overlap(sources, writes))
+                  exclusive = true;
+               else
+               {
+                  if(RT_Overlap(sources, w->Dirty) || RT_Overlap(writes, w->Read))
+                     RT_Barrier(w);
+
+                  RT_MergeBlocks(w->Read, sources);
+               }
+            }
+            else if(RT_Overlap(writes, w->Read))
+               RT_Barrier(w);
+
+            if(exclusive)
+            {
+               // The first worker does it all while the others wait.  They still run it, without VRAM, so that the
+               // rest of their state stays in step, then take the first worker's CLUT cache; loading it themselves
+               // could catch the first worker halfway through drawing over it.
+               RT_Barrier(w);
+
+               if(w->index == 0)
+               {
+                  RowOwner = NULL;
+                  ExecuteCommand(cc, CB, first);
+                  RowOwner = w->rt->row_owner;
+
+                  memcpy(w->rt->clut_cache, CLUT_Cache, sizeof(CLUT_Cache));
+                  w->rt->clut_cache_vb = CLUT_Cache_VB;
+               }
+               else
+               {
+                  TimingOnly = true;
+                  ExecuteCommand(cc, CB, first);
+                  TimingOnly = false;
+               }
+
+               RT_Barrier(w);
+
+               if(w->index != 0)
+               {
+                  memcpy(CLUT_Cache, w->rt->clut_cache, sizeof(CLUT_Cache));
+                  CLUT_Cache_VB = w->rt->clut_cache_vb;
+               }
+               break;
+            }
+
+            ExecuteCommand(cc, CB, first);
+            RT_MergeBlocks(w->Dirty, writes);
+         }
+         break;
+
+      case RT_FBWRITE:
+         {
+            const uint32 x = entry[1] & 0xFFFF;
+            const uint32 y = entry[1] >> 16;
+
+            if(banded)
+            {
+               uint16 writes[8] = { 0 };
+
+               RT_AddBlocks(writes, x, y, 1, 1);
+
+               if(RT_Overlap(writes, w->Read))
+                  RT_Barrier(w);
+
+               RT_MergeBlocks(w->Dirty, writes);
+            }
+
+            if(!RowSkip(y) && !(texel_fetch(x, y) & (entry[2] >> 16)))
+               texel_put(x, y, entry[2] & 0xFFFF);
+         }
+         break;
+
+      case RT_SCANOUT:
+         if(!RowSkip(entry[4] >> upscale_shift))
+         {
+            OutputLine((void*)(uintptr_t)((uint64)entry[1] | ((uint64)entry[2] << 32)), entry[3], entry[4],
+                  (int32)entry[5], (int32)entry[6], (int32)entry[7], entry[8], entry[9], entry[10]);
+         }
+         break;
+   }
+}
+
+INLINE void PS_GPU::QueueCommand(uint32 cc, const uint32 *CB, uint32 len, bool first)
+{
+   uint32 entry[RT_MAX_ENTRY];
+
+   // Only what draws or changes the drawing state; FB write data goes separately, and the FB read and
+   // write commands are only here for the texture cache invalidation.
+   if(!(cc == 0x01 || cc == 0x02 || (cc >= 0x20 && cc <= 0xDF) || (cc >= 0xE1 && cc <= 0xE6)))
+      return;
+
+   entry[0] = RT_COMMAND | ((3 + len) << 8);
+   entry[1] = cc | (first << 8) | (InCmd << 16);
+   entry[2] = DisplayMode | (DisplayFB_YStart << 8) | (field_ram_readout << 17) | (TexDisableAllowChange << 18);
+
+   for(uint32 i = 0; i < len; i++)
+      entry[3 + i] = CB[i];
+
+   RT_Push(RenderThread, entry, 3 + len);
+}
+
+INLINE void PS_GPU::QueueFBWrite(uint32 x, uint32 y, uint16 pix)
+{
+   const uint32 entry[3] = { RT_FBWRITE | (3 << 8), x | (y << 16), pix | (MaskEvalAND << 16) };
+
+   RT_Push(RenderThread, entry, 3);
+}
+
+void PS_GPU::SyncRenderThread(void)
+{
+   if(RenderThread)
+      RT_WaitPending(RenderThread, 0);
+}
+
+void PS_GPU::ResyncRenderThread(void)
+{
+   PS_GPU_RenderThread *rt = RenderThread;
+
+   if(!rt)
+      return;
+
+   SyncRenderThread();
+
+   for(unsigned i = 0; i < rt->count; i++)
+   {
+      PS_GPU_RenderWorker *w = &rt->workers[i];
+
+      *w->gpu = *this;
+      w->gpu->TimingOnly = false;
+      w->gpu->RenderThread = NULL;
+      w->gpu->RowOwner = (rt->count > 1) ? rt->row_owner : NULL;
+      w->gpu->RowOwnerIndex = i;
+
+      memset(w->Dirty, 0, sizeof(w->Dirty));
+      memset(w->Read, 0, sizeof(w->Read));
+   }
+}
+
+void PS_GPU::FetchRenderThreadCaches(void)
+{
+   PS_GPU *wg;
+
+   if(!RenderThread)
+      return;
+
+   SyncRenderThread();
+
+   wg = RenderThread->workers[0].gpu;
+
+   memcpy(CLUT_Cache, wg->CLUT_Cache, sizeof(CLUT_Cache));
+   CLUT_Cache_VB = wg->CLUT_Cache_VB;
+   memcpy(TexCache, wg->TexCache, sizeof(TexCache));
+}
+
+void PS_GPU::StartRenderThread(unsigned count)
+{
+   PS_GPU_RenderThread *rt = new PS_GPU_RenderThread;
+   unsigned started = 0;
+
+   rt->count = count;
+
+   for(unsigned y = 0; y < 512; y++)
+      rt->row_owner[y] = (y / RT_BAND_LINES) % rt->count;
+
+   rt->write_pos = 0;
+   rt->render_sleeping = 0;
+   rt->emu_sleeping = false;
+   rt->barrier_arrived = 0;
+   rt->barrier_gen = 0;
+
+   rt->lock = slock_new();
+   rt->work_cond = scond_new();
+   rt->done_cond = scond_new();
+   rt->barrier_cond = scond_new();
+
+   RenderThread = rt;
+
+   for(unsigned i = 0; i < rt->count; i++)
+   {
+      PS_GPU_RenderWorker *w = &rt->workers[i];
+
+      w->rt = rt;
+      w->gpu = new PS_GPU(*this);
+      w->index = i;
+      w->read_pos = 0;
+   }
+
+   ResyncRenderThread();
+
+   for(; started < rt->count; started++)
+   {
+      PS_GPU_RenderWorker *w = &rt->workers[started];
+
+      if(!(w->thread = sthread_create(RenderThreadMain, w)))
+         break;
+   }
+
+   if(started < rt->count)
+   {
+      // Can't wait on a barrier with workers missing, so just give up on them.
+      for(unsigned i = started; i < rt->count; i++)
+         delete rt->workers[i].gpu;
+
+      rt->count = started;
+      StopRenderThread();
+      return;
+   }
+
+   TimingOnly = true;
+}
+
+void PS_GPU::StopRenderThread(void)
+{
+   PS_GPU_RenderThread *rt = RenderThread;
+   const uint32 quit = RT_QUIT | (1 << 8);
+
+   if(!rt)
+      return;
+
+   FetchRenderThreadCaches();
+
+   RT_Push(rt, &quit, 1);
+
+   for(unsigned i = 0; i < rt->count; i++)
+      sthread_join(rt->workers[i].thread);
+
+   for(unsigned i = 0; i < rt->count; i++)
+      delete rt->workers[i].gpu;
+
+   scond_free(rt->barrier_cond);
+   scond_free(rt->done_cond);
+   scond_free(rt->work_cond);
+   slock_free(rt->lock);
+   delete rt;
+
+   RenderThread = NULL;
+   TimingOnly = false;
+}
+
+void PS_GPU::SetRenderThreads(unsigned count)
+{
+#ifdef RSX_DUMP
+   count = 0;
+#endif
+
+   count = std::min<unsigned>(count, RT_MAX_WORKERS);
+
+   if(RenderThread && RenderThread->count != count)
+      StopRenderThread();
+
+   if(!count)
+      return;
+
+   if(!RenderThread)
+      StartRenderThread(count);
+   else
+   {
+      SyncRenderThread();
+
+      // Set between frames from the core options.
+      for(unsigned i = 0; i < RenderThread->count; i++)
+         RenderThread->workers[i].gpu->dither_upscale_shift = dither_upscale_shift;
+   }
+}
@@ -1621,6 +1621,7 @@ static int32_t GPL(uint32_t instr)
 
 int32_t GTE_Instruction(uint32_t instr)
 {
+   PSX_PROFILE(PSX_PROF_GTE);
    const unsigned code = instr & 0x3F;
    int32_t ret = 1;
 
@@ -1873,5 +1874,7 @@ int32_t GTE_Instruction(uint32_t instr)
 
    CR[31] = FLAGS;
 
+   PSX_PROFILE_CYCLES(PSX_PROF_GTE, ret - 1);
+
    return(ret - 1);
 }
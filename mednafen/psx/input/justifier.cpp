@@ -210,7 +210,7 @@ int32_t InputDevice_Justifier::GPULineHook(const int32_t timestamp, bool vsync,
       {
          int r, g, b, a;
 
-         format->DecodeColor(pixels[gxa], r, g, b, a);
+         format->DecodeColor(format->ReadPixel(pixels, gxa), r, g, b, a);
 
          if((r + g + b) >= 0x40)	// Wrong, but not COMPLETELY ABSOLUTELY wrong, at least. ;)
          {
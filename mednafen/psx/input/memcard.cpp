@@ -110,6 +110,8 @@ void InputDevice_Memcard::Format(void)
       card_data[A + 0x08] = 0xFF;
       card_data[A + 0x09] = 0xFF;
    }
+
+   MDFNSS_MarkDirty(card_data, sizeof(card_data));
 }
 
 InputDevice_Memcard::InputDevice_Memcard()
@@ -454,6 +456,7 @@ bool InputDevice_Memcard::Clock(bool TxD, int32 &dsr_pulse_delay)
                   if(memcmp(&card_data[addr << 7], rw_buffer, 128))
                   {
                      memcpy(&card_data[addr << 7], rw_buffer, 128);
+                     MDFNSS_MarkDirty(&card_data[addr << 7], 128);
                      dirty_count++;
                      data_used = true;
                   }
@@ -502,6 +505,7 @@ void InputDevice_Memcard::WriteNV(const uint8 *buffer, uint32 offset, uint32 siz
    if(size)
    {
       dirty_count++;
+      MDFNSS_MarkDirty(card_data, sizeof(card_data));
    }
 
    while(size--)
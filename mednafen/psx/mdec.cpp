@@ -520,6 +520,8 @@ static INLINE void WriteImageData(uint16 V, int32* eat_cycles)
 
 void MDEC_Run(int32 clocks)
 {
+   PSX_PROFILE(PSX_PROF_MDEC);
+   PSX_PROFILE_CYCLES(PSX_PROF_MDEC, clocks);
    static const unsigned MDRPhaseBias = 0 + 1;
 
    //MDFN_DispMessage("%u", OutFIFO.in_count);
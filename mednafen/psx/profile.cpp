@@ -0,0 +1,167 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "psx.h"
+
+#include <stdio.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+static const char *const CounterNames[PSX_PROF_COUNT] =
+{
+   "cpu",
+   "gpu_update",
+   "gpu_fifo",
+   "gpu_polygon",
+   "gpu_sprite",
+   "gpu_line",
+   "spu_cdc",
+   "mdec",
+   "cdc",
+   "gte",
+};
+
+static beetle_psx_profile_counter Current[PSX_PROF_COUNT];
+static beetle_psx_profile_counter LastFrame[PSX_PROF_COUNT];
+static uint64_t FrameCount = 0;
+static uint64_t FrameStart = 0;
+static uint64_t LastFrameTime = 0;
+static FILE *CSVFile = NULL;
+static thread_local bool IgnoreThread = false;
+
+uint64_t PSX_ProfileNow(void)
+{
+#ifdef _WIN32
+   static LARGE_INTEGER freq;
+   LARGE_INTEGER now;
+
+   if(!freq.QuadPart)
+      QueryPerformanceFrequency(&freq);
+
+   QueryPerformanceCounter(&now);
+
+   return (uint64_t)((double)now.QuadPart * 1000000000.0 / freq.QuadPart);
+#else
+   struct timespec ts;
+
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+
+   return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+#endif
+}
+
+void PSX_ProfileAdd(unsigned which, uint64_t host_ns, uint64_t cycles)
+{
+   if(IgnoreThread)
+      return;
+
+   Current[which].host_ns += host_ns;
+   Current[which].calls++;
+   Current[which].cycles += cycles;
+}
+
+void PSX_ProfileAddCycles(unsigned which, uint64_t cycles)
+{
+   if(IgnoreThread)
+      return;
+
+   Current[which].cycles += cycles;
+}
+
+void PSX_ProfileIgnoreThread(void)
+{
+   IgnoreThread = true;
+}
+
+void PSX_ProfileEndFrame(void)
+{
+   const uint64_t now = PSX_ProfileNow();
+   unsigned i;
+
+   for(i = 0; i < PSX_PROF_COUNT; i++)
+   {
+      LastFrame[i] = Current[i];
+      LastFrame[i].name = CounterNames[i];
+
+      Current[i].host_ns = 0;
+      Current[i].calls = 0;
+      Current[i].cycles = 0;
+   }
+
+   LastFrameTime = FrameStart ? now - FrameStart : 0;
+   FrameStart = now;
+
+   if(CSVFile)
+   {
+      fprintf(CSVFile, "%llu,%llu", (unsigned long long)FrameCount, (unsigned long long)LastFrameTime);
+
+      for(i = 0; i < PSX_PROF_COUNT; i++)
+         fprintf(CSVFile, ",%llu,%llu,%llu", (unsigned long long)LastFrame[i].host_ns, (unsigned long long)LastFrame[i].calls, (unsigned long long)LastFrame[i].cycles);
+
+      fputc('\n', CSVFile);
+   }
+
+   FrameCount++;
+}
+
+unsigned beetle_psx_profile_get(struct beetle_psx_profile_counter *counters, unsigned max)
+{
+   unsigned i;
+
+   for(i = 0; i < max && i < PSX_PROF_COUNT; i++)
+   {
+      counters[i] = LastFrame[i];
+      counters[i].name = CounterNames[i];
+   }
+
+   return PSX_PROF_COUNT;
+}
+
+uint64_t beetle_psx_profile_frame(void)
+{
+   return FrameCount;
+}
+
+int beetle_psx_profile_set_csv(const char *path)
+{
+   unsigned i;
+
+   if(CSVFile)
+   {
+      fclose(CSVFile);
+      CSVFile = NULL;
+   }
+
+   if(!path)
+      return 1;
+
+   if(!(CSVFile = fopen(path, "wb")))
+      return 0;
+
+   fprintf(CSVFile, "frame,frame_ns");
+
+   for(i = 0; i < PSX_PROF_COUNT; i++)
+      fprintf(CSVFile, ",%s_ns,%s_calls,%s_cycles", CounterNames[i], CounterNames[i], CounterNames[i]);
+
+   fputc('\n', CSVFile);
+
+   return 1;
+}
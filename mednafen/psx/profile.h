@@ -0,0 +1,96 @@
+#ifndef __MDFN_PSX_PROFILE_H
+#define __MDFN_PSX_PROFILE_H
+
+#include <stdint.h>
+
+// Per-frame profiling counters, built in with HAVE_PROFILE=1.  Times are inclusive, so e.g. the GPU
+// FIFO counter also covers the rasterizers it calls, and every counter is inside the CPU's time.
+
+enum
+{
+   PSX_PROF_CPU = 0,
+   PSX_PROF_GPU_UPDATE,
+   PSX_PROF_GPU_FIFO,
+   PSX_PROF_GPU_POLYGON,
+   PSX_PROF_GPU_SPRITE,
+   PSX_PROF_GPU_LINE,
+   PSX_PROF_SPU_CDC,
+   PSX_PROF_MDEC,
+   PSX_PROF_CDC,
+   PSX_PROF_GTE,
+
+   PSX_PROF_COUNT
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct beetle_psx_profile_counter
+{
+   const char *name;
+   uint64_t host_ns;	// Host time spent
+   uint64_t calls;
+   uint64_t cycles;	// Emulated clocks covered(CPU clocks; GPU clocks for the rasterizers)
+};
+
+// Copies up to "max" counters for the last completed frame, returning how many there are in total.
+unsigned beetle_psx_profile_get(struct beetle_psx_profile_counter *counters, unsigned max);
+
+// Number of frames completed since profiling started.
+uint64_t beetle_psx_profile_frame(void);
+
+// Appends a CSV line per frame to "path"; NULL stops it.  Returns 0 if the file can't be opened.
+int beetle_psx_profile_set_csv(const char *path);
+
+#ifdef __cplusplus
+}
+#endif
+
+#if defined(HAVE_PROFILE) && defined(__cplusplus)
+
+uint64_t PSX_ProfileNow(void);
+void PSX_ProfileAdd(unsigned which, uint64_t host_ns, uint64_t cycles);
+void PSX_ProfileAddCycles(unsigned which, uint64_t cycles);
+void PSX_ProfileEndFrame(void);
+
+// Keeps work done on the calling thread(e.g. the GPU render thread) out of the counters, which are per-frame
+// numbers for the emulation thread.
+void PSX_ProfileIgnoreThread(void);
+
+class PSX_ProfileScope
+{
+   public:
+
+      // If "clock" is given, the amount it went down by while in scope is counted as emulated cycles.
+      INLINE PSX_ProfileScope(unsigned which_arg, const int32_t *clock_arg = NULL) : which(which_arg), clock(clock_arg)
+      {
+         clock_start = clock ? *clock : 0;
+         start = PSX_ProfileNow();
+      }
+
+      INLINE ~PSX_ProfileScope()
+      {
+         PSX_ProfileAdd(which, PSX_ProfileNow() - start, clock ? (int64_t)clock_start - *clock : 0);
+      }
+
+   private:
+      unsigned which;
+      const int32_t *clock;
+      int32_t clock_start;
+      uint64_t start;
+};
+
+#define PSX_PROFILE(which) PSX_ProfileScope psx_profile_scope(which)
+#define PSX_PROFILE_CLOCK(which, clock) PSX_ProfileScope psx_profile_scope(which, &(clock))
+#define PSX_PROFILE_CYCLES(which, n) PSX_ProfileAddCycles(which, n)
+
+#elif defined(__cplusplus)
+
+#define PSX_PROFILE(which)
+#define PSX_PROFILE_CLOCK(which, clock)
+#define PSX_PROFILE_CYCLES(which, n)
+
+#endif
+
+#endif
@@ -4,14 +4,12 @@
 #include "../mednafen.h"
 #include "../masmem.h"
 
-#ifdef HAVE_CDROM_NEW
-#include "../cdrom-new/cdromif.h"
-#else
 #include "../cdrom/cdromif.h"
-#endif
 #include "../general.h"
 #include "../FileStream.h"
 
+#include "profile.h"
+
 // Comment out these 2 defines for extra speeeeed.
 #define PSX_DBGPRINT_ENABLE    1
 #define PSX_EVENT_SYSTEM_CHECKS 1
@@ -84,6 +82,7 @@ void PSX_SetEventNT(const int type, const int32_t next_timestamp);
 void PSX_SetDMACycleSteal(unsigned stealage);
 
 void PSX_GPULineHook(const int32_t timestamp, const int32_t line_timestamp, bool vsync, uint32_t *pixels, const MDFN_PixelFormat* const format, const unsigned width, const unsigned pix_clock_offset, const unsigned pix_clock, const unsigned pix_clock_divide);
+bool PSX_GPULineHookNeedsPixels(void);	// Whether PSX_GPULineHook() looks at the line's pixels
 
 uint32_t PSX_GetRandU32(uint32_t mina, uint32_t maxa);
 
@@ -103,4 +102,12 @@ extern PS_CDC *CDC;
 extern PS_SPU *SPU;
 extern MultiAccessSizeMem<2048 * 1024, uint32_t, false> MainRAM;
 
+// One byte per 4KiB page of main RAM, set on every write to it, for rewinding.
+extern uint8_t MainRAMDirty[512];
+
+static INLINE void PSX_MarkRAMDirty(uint32_t A)
+{
+   MainRAMDirty[(A & 0x1FFFFF) >> 12] = 1;
+}
+
 #endif
@@ -62,8 +62,12 @@
 */
 
 /*
- Update() isn't called on Read and Writes for performance reasons, it's called with sufficient granularity from the event
- system, though this will obviously need to change if we ever emulate the SPU with better precision than per-sample(pair).
+ UpdateFromCDC() is called from PS_CDC::Update(), which leaves the SPU to fall behind and generate samples in blocks except
+ when SPU IRQs are enabled; Read(), Write() and DMA catch it up to the current sample first, via PS_CDC::SyncSPU().  This
+ will obviously need to change if we ever emulate the SPU with better precision than per-sample(pair).
+
+ With SetThreaded(true), the samples themselves(and the register and DMA writes in between) are handed to a thread of
+ their own while SPU IRQs are disabled; see spu_thread.cpp.
 */
 
 #include "psx.h"
@@ -71,6 +75,10 @@
 #include "spu.h"
 #include "../../libretro.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 uint32_t IntermediateBufferPos;
 int16_t IntermediateBuffer[4096][2];
 
@@ -90,17 +98,34 @@ PS_SPU::PS_SPU()
    IntermediateBufferPos = 0;
    memset(IntermediateBuffer, 0, sizeof(IntermediateBuffer));
 
+#ifdef HAVE_THREADS
+   Thread = NULL;
+#endif
 }
 
 PS_SPU::~PS_SPU()
 {
+#ifdef HAVE_THREADS
+   StopThread();
+#endif
 }
 
 void PS_SPU::Power(void)
 {
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+
    clock_divider = 768;
 
    memset(SPURAM, 0, sizeof(SPURAM));
+   memset(SPURAMDirty, 1, sizeof(SPURAMDirty));
+
+   FlushDecodeCache();
+   DecodeCacheNextSerial = 0;
+   memset(BlockGen, 0, sizeof(BlockGen));
+   memset(DecodeCacheIndex, 0, sizeof(DecodeCacheIndex));
+   memset(DecodeCacheSerial, 0, sizeof(DecodeCacheSerial));
 
    for(int i = 0; i < 24; i++)
    {
@@ -138,6 +163,8 @@ void PS_SPU::Power(void)
       memset(&Voices[i].ADSR, 0, sizeof(SPU_ADSR));
    }
 
+   EnvStale = ~0U;
+
    GlobalSweep[0].Power();
    GlobalSweep[1].Power();
 
@@ -288,21 +315,98 @@ INLINE void SPU_Sweep::WriteVolume(int16 value)
 }
 
 
+// 5 through 0xF appear to be 0 on the real thing.
+static const int32 ADPCM_Weights[16][2] =
+{
+   // s-1    s-2
+   {   0,    0 },
+   {  60,    0 },
+   { 115,  -52 },
+   {  98,  -55 },
+   { 122,  -60 },
+};
+
+// Decodes the 4 samples in one halfword of an ADPCM block.
+static INLINE void DecodeADPCM(int16 *tb, uint16 CV, unsigned shift, unsigned weight, int16 &m1, int16 &m2)
+{
+   const int32 weight_m1 = ADPCM_Weights[weight][0];
+   const int32 weight_m2 = ADPCM_Weights[weight][1];
+   uint32 coded;
+
+   if(MDFN_UNLIKELY(shift > 12))
+   {
+      //PSX_DBG(PSX_DBG_FLOOD, "[SPU] Buggy/Illegal ADPCM block shift value: %u\n", shift);
+
+      shift = 8;
+      CV &= 0x8888;
+   }
+
+   coded = (uint32)CV << 12;
+
+   for(int i = 0; i < 4; i++)
+   {
+      int32 sample = (int16)(coded & 0xF000) >> shift;
+
+      sample += ((m2 * weight_m2) >> 6);
+      sample += ((m1 * weight_m1) >> 6);
+
+      clamp(&sample, -32768, 32767);
+
+      tb[i] = sample;
+      m2 = m1;
+      m1 = sample;
+      coded >>= 4;
+   }
+}
+
+void PS_SPU::FlushDecodeCache(void)
+{
+   for(unsigned i = 0; i < DecodeCacheSize; i++)
+      DecodeCache[i].block = 0xFFFF;
+}
+
+// Points the voice at the decoded copy of the block at CurAddr, whose header is "header", decoding it first if needed.
+void PS_SPU::LookupDecodeCache(SPU_Voice *voice, uint16 header)
+{
+   const unsigned voice_num = voice - Voices;
+   const unsigned block = voice->CurAddr >> 3;
+   const unsigned weight = (header >> 4) & 0xF;
+   const int16 m1 = ADPCM_Weights[weight][0] ? voice->DecodeM1 : 0;
+   const int16 m2 = ADPCM_Weights[weight][1] ? voice->DecodeM2 : 0;
+   uint32 hash = (block * 0x9E3779B1) ^ ((uint16)m1 * 0x85EBCA6B) ^ ((uint16)m2 * 0xC2B2AE35);
+   const unsigned index = (hash ^ (hash >> 15)) & (DecodeCacheSize - 1);
+   SPU_DecodeCacheEntry *dce = &DecodeCache[index];
+
+   header &= 0xFF;
+
+   if(dce->block != block || dce->gen != BlockGen[block] || dce->header != header || dce->m1 != m1 || dce->m2 != m2)
+   {
+      int16 dm1 = m1;
+      int16 dm2 = m2;
+
+      for(unsigned i = 0; i < 7; i++)
+         DecodeADPCM(&dce->samples[i * 4], SPURAM[(block << 3) + 1 + i], header & 0xF, weight, dm1, dm2);
+
+      dce->serial = DecodeCacheNextSerial++;
+      dce->gen = BlockGen[block];
+      dce->block = block;
+      dce->header = header;
+      dce->m1 = m1;
+      dce->m2 = m2;
+   }
+
+   DecodeCacheIndex[voice_num] = index;
+   DecodeCacheSerial[voice_num] = dce->serial;
+}
+
 //
 // Take care not to trigger SPU IRQ for the next block before its decoding start.
 //
-void PS_SPU::RunDecoder(SPU_Voice *voice)
+// Returns true if the envelope was forced to 0 at the end of a sample that doesn't loop.
+//
+bool PS_SPU::RunDecoder(SPU_Voice *voice)
 {
-   // 5 through 0xF appear to be 0 on the real thing.
-   static const int32 Weights[16][2] =
-   {
-      // s-1    s-2
-      {   0,    0 },
-      {  60,    0 },
-      { 115,  -52 },
-      {  98,  -55 },
-      { 122,  -60 },
-   };
+   bool env_zeroed = false;
 
    if(voice->DecodeAvail >= 11)
    {
@@ -316,7 +420,7 @@ void PS_SPU::RunDecoder(SPU_Voice *voice)
             IRQ_Assert(IRQ_SPU, IRQAsserted);
          }
       }
-      return;
+      return false;
    }
 
    if((voice->CurAddr & 0x7) == 0)
@@ -341,6 +445,8 @@ void PS_SPU::RunDecoder(SPU_Voice *voice)
             {
                voice->ADSR.Phase = ADSR_RELEASE;
                voice->ADSR.EnvLevel = 0;
+               EnvStale |= 1U << (voice - Voices);
+               env_zeroed = true;
             }
          }
       }
@@ -381,6 +487,8 @@ void PS_SPU::RunDecoder(SPU_Voice *voice)
                }
             }
          }
+
+         LookupDecodeCache(voice, CV);
          voice->CurAddr = (voice->CurAddr + 1) & 0x3FFFF;
       }
 
@@ -389,46 +497,33 @@ void PS_SPU::RunDecoder(SPU_Voice *voice)
       // at higher rates will fail horribly.
       //
       {
-         const int32 weight_m1 = Weights[voice->DecodeWeight][0];
-         const int32 weight_m2 = Weights[voice->DecodeWeight][1];
-         uint16 CV;
-         unsigned shift;
-         uint32 coded;
+         const unsigned voice_num = voice - Voices;
+         const SPU_DecodeCacheEntry *dce = &DecodeCache[DecodeCacheIndex[voice_num]];
          int16 *tb = &voice->DecodeBuffer[voice->DecodeWritePos];
 
-         CV = SPURAM[voice->CurAddr];
-         shift = voice->DecodeShift;
-
-         if(MDFN_UNLIKELY(shift > 12))
+         // The cached block is only good if nothing's been written to it since it was decoded; SPU RAM is read here as
+         // it's needed, not when the block's header was.
+         if(dce->serial == DecodeCacheSerial[voice_num] && dce->block == (voice->CurAddr >> 3) && dce->gen == BlockGen[dce->block])
          {
-            //PSX_DBG(PSX_DBG_FLOOD, "[SPU] Buggy/Illegal ADPCM block shift value on voice %u: %u\n", (unsigned)(voice - Voices), shift);
-
-            shift = 8;
-            CV &= 0x8888;
+            const int16 *cs = &dce->samples[((voice->CurAddr & 0x7) - 1) * 4];
+
+            tb[0] = cs[0];
+            tb[1] = cs[1];
+            tb[2] = cs[2];
+            tb[3] = cs[3];
+            voice->DecodeM2 = cs[2];
+            voice->DecodeM1 = cs[3];
          }
+         else
+            DecodeADPCM(tb, SPURAM[voice->CurAddr], voice->DecodeShift, voice->DecodeWeight, voice->DecodeM1, voice->DecodeM2);
 
-         coded = (uint32)CV << 12;
-
-
-         for(int i = 0; i < 4; i++)
-         {
-            int32 sample = (int16)(coded & 0xF000) >> shift;
-
-            sample += ((voice->DecodeM2 * weight_m2) >> 6);
-            sample += ((voice->DecodeM1 * weight_m1) >> 6);
-
-            clamp(&sample, -32768, 32767);
-
-            tb[i] = sample;
-            voice->DecodeM2 = voice->DecodeM1;
-            voice->DecodeM1 = sample;
-            coded >>= 4;
-         }
          voice->DecodeWritePos = (voice->DecodeWritePos + 4) & 0x1F;
          voice->DecodeAvail += 4;
          voice->CurAddr = (voice->CurAddr + 1) & 0x3FFFF;
       }
    }
+
+   return env_zeroed;
 }
 
 void PS_SPU::CacheEnvelope(SPU_Voice *voice)
@@ -453,6 +548,8 @@ void PS_SPU::CacheEnvelope(SPU_Voice *voice)
    ADSR->ReleaseRate = Rr << 2;
 
    ADSR->SustainLevel = (Sl + 1) << 11;
+
+   EnvStale |= 1U << (voice - Voices);
 }
 
 void PS_SPU::ResetEnvelope(SPU_Voice *voice)
@@ -462,6 +559,8 @@ void PS_SPU::ResetEnvelope(SPU_Voice *voice)
    ADSR->EnvLevel = 0;
    ADSR->Divider = 0;
    ADSR->Phase = ADSR_ATTACK;
+
+   EnvStale |= 1U << (voice - Voices);
 }
 
 void PS_SPU::ReleaseEnvelope(SPU_Voice *voice)
@@ -470,15 +569,15 @@ void PS_SPU::ReleaseEnvelope(SPU_Voice *voice)
 
    ADSR->Divider = 0;
    ADSR->Phase = ADSR_RELEASE;
+
+   EnvStale |= 1U << (voice - Voices);
 }
 
 
-void PS_SPU::RunEnvelope(SPU_Voice *voice)
+// Works out how RunEnvelope() moves the envelope; besides the ADSR settings, that only depends on its phase and level.
+INLINE void PS_SPU::CalcEnvelope(SPU_Voice *voice, int &increment, int &divinco, int16 &uoflow_reset)
 {
    SPU_ADSR *ADSR = &voice->ADSR;
-   int increment;
-   int divinco;
-   int16 uoflow_reset;
 
    if(ADSR->Phase == ADSR_ATTACK && ADSR->EnvLevel == 0x7FFF)
       ADSR->Phase++;
@@ -509,29 +608,64 @@ void PS_SPU::RunEnvelope(SPU_Voice *voice)
                uoflow_reset = 0;
                break;
    }
+}
+
+// Works out EnvIncrement[] etc. for the voice again if they're stale.
+INLINE void PS_SPU::RefreshEnvelope(unsigned voice_num)
+{
+   if(EnvStale & (1U << voice_num))
+   {
+      int increment, divinco;
+      int16 uoflow_reset;
+
+      CalcEnvelope(&Voices[voice_num], increment, divinco, uoflow_reset);
+
+      EnvIncrement[voice_num] = increment;
+      EnvDivinco[voice_num] = divinco;
+      EnvUOFlowReset[voice_num] = uoflow_reset;
+      EnvStale &= ~(1U << voice_num);
+   }
+}
+
+// Steps the envelope's level, for when RunEnvelope()'s divider has come around; returns the same as it.
+INLINE bool PS_SPU::StepEnvelope(SPU_Voice *voice, int increment, int16 uoflow_reset)
+{
+   SPU_ADSR *ADSR = &voice->ADSR;
+   const uint16 prev_level = ADSR->EnvLevel;
+   const uint32 prev_phase = ADSR->Phase;
+
+   ADSR->EnvLevel += increment;
+
+   if(ADSR->Phase == ADSR_ATTACK)
+   {
+      // If previous the upper bit was 0, but now it's 1, handle overflow.
+      if(((prev_level ^ ADSR->EnvLevel) & ADSR->EnvLevel) & 0x8000)
+         ADSR->EnvLevel = uoflow_reset;
+   }
+   else
+   {
+      if(ADSR->EnvLevel & 0x8000)
+         ADSR->EnvLevel = uoflow_reset;
+   }
+   if(ADSR->Phase == ADSR_DECAY && (uint16)ADSR->EnvLevel < ADSR->SustainLevel)
+      ADSR->Phase++;
+
+   return ADSR->EnvLevel != prev_level || ADSR->Phase != prev_phase;
+}
+
+// Returns true if the envelope's phase or level changed, and so CalcEnvelope() needs to be called again.
+INLINE bool PS_SPU::RunEnvelope(SPU_Voice *voice, int increment, int divinco, int16 uoflow_reset)
+{
+   SPU_ADSR *ADSR = &voice->ADSR;
 
    ADSR->Divider += divinco;
    if(ADSR->Divider & 0x8000)
    {
-      const uint16 prev_level = ADSR->EnvLevel;
-
       ADSR->Divider = 0;
-      ADSR->EnvLevel += increment;
-
-      if(ADSR->Phase == ADSR_ATTACK)
-      {
-         // If previous the upper bit was 0, but now it's 1, handle overflow.
-         if(((prev_level ^ ADSR->EnvLevel) & ADSR->EnvLevel) & 0x8000)
-            ADSR->EnvLevel = uoflow_reset;
-      }
-      else
-      {
-         if(ADSR->EnvLevel & 0x8000)
-            ADSR->EnvLevel = uoflow_reset;
-      }
-      if(ADSR->Phase == ADSR_DECAY && (uint16)ADSR->EnvLevel < ADSR->SustainLevel)
-         ADSR->Phase++;
+      return StepEnvelope(voice, increment, uoflow_reset);
    }
+
+   return false;
 }
 
 INLINE void PS_SPU::CheckIRQAddr(uint32 addr)
@@ -551,6 +685,8 @@ INLINE void PS_SPU::WriteSPURAM(uint32 addr, uint16 value)
 {
    CheckIRQAddr(addr);
 
+   SPURAMDirty[addr >> 11] = 1;
+   BlockGen[addr >> 3]++;
    SPURAM[addr] = value;
 }
 
@@ -587,25 +723,50 @@ INLINE uint32 PS_SPU::Get_Reverb_Offset(uint32 in_offset)
  return(offset);
 }
 
-int16 NO_INLINE PS_SPU::RD_RVB(uint16 raw_offs, int32 extra_offs)
+//
+// Zeroes optimized out; middle removed too(it's 16384)
+static const int16 ResampTable[20] =
 {
- return ReadSPURAM(Get_Reverb_Offset((raw_offs << 2) + extra_offs));
-}
+ -1, 2, -10, 35, -103, 266, -616, 1332, -2960, 10246, 10246, -2960, 1332, -616, 266, -103, 35, -10, 2, -1,
+};
 
-void NO_INLINE PS_SPU::WR_RVB(uint16 raw_offs, int16 sample)
+#if defined(__SSE2__)
+// ResampTable spread out to Reverb4422()'s stride of 2, with its middle tap in the gap where it falls.
+static const int16 ResampTable4422[40] =
 {
-   WriteSPURAM(Get_Reverb_Offset(raw_offs << 2), sample);
-}
+ -1, 0, 2, 0, -10, 0, 35, 0, -103, 0, 266, 0, -616, 0, 1332, 0, -2960, 0, 10246, 0x4000,
+ 10246, 0, -2960, 0, 1332, 0, -616, 0, 266, 0, -103, 0, 35, 0, -10, 0, 2, 0, -1, 0,
+};
 
-//
-// Zeroes optimized out; middle removed too(it's 16384)
-static const int16 ResampTable[20] =
+// ResampTable padded out to a multiple of 8 taps.
+static const int16 ResampTable2244[24] =
 {
  -1, 2, -10, 35, -103, 266, -616, 1332, -2960, 10246, 10246, -2960, 1332, -616, 266, -103, 35, -10, 2, -1,
+ 0, 0, 0, 0,
 };
 
+// Sum of "count"(a multiple of 8) products; pmaddwd can't overflow with these coefficients, and the total fits as the
+// scalar versions below note.
+static INLINE int32 ResampMAC(const int16 *src, const int16 *table, const unsigned count)
+{
+ __m128i sum = _mm_setzero_si128();
+
+ for(unsigned i = 0; i < count; i += 8)
+  sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_loadu_si128((const __m128i*)&src[i]), _mm_loadu_si128((const __m128i*)&table[i])));
+
+ sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 8));
+ sum = _mm_add_epi32(sum, _mm_srli_si128(sum, 4));
+
+ return _mm_cvtsi128_si32(sum);
+}
+#endif
+
+// Reads src[0] through src[38](and with SSE2, src[39] as well, times 0).
 static INLINE int32 Reverb4422(const int16 *src)
 {
+#if defined(__SSE2__)
+ int32 out = ResampMAC(src, ResampTable4422, 40);
+#else
  int32 out = 0;	// 32-bits is adequate(it won't overflow)
 
  for(unsigned i = 0; i < 20; i++)
@@ -613,6 +774,7 @@ static INLINE int32 Reverb4422(const int16 *src)
 
  // Middle non-zero
  out += 0x4000 * src[19];
+#endif
 
  out >>= 15;
 
@@ -621,13 +783,18 @@ static INLINE int32 Reverb4422(const int16 *src)
  return(out);
 }
 
+// Reads src[0] through src[19](and with SSE2, through src[23] as well, times 0).
 static INLINE int32 Reverb2244(const int16 *src)
 {
+#if defined(__SSE2__)
+   int32_t out = ResampMAC(src, ResampTable2244, 24);
+#else
    unsigned i;
    int32_t out = 0; /* 32bits is adequate (it won't overflow) */
 
    for(i = 0; i < 20; i++)
    out += ResampTable[i] * src[i];
+#endif
 
    out >>= 14;
 
@@ -667,6 +834,8 @@ void PS_SPU::RunReverb(const int32* in, int32* out)
  if(RvbResPos & 1)
  {
   int32 downsampled[2];
+  const uint32 mix_dest[2][2] = { { Get_Reverb_Offset(MIX_DEST_A0 << 2), Get_Reverb_Offset(MIX_DEST_A1 << 2) },
+                                  { Get_Reverb_Offset(MIX_DEST_B0 << 2), Get_Reverb_Offset(MIX_DEST_B1 << 2) } };
 
   for(unsigned lr = 0; lr < 2; lr++)
    downsampled[lr] = Reverb4422(&RDSB[lr][(RvbResPos - 39) & 0x3F]);
@@ -674,49 +843,68 @@ void PS_SPU::RunReverb(const int32* in, int32* out)
   /* Run algorithm */
   if(SPUControl & 0x80)
   {
-   int16 ACC0, ACC1;
-   int16 FB_A0, FB_A1, FB_B0, FB_B1;
-
-   int16 IIR_INPUT_A0 = ReverbSat(((RD_RVB(IIR_SRC_A0) * IIR_COEF) >> 15) + ((downsampled[0] * IN_COEF_L) >> 15));
-   int16 IIR_INPUT_A1 = ReverbSat(((RD_RVB(IIR_SRC_A1) * IIR_COEF) >> 15) + ((downsampled[1] * IN_COEF_R) >> 15));
-   int16 IIR_INPUT_B0 = ReverbSat(((RD_RVB(IIR_SRC_B0) * IIR_COEF) >> 15) + ((downsampled[0] * IN_COEF_L) >> 15));
-   int16 IIR_INPUT_B1 = ReverbSat(((RD_RVB(IIR_SRC_B1) * IIR_COEF) >> 15) + ((downsampled[1] * IN_COEF_R) >> 15));
-
-   int16 IIR_A0 = ReverbSat((((IIR_INPUT_A0 * IIR_ALPHA) >> 14) + (IIASM(IIR_ALPHA, RD_RVB(IIR_DEST_A0, -1)) >> 14)) >> 1);
-   int16 IIR_A1 = ReverbSat((((IIR_INPUT_A1 * IIR_ALPHA) >> 14) + (IIASM(IIR_ALPHA, RD_RVB(IIR_DEST_A1, -1)) >> 14)) >> 1);
-   int16 IIR_B0 = ReverbSat((((IIR_INPUT_B0 * IIR_ALPHA) >> 14) + (IIASM(IIR_ALPHA, RD_RVB(IIR_DEST_B0, -1)) >> 14)) >> 1);
-   int16 IIR_B1 = ReverbSat((((IIR_INPUT_B1 * IIR_ALPHA) >> 14) + (IIASM(IIR_ALPHA, RD_RVB(IIR_DEST_B1, -1)) >> 14)) >> 1);
-
-   WR_RVB(IIR_DEST_A0, IIR_A0);
-   WR_RVB(IIR_DEST_A1, IIR_A1);
-   WR_RVB(IIR_DEST_B0, IIR_B0);
-   WR_RVB(IIR_DEST_B1, IIR_B1);
-
-   ACC0 = ReverbSat((((RD_RVB(ACC_SRC_A0) * ACC_COEF_A) >> 14) +
-	   	     ((RD_RVB(ACC_SRC_B0) * ACC_COEF_B) >> 14) +
-	   	     ((RD_RVB(ACC_SRC_C0) * ACC_COEF_C) >> 14) +
-	   	     ((RD_RVB(ACC_SRC_D0) * ACC_COEF_D) >> 14)) >> 1);
-
-   ACC1 = ReverbSat((((RD_RVB(ACC_SRC_A1) * ACC_COEF_A) >> 14) +
-	   	     ((RD_RVB(ACC_SRC_B1) * ACC_COEF_B) >> 14) +
-	   	     ((RD_RVB(ACC_SRC_C1) * ACC_COEF_C) >> 14) +
-	   	     ((RD_RVB(ACC_SRC_D1) * ACC_COEF_D) >> 14)) >> 1);
-
-   FB_A0 = RD_RVB(MIX_DEST_A0 - FB_SRC_A);
-   FB_A1 = RD_RVB(MIX_DEST_A1 - FB_SRC_A);
-   FB_B0 = RD_RVB(MIX_DEST_B0 - FB_SRC_B);
-   FB_B1 = RD_RVB(MIX_DEST_B1 - FB_SRC_B);
-
-   WR_RVB(MIX_DEST_A0, ReverbSat(ACC0 - ((FB_A0 * FB_ALPHA) >> 15)));
-   WR_RVB(MIX_DEST_A1, ReverbSat(ACC1 - ((FB_A1 * FB_ALPHA) >> 15)));
-
-   WR_RVB(MIX_DEST_B0, ReverbSat(((FB_ALPHA * ACC0) >> 15) - ((FB_A0 * (int16)(0x8000 ^ FB_ALPHA)) >> 15) - ((FB_B0 * FB_X) >> 15)));
-   WR_RVB(MIX_DEST_B1, ReverbSat(((FB_ALPHA * ACC1) >> 15) - ((FB_A1 * (int16)(0x8000 ^ FB_ALPHA)) >> 15) - ((FB_B1 * FB_X) >> 15)));
+   // Everything taken from the registers up front, as the compiler has to assume writes to SPU RAM could change them.
+   const uint16 iir_src_regs[2][2] = { { IIR_SRC_A0, IIR_SRC_A1 }, { IIR_SRC_B0, IIR_SRC_B1 } };
+   const uint16 iir_dest_regs[2][2] = { { IIR_DEST_A0, IIR_DEST_A1 }, { IIR_DEST_B0, IIR_DEST_B1 } };
+   const uint16 acc_src_regs[2][4] = { { ACC_SRC_A0, ACC_SRC_B0, ACC_SRC_C0, ACC_SRC_D0 }, { ACC_SRC_A1, ACC_SRC_B1, ACC_SRC_C1, ACC_SRC_D1 } };
+   const uint16 fb_src_regs[2][2] = { { (uint16)(MIX_DEST_A0 - FB_SRC_A), (uint16)(MIX_DEST_A1 - FB_SRC_A) },
+                                      { (uint16)(MIX_DEST_B0 - FB_SRC_B), (uint16)(MIX_DEST_B1 - FB_SRC_B) } };
+   const int16 in_coef[2] = { IN_COEF_L, IN_COEF_R };
+   const int16 acc_coef[4] = { ACC_COEF_A, ACC_COEF_B, ACC_COEF_C, ACC_COEF_D };
+   const int16 iir_coef = IIR_COEF;
+   const int16 iir_alpha = IIR_ALPHA;
+   const int16 fb_alpha = FB_ALPHA;
+   const int16 fb_x = FB_X;
+   uint32 iir_dest[2][2];
+   int16 iir[2][2];
+   int16 acc[2];
+   int16 fb[2][2];
+
+   // [0] = A, [1] = B; then left, right.
+   for(unsigned ab = 0; ab < 2; ab++)
+   {
+    for(unsigned lr = 0; lr < 2; lr++)
+    {
+     const int16 iir_input = ReverbSat((((int16)ReadSPURAM(Get_Reverb_Offset(iir_src_regs[ab][lr] << 2)) * iir_coef) >> 15) + ((downsampled[lr] * in_coef[lr]) >> 15));
+     const int16 iir_prev = ReadSPURAM(Get_Reverb_Offset((iir_dest_regs[ab][lr] << 2) - 1));
+
+     iir_dest[ab][lr] = Get_Reverb_Offset(iir_dest_regs[ab][lr] << 2);
+     iir[ab][lr] = ReverbSat((((iir_input * iir_alpha) >> 14) + (IIASM(iir_alpha, iir_prev) >> 14)) >> 1);
+    }
+   }
+
+   for(unsigned ab = 0; ab < 2; ab++)
+   {
+    for(unsigned lr = 0; lr < 2; lr++)
+     WriteSPURAM(iir_dest[ab][lr], iir[ab][lr]);
+   }
+
+   for(unsigned lr = 0; lr < 2; lr++)
+   {
+    int32 sum = 0;
+
+    for(unsigned i = 0; i < 4; i++)
+     sum += ((int16)ReadSPURAM(Get_Reverb_Offset(acc_src_regs[lr][i] << 2)) * acc_coef[i]) >> 14;
+
+    acc[lr] = ReverbSat(sum >> 1);
+   }
+
+   for(unsigned ab = 0; ab < 2; ab++)
+   {
+    for(unsigned lr = 0; lr < 2; lr++)
+     fb[ab][lr] = ReadSPURAM(Get_Reverb_Offset(fb_src_regs[ab][lr] << 2));
+   }
+
+   for(unsigned lr = 0; lr < 2; lr++)
+    WriteSPURAM(mix_dest[0][lr], ReverbSat(acc[lr] - ((fb[0][lr] * fb_alpha) >> 15)));
+
+   for(unsigned lr = 0; lr < 2; lr++)
+    WriteSPURAM(mix_dest[1][lr], ReverbSat(((fb_alpha * acc[lr]) >> 15) - ((fb[0][lr] * (int16)(0x8000 ^ fb_alpha)) >> 15) - ((fb[1][lr] * fb_x) >> 15)));
   }
 
   /* Get output samplesq */
-  RUSB[0][(RvbResPos >> 1) | 0x20] = RUSB[0][RvbResPos >> 1] = (RD_RVB(MIX_DEST_A0) + RD_RVB(MIX_DEST_B0)) >> 1;
-  RUSB[1][(RvbResPos >> 1) | 0x20] = RUSB[1][RvbResPos >> 1] = (RD_RVB(MIX_DEST_A1) + RD_RVB(MIX_DEST_B1)) >> 1;
+  for(unsigned lr = 0; lr < 2; lr++)
+   RUSB[lr][(RvbResPos >> 1) | 0x20] = RUSB[lr][RvbResPos >> 1] = ((int16)ReadSPURAM(mix_dest[0][lr]) + (int16)ReadSPURAM(mix_dest[1][lr])) >> 1;
 
   ReverbCur = (ReverbCur + 1) & 0x3FFFF;
   if(!ReverbCur)
@@ -772,8 +960,22 @@ INLINE void PS_SPU::RunNoise(void)
    }
 }
 
+// Takes the next sample of CD audio(or silence) from the CDC; its range is -32768 through 32767.
+INLINE void PS_SPU::ReadCDAudio(int32 cda_raw[2])
+{
+   const unsigned freq = (CDC->AudioBuffer.ReadPos < CDC->AudioBuffer.Size) ? CDC->AudioBuffer.Freq : 0;
+
+   cda_raw[0] = cda_raw[1] = 0;
+
+   if (freq)
+      CDC->GetCDAudio(cda_raw, freq);	// PS_CDC::GetCDAudio() guarantees the variables passed by reference will be set to 0,
+   // and that their range shall be -32768 through 32767.
+}
+
 int32 PS_SPU::UpdateFromCDC(int32 clocks)
 {
+   PSX_PROFILE(PSX_PROF_SPU_CDC);
+   PSX_PROFILE_CYCLES(PSX_PROF_SPU_CDC, clocks);
    //int32 clocks = timestamp - lastts;
    int32 sample_clocks = 0;
    //lastts = timestamp;
@@ -786,28 +988,313 @@ int32 PS_SPU::UpdateFromCDC(int32 clocks)
       sample_clocks++;
    }
 
+   if(sample_clocks > 0)
+   {
+#ifdef HAVE_THREADS
+      if(ThreadActive())
+         QueueSamples(sample_clocks);
+      else
+#endif
+         RunSamples(sample_clocks, NULL);
+   }
+
+   return clock_divider;
+}
+
+//
+// Runs the envelopes of all the voices over samples 1 through "count" - 1 of a block, a sample at a time across the voices,
+// leaving each sample's levels in env[s].  Each voice's envelope starts running at env_start[voice_num], after its play
+// delay.  The decoder forcing an envelope to 0 isn't known about here; see RunVoiceEnvelope().
+//
+// The dividers are stepped for all the voices at once, and only voices whose dividers come around are stepped one at
+// a time; a voice in "silent" is at level 0 in release, where stepping it only resets the divider.
+//
+void PS_SPU::RunEnvelopes(int32 count, const int16 *env_start, uint32 silent, int16 env[][24])
+{
+   int16 level[24];
+   uint16 divider[24];
+   uint16 divinco[24];	// 0 until the envelope's started running.
+   uint32 pending = 0;	// Envelopes yet to start running, or that need RefreshEnvelope() before their next step.
+
+   for(unsigned v = 0; v < 24; v++)
+   {
+      level[v] = Voices[v].ADSR.EnvLevel;
+      divider[v] = Voices[v].ADSR.Divider;
+      divinco[v] = 0;
+
+      if(env_start[v] > 1 || (EnvStale & (1U << v)))
+         pending |= 1U << v;
+      else
+         divinco[v] = EnvDivinco[v];
+   }
+
+   for(int32 s = 1; s < count; s++)
+   {
+      uint32 ticks = 0;
+
+      memcpy(env[s], level, sizeof(level));
+
+      if(pending)
+      {
+         for(unsigned v = 0; v < 24; v++)
+         {
+            if((pending & (1U << v)) && s >= env_start[v])
+            {
+               Voices[v].ADSR.EnvLevel = level[v];
+               RefreshEnvelope(v);
+               divinco[v] = EnvDivinco[v];
+               pending &= ~(1U << v);
+            }
+         }
+      }
+
+#if defined(__SSE2__)
+      for(unsigned v = 0; v < 24; v += 8)
+      {
+         __m128i d = _mm_add_epi16(_mm_loadu_si128((__m128i *)&divider[v]), _mm_loadu_si128((__m128i *)&divinco[v]));
+         const __m128i tick = _mm_srai_epi16(d, 15);
+
+         ticks |= (uint32)_mm_movemask_epi8(_mm_packs_epi16(tick, _mm_setzero_si128())) << v;
+         d = _mm_andnot_si128(tick, d);
+         _mm_storeu_si128((__m128i *)&divider[v], d);
+      }
+#else
+      for(unsigned v = 0; v < 24; v++)
+      {
+         divider[v] += divinco[v];
+
+         if(divider[v] & 0x8000)
+         {
+            ticks |= 1U << v;
+            divider[v] = 0;
+         }
+      }
+#endif
+
+      ticks &= ~silent;
+
+      if(ticks)
+      {
+         for(unsigned v = 0; v < 24; v++)
+         {
+            if(ticks & (1U << v))
+            {
+               Voices[v].ADSR.EnvLevel = level[v];
+
+               if(StepEnvelope(&Voices[v], EnvIncrement[v], EnvUOFlowReset[v]))
+               {
+                  EnvStale |= 1U << v;
+                  pending |= 1U << v;
+               }
+
+               level[v] = Voices[v].ADSR.EnvLevel;
+            }
+         }
+      }
+   }
+
+   for(unsigned v = 0; v < 24; v++)
+   {
+      Voices[v].ADSR.EnvLevel = level[v];
+      Voices[v].ADSR.Divider = divider[v];
+   }
+}
+
+//
+// Runs one voice's envelope over samples 1 through "count" - 1 of a block into env[s][voice_num], as RunEnvelopes() does,
+// but with the envelope forced to 0 in release at the samples in "env_zeroed", where the decoder did that.
+//
+void PS_SPU::RunVoiceEnvelope(SPU_Voice *voice, int32 count, int32 env_start, uint32 env_zeroed, int16 env[][24])
+{
+   const unsigned voice_num = voice - Voices;
+
+   EnvStale |= 1U << voice_num;
+
+   for(int32 s = 1; s < count; s++)
+   {
+      if(env_zeroed & (1U << s))
+      {
+         voice->ADSR.Phase = ADSR_RELEASE;
+         voice->ADSR.EnvLevel = 0;
+         EnvStale |= 1U << voice_num;
+      }
+
+      env[s][voice_num] = voice->ADSR.EnvLevel;
+
+      if(s >= env_start)
+      {
+         RefreshEnvelope(voice_num);
+
+         if(RunEnvelope(voice, EnvIncrement[voice_num], EnvDivinco[voice_num], EnvUOFlowReset[voice_num]))
+            EnvStale |= 1U << voice_num;
+      }
+   }
+}
+
+//
+// Mixes one sample of all the voices, from their interpolated samples and envelope levels, into "accum", and "accum_fv"
+// for those with "reverb_mask" set.
+//
+static INLINE void MixVoices(const int16 *interp, const int16 *env, const int16 vol[2][24], const int16 *reverb_mask, int32 accum[2], int32 accum_fv[2])
+{
+#if defined(__SSE2__)
+   const __m128i ones = _mm_set1_epi16(1);
+   __m128i sum[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+   __m128i sum_fv[2] = { _mm_setzero_si128(), _mm_setzero_si128() };
+
+   for(unsigned v = 0; v < 24; v += 8)
+   {
+      const __m128i a = _mm_loadu_si128((const __m128i *)&interp[v]);
+      const __m128i e = _mm_loadu_si128((const __m128i *)&env[v]);
+      const __m128i mask = _mm_loadu_si128((const __m128i *)&reverb_mask[v]);
+      __m128i lo = _mm_mullo_epi16(a, e);
+      __m128i hi = _mm_mulhi_epi16(a, e);
+      // Output before volume; it fits in 16 bits, and so does the output after.
+      const __m128i pvs = _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15));
+
+      for(unsigned lr = 0; lr < 2; lr++)
+      {
+         const __m128i vv = _mm_loadu_si128((const __m128i *)&vol[lr][v]);
+         __m128i out;
+
+         lo = _mm_mullo_epi16(pvs, vv);
+         hi = _mm_mulhi_epi16(pvs, vv);
+         out = _mm_packs_epi32(_mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15), _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15));
+
+         sum[lr] = _mm_add_epi32(sum[lr], _mm_madd_epi16(out, ones));
+         sum_fv[lr] = _mm_add_epi32(sum_fv[lr], _mm_madd_epi16(_mm_and_si128(out, mask), ones));
+      }
+   }
+
+   // Left and right totals into the low two lanes.
+   {
+      __m128i t = _mm_add_epi32(_mm_unpacklo_epi32(sum[0], sum[1]), _mm_unpackhi_epi32(sum[0], sum[1]));
+      __m128i t_fv = _mm_add_epi32(_mm_unpacklo_epi32(sum_fv[0], sum_fv[1]), _mm_unpackhi_epi32(sum_fv[0], sum_fv[1]));
+
+      t = _mm_add_epi32(t, _mm_unpackhi_epi64(t, t));
+      t_fv = _mm_add_epi32(t_fv, _mm_unpackhi_epi64(t_fv, t_fv));
+
+      _mm_storel_epi64((__m128i *)accum, _mm_add_epi32(_mm_loadl_epi64((const __m128i *)accum), t));
+      _mm_storel_epi64((__m128i *)accum_fv, _mm_add_epi32(_mm_loadl_epi64((const __m128i *)accum_fv), t_fv));
+   }
+#else
+   for(unsigned v = 0; v < 24; v++)
+   {
+      const int32 pvs = (interp[v] * env[v]) >> 15;
+      const int32 out_l = (pvs * vol[0][v]) >> 15;
+      const int32 out_r = (pvs * vol[1][v]) >> 15;
+
+      accum[0] += out_l;
+      accum[1] += out_r;
+      accum_fv[0] += out_l & reverb_mask[v];
+      accum_fv[1] += out_r & reverb_mask[v];
+   }
+#endif
+}
+
+//
+// Returns how many of the next "count" samples, at least 1, can be run a voice at a time, rather than all the voices for
+// one sample before any for the next:  no SPU IRQ can be raised, and nothing a voice decodes during them can be written
+// to SPU RAM during them.  CD audio and voices 1 and 3 write a halfword each to the four 0x200 halfword areas at the
+// start of SPU RAM per sample, at CWA, and reverb writes to its work area.
+//
+int32 PS_SPU::CalcBlockSize(int32 count)
+{
+   uint32 limit = 0x40000;
+
+   if(SPUControl & 0x40)
+      return 1;
+
+   if(SPUControl & 0x80)
+   {
+      const uint16 dest_regs[8] = { IIR_DEST_A0, IIR_DEST_A1, IIR_DEST_B0, IIR_DEST_B1, MIX_DEST_A0, MIX_DEST_A1, MIX_DEST_B0, MIX_DEST_B1 };
+
+      // Get_Reverb_Offset() only wraps around to below the work area with an offset at least as big as the area.
+      if(ReverbCur < ReverbWA)
+         return 1;
+
+      for(unsigned i = 0; i < 8; i++)
+      {
+         if(((uint32)dest_regs[i] << 2) >= 0x40000 - ReverbWA)
+            return 1;
+      }
+
+      limit = ReverbWA;
+   }
+
+   for(unsigned v = 0; v < 24; v++)
+   {
+      const SPU_Voice *voice = &Voices[v];
+      const uint32 starts[3] = { voice->CurAddr, voice->LoopAddr & ~0x7, (VoiceOn & (1U << v)) ? voice->StartAddr & ~0x7 : voice->CurAddr };
+
+      //
+      // A voice's decoder moves at most 2 halfwords a sample, or back to its loop address(which is only ever set to
+      // somewhere it's been since), and looks at up to 7 past that for the decode cache; so over "count" samples, it
+      // reads from the start of the block it's in up to starts[i] + count * 2 + 8.
+      //
+      for(unsigned i = 0; i < 3; i++)
+      {
+         const uint32 start = starts[i] & ~0x7;
+
+         count = std::min<int32>(count, ((int32)limit - 8 - (int32)starts[i]) >> 1);
+
+         if(start < 0x800)
+         {
+            // The reads have to stop short of where CD audio and the captures are written next, unless they reach
+            // 0x800 first, and the block's "count" writes from there can't wrap around to the start.
+            const int32 room = (CWA - start) & 0x1FF;
+
+            if((int32)(0x800 - start) > room)
+               count = std::min<int32>(count, (room + (int32)start - (int32)starts[i] - 8) >> 1);
+
+            count = std::min<int32>(count, (start - CWA) & 0x1FF);
+         }
+
+         if(count <= 1)
+            return 1;
+      }
+   }
+
+   return count;
+}
+
+// Generates "sample_clocks" samples of output.  The CD audio input for each comes from "cda", packed as left | right << 16,
+// when the samples were queued to the SPU thread, and otherwise straight from the CDC.
+//
+// Where CalcBlockSize() allows, up to SampleBlockSize samples are run as a block, so that each voice is decoded and
+// interpolated over the block in one go, and the envelopes and mixing are done across all the voices at once for each of
+// its samples; otherwise it's one sample at a time.  Either way comes out the same.
+void PS_SPU::RunSamples(int32 sample_clocks, const uint32 *cda)
+{
+   const uint32 PhaseModCache = FM_Mode & ~ 1;
+
    while(sample_clocks > 0)
    {
-      // xxx[0] = left, xxx[1] = right
+      const int32 count = CalcBlockSize(std::min<int32>(sample_clocks, SampleBlockSize));
+
+      // xxx[s][0] = left, xxx[s][1] = right
 
       // Accumulated sound output.
-      int32 accum[2];
+      int32 accum[SampleBlockSize][2];
 
       // Accumulated sound output for reverb input
-      int32 accum_fv[2];
+      int32 accum_fv[SampleBlockSize][2];
+
+      // Output of voices 1 and 3, which is written to SPU RAM along with the CD audio when running a block.
+      int16 capture[2][SampleBlockSize];
 
-      // Output of reverb processing.
-      int32 reverb[2];
+      // LFSR as seen by the voices each sample; the noise generator runs after them.
+      int16 noise[SampleBlockSize];
 
-      // Final output.
-      int32 output[2];
+      memset(accum, 0, count * sizeof(accum[0]));
+      memset(accum_fv, 0, count * sizeof(accum_fv[0]));
 
-      accum[0]    = accum[1]    = 0;
-      accum_fv[0] = accum_fv[1] = 0;
-      reverb[0]   = reverb[1]   = 0;
-      output[0]   = output[1]   = 0;
+      for(int32 s = 0; s < count; s++)
+      {
+         noise[s] = (int16)LFSR;
+         RunNoise();
+      }
 
-      const uint32 PhaseModCache = FM_Mode & ~ 1;
       /*
        **
        ** 0x1F801DAE Notes and Conjecture:
@@ -834,237 +1321,423 @@ int32 PS_SPU::UpdateFromCDC(int32 clocks)
        **
        **     *13 - Unknown, was set to 1 when testing with an SPU delay system reg value of 0x200921E1(test result might not be reliable, re-run).
        */
+      // As of the block's last sample; IRQAsserted can't change within a block.
       SPUStatus = SPUControl & 0x3F;
       SPUStatus |= IRQAsserted ? 0x40 : 0x00;
 
       if(Regs[0xD6] == 0x4)	// TODO: Investigate more(case 0x2C in global regs r/w handler)
-         SPUStatus |= (CWA & 0x100) ? 0x800 : 0x000;
+         SPUStatus |= ((CWA + count - 1) & 0x100) ? 0x800 : 0x000;
 
-      for(int voice_num = 0; voice_num < 24; voice_num++)
+      //
+      // The first sample, where key on and off come in; register writes catch the SPU up first, so they're never in the
+      // middle of a block.
+      //
       {
-         SPU_Voice *voice = &Voices[voice_num];
-         int32 voice_pvs;
-
-         voice->PreLRSample = 0;
+         int32 prev_pvs = 0;	// Output of the previous voice before volume, for FM.
 
-         //PSX_WARNING("[SPU] Voice %d CurPhase=%08x, pitch=%04x, CurAddr=%08x", voice_num, voice->CurPhase, voice->Pitch, voice->CurAddr);
+         for(int voice_num = 0; voice_num < 24; voice_num++)
+         {
+            SPU_Voice *voice = &Voices[voice_num];
+            const int32 reverb_mask = (Reverb_Mode & (1U << voice_num)) ? ~0 : 0;
+            int32 voice_pvs = 0;
 
-         //
-         // Decode new samples if necessary.
-         //
-         RunDecoder(voice);
+            //PSX_WARNING("[SPU] Voice %d CurPhase=%08x, pitch=%04x, CurAddr=%08x", voice_num, voice->CurPhase, voice->Pitch, voice->CurAddr);
 
+            //
+            // Decode new samples if necessary; with enough buffered and no IRQ to check for, RunDecoder() would do nothing.
+            //
+            if(voice->DecodeAvail < 11 || (SPUControl & 0x40))
+               RunDecoder(voice);
 
-         //
-         //
-         //
-         int l, r;
+            // A voice at envelope level 0 outputs 0, whatever it's interpolating.
+            if(voice->ADSR.EnvLevel)
+            {
+               if(Noise_Mode & (1 << voice_num))
+                  voice_pvs = noise[0];
+               else
+               {
+                  const int si = voice->DecodeReadPos;
+                  const int16 *fir = FIR_Table[(voice->CurPhase & 0xFFF) >> 4];
 
-         if(Noise_Mode & (1 << voice_num))
-            voice_pvs = (int16)LFSR;
-         else
-         {
-            const int si = voice->DecodeReadPos;
-            const int pi = ((voice->CurPhase & 0xFFF) >> 4);
+                  voice_pvs = ((voice->DecodeBuffer[(si + 0) & 0x1F] * fir[0]) +
+                        (voice->DecodeBuffer[(si + 1) & 0x1F] * fir[1]) +
+                        (voice->DecodeBuffer[(si + 2) & 0x1F] * fir[2]) +
+                        (voice->DecodeBuffer[(si + 3) & 0x1F] * fir[3])) >> 15;
+               }
 
-            voice_pvs = ((voice->DecodeBuffer[(si + 0) & 0x1F] * FIR_Table[pi][0]) +
-                  (voice->DecodeBuffer[(si + 1) & 0x1F] * FIR_Table[pi][1]) +
-                  (voice->DecodeBuffer[(si + 2) & 0x1F] * FIR_Table[pi][2]) +   
-                  (voice->DecodeBuffer[(si + 3) & 0x1F] * FIR_Table[pi][3])) >> 15;
-         }
+               voice_pvs = (voice_pvs * (int16)voice->ADSR.EnvLevel) >> 15;
 
-         voice_pvs = (voice_pvs * (int16)voice->ADSR.EnvLevel) >> 15;
-         voice->PreLRSample = voice_pvs;
+               for(unsigned lr = 0; lr < 2; lr++)
+               {
+                  const int32 out = (voice_pvs * voice->Sweep[lr].ReadVolume()) >> 15;
 
-         if(voice_num == 1 || voice_num == 3)
-         {
-            int index = voice_num >> 1;
+                  accum[0][lr] += out;
+                  accum_fv[0][lr] += out & reverb_mask;
+               }
+            }
 
-            WriteSPURAM(0x400 | (index * 0x200) | CWA, voice_pvs);
-         }
+            voice->PreLRSample = voice_pvs;
 
+            if(voice_num == 1 || voice_num == 3)
+            {
+               // Later voices in the same sample may decode from here when running one sample at a time.
+               if(count == 1)
+                  WriteSPURAM(0x400 | ((voice_num >> 1) * 0x200) | CWA, voice_pvs);
+               else
+                  capture[voice_num >> 1][0] = voice_pvs;
+            }
 
-         l = (voice_pvs * voice->Sweep[0].ReadVolume()) >> 15;
-         r = (voice_pvs * voice->Sweep[1].ReadVolume()) >> 15;
+            // Run sweep
+            for(int lr = 0; lr < 2; lr++)
+            {
+               if((voice->Sweep[lr].Control & 0x8000))
+                  voice->Sweep[lr].Clock();
+               else
+                  voice->Sweep[lr].Current = (voice->Sweep[lr].Control & 0x7FFF) << 1;
+            }
 
-         accum[0] += l;
-         accum[1] += r;
+            // Increment stuff
+            if(!voice->DecodePlayDelay)
+            {
+               unsigned phase_inc;
 
-         if(Reverb_Mode & (1 << voice_num))
-         {
-            accum_fv[0] += l;
-            accum_fv[1] += r;
-         }
+               // Run enveloping
+               RefreshEnvelope(voice_num);
+               if(RunEnvelope(voice, EnvIncrement[voice_num], EnvDivinco[voice_num], EnvUOFlowReset[voice_num]))
+                  EnvStale |= 1U << voice_num;
 
-         // Run sweep
-         for(int lr = 0; lr < 2; lr++)
-         {
-            if((voice->Sweep[lr].Control & 0x8000))
-               voice->Sweep[lr].Clock();
-            else
-               voice->Sweep[lr].Current = (voice->Sweep[lr].Control & 0x7FFF) << 1;
-         }
+               if(PhaseModCache & (1 << voice_num))
+               {
+                  // This old formula: phase_inc = (voice->Pitch * ((voice - 1)->PreLRSample + 0x8000)) >> 15;
+                  // is incorrect, as it does not handle carrier pitches >= 0x8000 properly.
+                  phase_inc = voice->Pitch + (((int16)voice->Pitch * prev_pvs) >> 15);
+               }
+               else
+                  phase_inc = voice->Pitch;
 
-         // Increment stuff
-         if(!voice->DecodePlayDelay)
-         {
-            unsigned phase_inc;
+               if(phase_inc > 0x3FFF)
+                  phase_inc = 0x3FFF;
 
-            // Run enveloping
-            RunEnvelope(voice);
+               {
+                  const uint32 tmp_phase = voice->CurPhase + phase_inc;
+                  const unsigned used = tmp_phase >> 12;
 
-            if(PhaseModCache & (1 << voice_num))
-            {
-               // This old formula: phase_inc = (voice->Pitch * ((voice - 1)->PreLRSample + 0x8000)) >> 15;
-               // is incorrect, as it does not handle carrier pitches >= 0x8000 properly.
-               phase_inc = voice->Pitch + (((int16)voice->Pitch * ((voice - 1)->PreLRSample)) >> 15);
+                  voice->CurPhase = tmp_phase & 0xFFF;
+                  voice->DecodeAvail -= used;
+                  voice->DecodeReadPos = (voice->DecodeReadPos + used) & 0x1F;
+               }
             }
             else
-               phase_inc = voice->Pitch;
+               voice->DecodePlayDelay--;
 
-            if(phase_inc > 0x3FFF)
-               phase_inc = 0x3FFF;
+            if(VoiceOff & (1U << voice_num))
+            {
+               if(voice->ADSR.Phase != ADSR_RELEASE)
+               {
+                  ReleaseEnvelope(voice);
+               }
+            }
 
+            if(VoiceOn & (1U << voice_num))
             {
-               const uint32 tmp_phase = voice->CurPhase + phase_inc;
-               const unsigned used = tmp_phase >> 12;
+               //printf("Voice On: %u\n", voice_num);
+
+               ResetEnvelope(voice);
 
-               voice->CurPhase = tmp_phase & 0xFFF;
-               voice->DecodeAvail -= used;
-               voice->DecodeReadPos = (voice->DecodeReadPos + used) & 0x1F;
+               voice->DecodeFlags = 0;
+               voice->DecodeWritePos = 0;
+               voice->DecodeReadPos = 0;
+               voice->DecodeAvail = 0;
+               voice->DecodePlayDelay = 4;
+
+               BlockEnd &= ~(1 << voice_num);
+
+               //
+               // Weight/filter previous value initialization:
+               //
+               voice->DecodeM2 = 0;
+               voice->DecodeM1 = 0;
+
+               voice->CurPhase = 0;
+               voice->CurAddr = voice->StartAddr & ~0x7;
+               voice->IgnoreSampLA = false;
             }
-         }
-         else
-            voice->DecodePlayDelay--;
 
-         if(VoiceOff & (1U << voice_num))
-         {
-            if(voice->ADSR.Phase != ADSR_RELEASE)
+            if(!(SPUControl & 0x8000))
             {
-               ReleaseEnvelope(voice);
+               voice->ADSR.Phase = ADSR_RELEASE;
+               voice->ADSR.EnvLevel = 0;
+               EnvStale |= 1U << voice_num;
             }
+
+            prev_pvs = voice_pvs;
          }
+      }
+
+      VoiceOff = 0;
+      VoiceOn = 0; 
 
-         if(VoiceOn & (1U << voice_num))
+      //
+      // The rest of the block.  Every voice's envelope is run ahead over it, a sample at a time across the voices; then the
+      // voices are decoded, interpolated and pitched one after another, FM taking each one's output from the one before;
+      // then they're all mixed, again a sample at a time across the voices.  With the SPU off, all the envelopes were zeroed
+      // in release above and can't come back up, so there's nothing to force here.
+      //
+      if(count > 1)
+      {
+         // [s][voice_num], from s = 1 on.
+         int16 interp[SampleBlockSize][24];
+         int16 env[SampleBlockSize][24];
+
+         int16 env_start[24];	// First sample each envelope runs at, after the voice's play delay.
+         SPU_ADSR env_from[24];	// Envelopes going into the block, for RunVoiceEnvelope().
+         int16 vol[2][24];
+         int16 reverb_mask[24];
+         uint32 silent = 0;	// Voices at envelope level 0 in release; they stay that way over the block.
+         uint32 sweeping[2] = { 0, 0 };
+
+         for(int voice_num = 0; voice_num < 24; voice_num++)
          {
-            //printf("Voice On: %u\n", voice_num);
+            const SPU_Voice *voice = &Voices[voice_num];
 
-            ResetEnvelope(voice);
+            if(voice->ADSR.Phase == ADSR_RELEASE && !voice->ADSR.EnvLevel)
+               silent |= 1U << voice_num;
 
-            voice->DecodeFlags = 0;
-            voice->DecodeWritePos = 0;
-            voice->DecodeReadPos = 0;
-            voice->DecodeAvail = 0;
-            voice->DecodePlayDelay = 4;
+            env_start[voice_num] = 1 + std::min<uint32>(voice->DecodePlayDelay, SampleBlockSize);
+            env_from[voice_num] = voice->ADSR;
+         }
 
-            BlockEnd &= ~(1 << voice_num);
+         RunEnvelopes(count, env_start, silent, env);
 
-            //
-            // Weight/filter previous value initialization:
-            //
-            voice->DecodeM2 = 0;
-            voice->DecodeM1 = 0;
+         // Decoding, interpolation and pitch.  A silent voice still has to be decoded, as a write to its envelope level
+         // can bring it back without a key on, but it interpolates to 0.  If the decoder forces a voice's envelope to 0
+         // partway through, its envelope is run again with that.
+         for(int voice_num = 0; voice_num < 24; voice_num++)
+         {
+            SPU_Voice *voice = &Voices[voice_num];
+            const bool voice_silent = (silent >> voice_num) & 1;
+            uint32 env_zeroed = 0;	// Samples where the decoder forced the envelope to 0, as bits.
+
+            for(int32 s = 1; s < count; s++)
+            {
+               if(voice->DecodeAvail < 11 && RunDecoder(voice))
+                  env_zeroed |= 1U << s;
+
+               if(voice_silent)
+                  interp[s][voice_num] = 0;
+               else if(Noise_Mode & (1 << voice_num))
+                  interp[s][voice_num] = noise[s];
+               else
+               {
+                  const int si = voice->DecodeReadPos;
+                  const int16 *fir = FIR_Table[(voice->CurPhase & 0xFFF) >> 4];
+
+                  interp[s][voice_num] = ((voice->DecodeBuffer[(si + 0) & 0x1F] * fir[0]) +
+                        (voice->DecodeBuffer[(si + 1) & 0x1F] * fir[1]) +
+                        (voice->DecodeBuffer[(si + 2) & 0x1F] * fir[2]) +
+                        (voice->DecodeBuffer[(si + 3) & 0x1F] * fir[3])) >> 15;
+               }
+
+               if(!voice->DecodePlayDelay)
+               {
+                  unsigned phase_inc;
+
+                  if(PhaseModCache & (1 << voice_num))
+                  {
+                     const int32 prev_pvs = (interp[s][voice_num - 1] * env[s][voice_num - 1]) >> 15;
+
+                     phase_inc = voice->Pitch + (((int16)voice->Pitch * prev_pvs) >> 15);
+                  }
+                  else
+                     phase_inc = voice->Pitch;
+
+                  if(phase_inc > 0x3FFF)
+                     phase_inc = 0x3FFF;
 
-            voice->CurPhase = 0;
-            voice->CurAddr = voice->StartAddr & ~0x7;
-            voice->IgnoreSampLA = false;
+                  {
+                     const uint32 tmp_phase = voice->CurPhase + phase_inc;
+                     const unsigned used = tmp_phase >> 12;
+
+                     voice->CurPhase = tmp_phase & 0xFFF;
+                     voice->DecodeAvail -= used;
+                     voice->DecodeReadPos = (voice->DecodeReadPos + used) & 0x1F;
+                  }
+               }
+               else
+                  voice->DecodePlayDelay--;
+            }
+
+            if(env_zeroed)
+            {
+               voice->ADSR = env_from[voice_num];
+               RunVoiceEnvelope(voice, count, env_start[voice_num], env_zeroed, env);
+            }
          }
 
-         if(!(SPUControl & 0x8000))
+         // Volume and mixing.  A voice's volume only moves over the block if it's sweeping; otherwise it was set from
+         // the sweep control at the first sample.
+         for(int voice_num = 0; voice_num < 24; voice_num++)
          {
-            voice->ADSR.Phase = ADSR_RELEASE;
-            voice->ADSR.EnvLevel = 0;
+            SPU_Voice *voice = &Voices[voice_num];
+
+            for(unsigned lr = 0; lr < 2; lr++)
+            {
+               vol[lr][voice_num] = voice->Sweep[lr].ReadVolume();
+
+               if(voice->Sweep[lr].Control & 0x8000)
+                  sweeping[lr] |= 1U << voice_num;
+            }
+
+            reverb_mask[voice_num] = (Reverb_Mode & (1U << voice_num)) ? ~0 : 0;
          }
-      }
 
-      VoiceOff = 0;
-      VoiceOn = 0; 
+         for(int32 s = 1; s < count; s++)
+         {
+            MixVoices(interp[s], env[s], vol, reverb_mask, accum[s], accum_fv[s]);
 
-      // "Mute" control doesn't seem to affect CD audio(though CD audio reverb wasn't tested...)
-      // TODO: If we add sub-sample timing accuracy, see if it's checked for every channel at different times, or just once.
-      if(!(SPUControl & 0x4000))
-      {
-         accum[0] = 0;
-         accum[1] = 0;
-         accum_fv[0] = 0;
-         accum_fv[1] = 0;
+            if(sweeping[0] | sweeping[1])
+            {
+               for(int voice_num = 0; voice_num < 24; voice_num++)
+               {
+                  for(unsigned lr = 0; lr < 2; lr++)
+                  {
+                     if(sweeping[lr] & (1U << voice_num))
+                     {
+                        Voices[voice_num].Sweep[lr].Clock();
+                        vol[lr][voice_num] = Voices[voice_num].Sweep[lr].ReadVolume();
+                     }
+                  }
+               }
+            }
+         }
+
+         for(int voice_num = 0; voice_num < 24; voice_num++)
+            Voices[voice_num].PreLRSample = (interp[count - 1][voice_num] * env[count - 1][voice_num]) >> 15;
+
+         for(int32 s = 1; s < count; s++)
+         {
+            capture[0][s] = (interp[s][1] * env[s][1]) >> 15;
+            capture[1][s] = (interp[s][3] * env[s][3]) >> 15;
+         }
       }
 
-      // Get CD-DA
+      for(int32 s = 0; s < count; s++)
       {
-         int32 cda_raw[2];
-         int32 cdav[2];
-         const unsigned freq = (CDC->AudioBuffer.ReadPos < CDC->AudioBuffer.Size) ? CDC->AudioBuffer.Freq : 0;
+         // Output of reverb processing.
+         int32 reverb[2];
 
-         cda_raw[0] = cda_raw[1] = 0;
+         // Final output.
+         int32 output[2];
 
-         if (freq)
-            CDC->GetCDAudio(cda_raw, freq);	// PS_CDC::GetCDAudio() guarantees the variables passed by reference will be set to 0,
-         // and that their range shall be -32768 through 32767.
+         reverb[0]   = reverb[1]   = 0;
+         output[0]   = output[1]   = 0;
 
-         WriteSPURAM(CWA | 0x000, cda_raw[0]);
-         WriteSPURAM(CWA | 0x200, cda_raw[1]);
+         if(count > 1)
+         {
+            WriteSPURAM(0x400 | CWA, capture[0][s]);
+            WriteSPURAM(0x600 | CWA, capture[1][s]);
+         }
 
-         for(unsigned i = 0; i < 2; i++)
-            cdav[i] = (cda_raw[i] * CDVol[i]) >> 15;
+         // "Mute" control doesn't seem to affect CD audio(though CD audio reverb wasn't tested...)
+         // TODO: If we add sub-sample timing accuracy, see if it's checked for every channel at different times, or just once.
+         if(!(SPUControl & 0x4000))
+         {
+            accum[s][0] = 0;
+            accum[s][1] = 0;
+            accum_fv[s][0] = 0;
+            accum_fv[s][1] = 0;
+         }
 
-         if(SPUControl & 0x0001)
+         // Get CD-DA
          {
-            accum[0] += cdav[0];
-            accum[1] += cdav[1];
+            int32 cda_raw[2];
+            int32 cdav[2];
 
-            if(SPUControl & 0x0004)	// TODO: Test this bit(and see if it is really dependent on bit0)
+            if(cda)
             {
-               accum_fv[0] += cdav[0];
-               accum_fv[1] += cdav[1];
+               cda_raw[0] = (int16)*cda;
+               cda_raw[1] = (int16)(*cda >> 16);
+               cda++;
             }
-         }
-      }
+            else
+               ReadCDAudio(cda_raw);
 
-      CWA = (CWA + 1) & 0x1FF;
+            WriteSPURAM(CWA | 0x000, cda_raw[0]);
+            WriteSPURAM(CWA | 0x200, cda_raw[1]);
 
-      RunNoise();
+            for(unsigned i = 0; i < 2; i++)
+               cdav[i] = (cda_raw[i] * CDVol[i]) >> 15;
 
-      for (unsigned lr = 0; lr < 2; lr++)
-         clamp(&accum_fv[lr], -32768, 32767);
+            if(SPUControl & 0x0001)
+            {
+               accum[s][0] += cdav[0];
+               accum[s][1] += cdav[1];
 
-      RunReverb(accum_fv, reverb);
+               if(SPUControl & 0x0004)	// TODO: Test this bit(and see if it is really dependent on bit0)
+               {
+                  accum_fv[s][0] += cdav[0];
+                  accum_fv[s][1] += cdav[1];
+               }
+            }
+         }
 
-      for(unsigned lr = 0; lr < 2; lr++)
-      {
-         accum[lr] += ((reverb[lr] * ReverbVol[lr]) >> 15);
-         clamp(&accum[lr],  -32768, 32767);
-         output[lr] = (accum[lr] * GlobalSweep[lr].ReadVolume()) >> 15;
-         clamp(&output[lr], -32768, 32767);
-      }
+         CWA = (CWA + 1) & 0x1FF;
+
+         for (unsigned lr = 0; lr < 2; lr++)
+            clamp(&accum_fv[s][lr], -32768, 32767);
+
+         RunReverb(accum_fv[s], reverb);
 
-      if(IntermediateBufferPos < 4096)	// Overflow might occur in some debugger use cases.
-      {
-         // 75%, for some (resampling) headroom.
          for(unsigned lr = 0; lr < 2; lr++)
-            IntermediateBuffer[IntermediateBufferPos][lr] = (output[lr] * 3 + 2) >> 2;
+         {
+            accum[s][lr] += ((reverb[lr] * ReverbVol[lr]) >> 15);
+            clamp(&accum[s][lr],  -32768, 32767);
+            output[lr] = (accum[s][lr] * GlobalSweep[lr].ReadVolume()) >> 15;
+            clamp(&output[lr], -32768, 32767);
+         }
 
-         IntermediateBufferPos++;
-      }
+         if(IntermediateBufferPos < 4096)	// Overflow might occur in some debugger use cases.
+         {
+            // 75%, for some (resampling) headroom.
+            for(unsigned lr = 0; lr < 2; lr++)
+               IntermediateBuffer[IntermediateBufferPos][lr] = (output[lr] * 3 + 2) >> 2;
 
-      sample_clocks--;
+            IntermediateBufferPos++;
+         }
 
-      // Clock global sweep
-      for(unsigned lr = 0; lr < 2; lr++)
-      {
-         if((GlobalSweep[lr].Control & 0x8000))
-            GlobalSweep[lr].Clock();
-         else
-            GlobalSweep[lr].Current = (GlobalSweep[lr].Control & 0x7FFF) << 1;
+         // Clock global sweep
+         for(unsigned lr = 0; lr < 2; lr++)
+         {
+            if((GlobalSweep[lr].Control & 0x8000))
+               GlobalSweep[lr].Clock();
+            else
+               GlobalSweep[lr].Current = (GlobalSweep[lr].Control & 0x7FFF) << 1;
+         }
       }
+
+      sample_clocks -= count;
    }
 
    //assert(clock_divider < 768);
-
-   return clock_divider;
 }
 
+#ifdef HAVE_THREADS
+#include "spu_thread.cpp"
+#endif
+
 void PS_SPU::WriteDMA(uint32 V)
+{
+#ifdef HAVE_THREADS
+   if(ThreadActive())
+   {
+      QueueDMA(V);
+      return;
+   }
+#endif
+   WriteDMAWord(V);
+}
+
+void PS_SPU::WriteDMAWord(uint32 V)
 {
    //SPUIRQ_DBG("DMA Write, RWAddr after=0x%06x", RWAddr);
    WriteSPURAM(RWAddr, V);
@@ -1079,6 +1752,10 @@ void PS_SPU::WriteDMA(uint32 V)
 
 uint32 PS_SPU::ReadDMA(void)
 {
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+
    uint32 ret = (uint16)ReadSPURAM(RWAddr);
    RWAddr = (RWAddr + 1) & 0x3FFFF;
 
@@ -1097,8 +1774,29 @@ void PS_SPU::Write(int32_t timestamp, uint32 A, uint16 V)
    //if((A & 0x3FF) < 0x180)
    // PSX_WARNING("[SPU] Write: %08x %04x", A, V);
 
+   CDC->SyncSPU(timestamp);
+
    A &= 0x3FF;
 
+#ifdef HAVE_THREADS
+   if(Thread)
+   {
+      // SPUControl decides whether the thread is used, and writing it can change the IRQ line, so it's written here.
+      if(A == 0x1AA)
+         SyncThread();
+      else if(ThreadActive())
+      {
+         QueueWrite(A, V);
+         return;
+      }
+   }
+#endif
+
+   WriteReg(A, V);
+}
+
+void PS_SPU::WriteReg(uint32 A, uint16 V)
+{
    if(A >= 0x200)
    {
       //printf("Write: %08x %04x\n", A, V);
@@ -1141,6 +1839,7 @@ void PS_SPU::Write(int32_t timestamp, uint32 A, uint16 V)
             break;
          case 0x0C:
             voice->ADSR.EnvLevel = V;
+            EnvStale |= 1U << (A >> 4);
             break;
          case 0x0E:
             voice->LoopAddr = (V << 2) & 0x3FFFF;
@@ -1243,7 +1942,13 @@ void PS_SPU::Write(int32_t timestamp, uint32 A, uint16 V)
          case 0x2A: //if((SPUControl & 0x80) && !(V & 0x80))
                     // printf("\n\n\n\n ************** REVERB PROCESSING DISABLED\n\n\n\n");
 
-                    SPUControl = V;
+                    if((SPUControl ^ V) & 0x40)
+                    {
+                       SPUControl = V;
+                       CDC->SPUSampleEventsChanged();	// Per-sample updates while IRQs are enabled.
+                    }
+                    else
+                       SPUControl = V;
                     //SPUIRQ_DBG("Set SPUControl=0x%04x -- IRQA=%06x, RWA=%06x", V, IRQAddr, RWAddr);
                     //printf("SPU control write: %04x\n", V);
                     if(!(V & 0x40))
@@ -1280,6 +1985,11 @@ void PS_SPU::Write(int32_t timestamp, uint32 A, uint16 V)
 
 uint16 PS_SPU::Read(int32_t timestamp, uint32 A)
 {
+   CDC->SyncSPU(timestamp);
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+
    A &= 0x3FF;
 
    PSX_DBGINFO("[SPU] Read: %08x", A);
@@ -1475,6 +2185,10 @@ int PS_SPU::StateAction(StateMem *sm, int load, int data_only)
 #undef SFSWEEP
    int ret = 1;
 
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+
    ret &= MDFNSS_StateAction(sm, load, data_only, StateRegs, "SPU");
 
    if(load)
@@ -1499,6 +2213,9 @@ int PS_SPU::StateAction(StateMem *sm, int load, int data_only)
 
       RvbResPos &= 0x3F;
 
+      FlushDecodeCache();
+      EnvStale = ~0U;
+
       IRQ_Assert(IRQ_SPU, IRQAsserted);
    }
 
@@ -1507,16 +2224,33 @@ int PS_SPU::StateAction(StateMem *sm, int load, int data_only)
 
 uint16 PS_SPU::PeekSPURAM(uint32 address)
 {
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
    return(SPURAM[address & 0x3FFFF]);
 }
 
 void PS_SPU::PokeSPURAM(uint32 address, uint16 value)
 {
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+   SPURAMDirty[(address & 0x3FFFF) >> 11] = 1;
+   BlockGen[(address & 0x3FFFF) >> 3]++;
    SPURAM[address & 0x3FFFF] = value;
 }
 
+void PS_SPU::AddDirtyRegion(void)
+{
+   MDFNSS_AddDirtyRegion(SPURAM, sizeof(SPURAM), 4096, SPURAMDirty);
+}
+
 uint32 PS_SPU::GetRegister(unsigned int which, char *special, const uint32 special_len)
 {
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+
    if(which >= 0x8000)
    {
       unsigned int v = (which - 0x8000) >> 8;
@@ -1592,6 +2326,10 @@ uint32 PS_SPU::GetRegister(unsigned int which, char *special, const uint32 speci
 
 void PS_SPU::SetRegister(unsigned int which, uint32 value)
 {
+#ifdef HAVE_THREADS
+   SyncThread();
+#endif
+
    if(which >= GSREG_FB_SRC_A && which <= GSREG_IN_COEF_R)
       ReverbRegs[which - GSREG_FB_SRC_A] = value;
    else switch(which)
@@ -4,6 +4,8 @@
 extern uint32_t IntermediateBufferPos;
 extern int16_t IntermediateBuffer[4096][2];
 
+struct PS_SPU_Thread;
+
 enum
 {
    ADSR_ATTACK = 0,
@@ -93,6 +95,17 @@ struct SPU_Voice
    SPU_ADSR ADSR;
 };
 
+// 28 samples decoded from one 16-byte ADPCM block, along with what they were decoded from.
+struct SPU_DecodeCacheEntry
+{
+   uint32 serial;	// Changes whenever the entry is refilled.
+   uint32 gen;		// BlockGen[] of the block when it was decoded.
+   uint16 block;	// SPU RAM address >> 3, or 0xFFFF if empty.
+   uint16 header;	// Shift and filter.
+   int16 m1, m2;	// Decoder history going into the block, or 0 where the filter doesn't use it.
+   int16 samples[28];
+};
+
 class PS_SPU
 {
    public:
@@ -111,19 +124,41 @@ class PS_SPU
 
       int32_t UpdateFromCDC(int32_t clocks);
 
+      INLINE bool IRQEnabled(void) { return SPUControl & 0x40; }
+
+#ifdef HAVE_THREADS
+      // Moves sample generation to a thread(see spu_thread.cpp), or back to the emulation thread with false; only meant
+      // to be called between frames.
+      void SetThreaded(bool enabled) MDFN_COLD;
+
+      // Waits for the thread to finish everything queued to it, so that the SPU state and IntermediateBuffer are current.
+      void SyncThread(void);
+#endif
+
    private:
 
+      void WriteReg(uint32_t A, uint16_t V);
+      void WriteDMAWord(uint32_t V);
+      void RunSamples(int32_t sample_clocks, const uint32_t *cda);
+      void ReadCDAudio(int32_t cda_raw[2]);
+
       void CheckIRQAddr(uint32_t addr);
       void WriteSPURAM(uint32_t addr, uint16_t value);
       uint16_t ReadSPURAM(uint32_t addr);
 
-      void RunDecoder(SPU_Voice *voice);
+      bool RunDecoder(SPU_Voice *voice);
+      void LookupDecodeCache(SPU_Voice *voice, uint16 header);
+      void FlushDecodeCache(void);
 
       void CacheEnvelope(SPU_Voice *voice);
       void ResetEnvelope(SPU_Voice *voice);
       void ReleaseEnvelope(SPU_Voice *voice);
-      void RunEnvelope(SPU_Voice *voice);
-
+      void CalcEnvelope(SPU_Voice *voice, int &increment, int &divinco, int16 &uoflow_reset);
+      bool RunEnvelope(SPU_Voice *voice, int increment, int divinco, int16 uoflow_reset);
+      bool StepEnvelope(SPU_Voice *voice, int increment, int16 uoflow_reset);
+      void RefreshEnvelope(unsigned voice_num);
+      void RunEnvelopes(int32 count, const int16 *env_start, uint32 silent, int16 env[][24]);
+      void RunVoiceEnvelope(SPU_Voice *voice, int32 count, int32 env_start, uint32 env_zeroed, int16 env[][24]);
 
       void RunReverb(const int32* in, int32* out);
       void RunNoise(void);
@@ -131,6 +166,18 @@ class PS_SPU
 
       SPU_Voice Voices[24];
 
+      // What CalcEnvelope() last worked out for each voice, kept across samples; a voice's is only worked out again, by
+      // RefreshEnvelope(), once its bit in EnvStale is set by something changing its envelope's phase, level or settings.
+      // Not saved.
+      uint32 EnvStale;
+      int32 EnvIncrement[24];
+      uint16 EnvDivinco[24];
+      int16 EnvUOFlowReset[24];
+
+      // Most samples RunSamples() runs in blocks of up to this many.
+      enum { SampleBlockSize = 32 };
+      int32 CalcBlockSize(int32 count);
+
       uint32_t NoiseDivider;
       uint32_t NoiseCounter;
       uint16_t LFSR;
@@ -229,18 +276,44 @@ class PS_SPU
       uint32_t ReverbCur;
 
       uint32_t Get_Reverb_Offset(uint32_t offset);
-      int16 RD_RVB(uint16 raw_offs, int32 extra_offs = 0);
-      void WR_RVB(uint16 raw_offs, int16 sample);
 
       bool IRQAsserted;
 
       int32_t clock_divider;
 
       uint16_t SPURAM[524288 / sizeof(uint16)];
+      uint8 SPURAMDirty[128];	// A byte per 4KiB of SPURAM, set on writes.
+
+      // Decoded ADPCM blocks, so that looping samples aren't decoded over and over.  An entry is keyed by the block's
+      // address, header and the decoder history going into it, and goes stale when anything in the block is written,
+      // as tracked by BlockGen[], which WriteSPURAM() bumps.  DecodeCacheIndex[]/DecodeCacheSerial[] are the entry each
+      // voice is reading its current block from; it's only used while its serial still matches.  None of this is saved.
+      enum { DecodeCacheSize = 2048 };
+      SPU_DecodeCacheEntry DecodeCache[DecodeCacheSize];
+      uint32 DecodeCacheNextSerial;
+      uint32 BlockGen[524288 / 16];
+      uint16 DecodeCacheIndex[24];
+      uint32 DecodeCacheSerial[24];
 
       int last_rate;
       uint32_t last_quality;
 
+#ifdef HAVE_THREADS
+      PS_SPU_Thread *Thread;
+
+      // Whether samples and writes go to the thread rather than being done here.  SPU IRQs depend on exactly when every
+      // SPU RAM access happens, so everything's done on the emulation thread while they're enabled.
+      INLINE bool ThreadActive(void) { return Thread && !(SPUControl & 0x40); }
+
+      void StartThread(void) MDFN_COLD;
+      void StopThread(void) MDFN_COLD;
+      void QueueSamples(int32_t count);
+      void QueueWrite(uint32_t A, uint16_t V);
+      void QueueDMA(uint32_t V);
+      void RunQueued(const uint32_t *entry);
+      static void ThreadMain(void *arg);
+#endif
+
    public:
       enum
       {
@@ -325,6 +398,9 @@ class PS_SPU
 
       uint16_t PeekSPURAM(uint32_t address);
       void PokeSPURAM(uint32_t address, uint16_t value);
+
+      // Registers SPURAM with the savestate code's dirty page tracking.
+      void AddDirtyRegion(void);
 };
 
 #endif
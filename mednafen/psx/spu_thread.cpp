@@ -0,0 +1,281 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Included from spu.cpp
+
+/*
+ Threaded sample generation.
+
+ The emulation thread still keeps the SPU's timing(clock_divider), and still takes the CD audio for every sample from the
+ CDC when the sample is due, as the CDC's buffering depends on it.  The samples(along with their CD audio), register
+ writes and DMA writes go in a single-producer ring in the order they'd otherwise have been done in, and the SPU thread
+ does them in that order, on the same PS_SPU, so the output is exactly the same.
+
+ That only happens while SPU IRQs are disabled, when nothing the SPU does is seen by the rest of the system until it's
+ read.  The emulation thread waits for the SPU thread to catch up before SPU register reads, DMA reads, writes to
+ SPUControl(which can enable IRQs and changes the IRQ line), savestates, resets, and at the end of each frame, for the
+ output.
+*/
+
+#include <atomic>
+#include <rthreads/rthreads.h>
+
+enum
+{
+   ST_SAMPLES = 0,
+   ST_WRITE,
+   ST_DMA,
+   ST_QUIT
+};
+
+// Entries are a header word(type in the low 8 bits, length in words including the header above that), then:
+//
+//  ST_SAMPLES:  the CD audio for each sample, left | right << 16
+//  ST_WRITE:    A | V << 16
+//  ST_DMA:      V
+//
+#define ST_RING_SIZE    (1U << 16)	// In words
+#define ST_RING_MASK    (ST_RING_SIZE - 1)
+#define ST_MAX_SAMPLES  64
+#define ST_MAX_ENTRY    (1 + ST_MAX_SAMPLES)
+#define ST_SPIN_COUNT   2048
+
+struct PS_SPU_Thread
+{
+   sthread_t *thread;
+
+   slock_t *lock;
+   scond_t *work_cond;	// Signalled when something's queued while the SPU thread is sleeping
+   scond_t *done_cond;	// Signalled when entries are consumed while the emulation thread is sleeping
+
+   std::atomic<uint32> write_pos;
+   std::atomic<uint32> read_pos;
+   std::atomic<bool> spu_sleeping;
+   std::atomic<bool> emu_sleeping;
+
+   uint32 ring[ST_RING_SIZE];
+};
+
+// Waits until no more than "max_pending" words are left for the SPU thread to read.
+static void ST_WaitPending(PS_SPU_Thread *st, uint32 max_pending)
+{
+   const uint32 wp = st->write_pos.load(std::memory_order_relaxed);
+
+   for(unsigned spins = 0; (wp - st->read_pos.load()) > max_pending; spins++)
+   {
+      if(spins < ST_SPIN_COUNT)
+         continue;
+
+      slock_lock(st->lock);
+      st->emu_sleeping = true;
+
+      while((wp - st->read_pos.load()) > max_pending)
+         scond_wait(st->done_cond, st->lock);
+
+      st->emu_sleeping = false;
+      slock_unlock(st->lock);
+      break;
+   }
+}
+
+static void ST_Push(PS_SPU_Thread *st, const uint32 *entry, uint32 count)
+{
+   uint32 wp = st->write_pos.load(std::memory_order_relaxed);
+
+   ST_WaitPending(st, ST_RING_SIZE - count);
+
+   for(uint32 i = 0; i < count; i++)
+      st->ring[(wp + i) & ST_RING_MASK] = entry[i];
+
+   st->write_pos.store(wp + count);
+
+   if(st->spu_sleeping.load())
+   {
+      slock_lock(st->lock);
+      scond_signal(st->work_cond);
+      slock_unlock(st->lock);
+   }
+}
+
+void PS_SPU::ThreadMain(void *arg)
+{
+   PS_SPU *spu = (PS_SPU*)arg;
+   PS_SPU_Thread *st = spu->Thread;
+   uint32 rp = st->read_pos.load(std::memory_order_relaxed);
+   uint32 entry[ST_MAX_ENTRY];
+
+#ifdef HAVE_PROFILE
+   PSX_ProfileIgnoreThread();
+#endif
+
+   for(;;)
+   {
+      unsigned spins = 0;
+
+      while(st->write_pos.load() == rp)
+      {
+         if(spins++ < ST_SPIN_COUNT)
+            continue;
+
+         slock_lock(st->lock);
+         st->spu_sleeping = true;
+
+         while(st->write_pos.load() == rp)
+            scond_wait(st->work_cond, st->lock);
+
+         st->spu_sleeping = false;
+         slock_unlock(st->lock);
+      }
+
+      const uint32 header = st->ring[rp & ST_RING_MASK];
+      const uint32 count = header >> 8;
+
+      entry[0] = header;
+      for(uint32 i = 1; i < count; i++)
+         entry[i] = st->ring[(rp + i) & ST_RING_MASK];
+
+      if((header & 0xFF) != ST_QUIT)
+         spu->RunQueued(entry);
+
+      rp += count;
+      st->read_pos.store(rp);
+
+      if(st->emu_sleeping.load())
+      {
+         slock_lock(st->lock);
+         scond_signal(st->done_cond);
+         slock_unlock(st->lock);
+      }
+
+      if((header & 0xFF) == ST_QUIT)
+         break;
+   }
+}
+
+void PS_SPU::RunQueued(const uint32 *entry)
+{
+   switch(entry[0] & 0xFF)
+   {
+      case ST_SAMPLES:
+         RunSamples((entry[0] >> 8) - 1, &entry[1]);
+         break;
+
+      case ST_WRITE:
+         WriteReg(entry[1] & 0xFFFF, entry[1] >> 16);
+         break;
+
+      case ST_DMA:
+         WriteDMAWord(entry[1]);
+         break;
+   }
+}
+
+void PS_SPU::QueueSamples(int32 count)
+{
+   uint32 entry[ST_MAX_ENTRY];
+
+   while(count > 0)
+   {
+      const uint32 n = std::min<int32>(count, ST_MAX_SAMPLES);
+
+      entry[0] = ST_SAMPLES | ((1 + n) << 8);
+
+      for(uint32 i = 0; i < n; i++)
+      {
+         int32 cda_raw[2];
+
+         ReadCDAudio(cda_raw);
+         entry[1 + i] = (uint16)cda_raw[0] | ((uint32)(uint16)cda_raw[1] << 16);
+      }
+
+      ST_Push(Thread, entry, 1 + n);
+      count -= n;
+   }
+}
+
+void PS_SPU::QueueWrite(uint32 A, uint16 V)
+{
+   const uint32 entry[2] = { ST_WRITE | (2 << 8), A | ((uint32)V << 16) };
+
+   ST_Push(Thread, entry, 2);
+}
+
+void PS_SPU::QueueDMA(uint32 V)
+{
+   const uint32 entry[2] = { ST_DMA | (2 << 8), V };
+
+   ST_Push(Thread, entry, 2);
+}
+
+void PS_SPU::SyncThread(void)
+{
+   if(Thread)
+      ST_WaitPending(Thread, 0);
+}
+
+void PS_SPU::StartThread(void)
+{
+   PS_SPU_Thread *st = new PS_SPU_Thread;
+
+   st->write_pos = 0;
+   st->read_pos = 0;
+   st->spu_sleeping = false;
+   st->emu_sleeping = false;
+
+   st->lock = slock_new();
+   st->work_cond = scond_new();
+   st->done_cond = scond_new();
+
+   Thread = st;
+
+   if(!(st->thread = sthread_create(ThreadMain, this)))
+   {
+      scond_free(st->done_cond);
+      scond_free(st->work_cond);
+      slock_free(st->lock);
+      delete st;
+
+      Thread = NULL;
+   }
+}
+
+void PS_SPU::StopThread(void)
+{
+   PS_SPU_Thread *st = Thread;
+   const uint32 quit = ST_QUIT | (1 << 8);
+
+   if(!st)
+      return;
+
+   ST_Push(st, &quit, 1);
+   sthread_join(st->thread);
+
+   scond_free(st->done_cond);
+   scond_free(st->work_cond);
+   slock_free(st->lock);
+   delete st;
+
+   Thread = NULL;
+}
+
+void PS_SPU::SetThreaded(bool enabled)
+{
+   if(enabled && !Thread)
+      StartThread();
+   else if(!enabled && Thread)
+      StopThread();
+}
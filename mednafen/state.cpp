@@ -46,6 +46,16 @@ int32_t smem_write(StateMem *st, void *buffer, uint32_t len)
 {
    if ((len + st->loc) > st->malloced)
    {
+      if (st->fixed)
+      {
+         st->loc += len;
+
+         if (st->loc > st->len)
+            st->len = st->loc;
+
+         return(len);
+      }
+
       uint32_t newsize = (st->malloced >= 32768) ? st->malloced : (st->initial_malloc ? st->initial_malloc : 32768);
 
       while(newsize < (len + st->loc))
@@ -264,8 +274,116 @@ static SFORMAT *FindSF(const char *name, SFORMAT *sf)
    return NULL;
 }
 
+static std::vector<SSDirtyRegion> DirtyRegions;
+static std::vector<uint8_t *> DirtyRegionsOwned;
+static uint32_t DirtyRegionsGen = 0;
+
+void MDFNSS_AddDirtyRegion(void *data, uint32_t size, uint32_t page_size, uint8_t *dirty)
+{
+   SSDirtyRegion r;
+
+   r.data = (uint8_t *)data;
+   r.size = size;
+   r.page_size = page_size;
+   r.dirty = dirty;
+
+   if(!r.dirty)
+   {
+      r.dirty = (uint8_t *)calloc(1, (size + page_size - 1) / page_size);
+      DirtyRegionsOwned.push_back(r.dirty);
+   }
+
+   DirtyRegions.push_back(r);
+   DirtyRegionsGen++;
+}
+
+void MDFNSS_ClearDirtyRegions(void)
+{
+   for(unsigned i = 0; i < DirtyRegionsOwned.size(); i++)
+      free(DirtyRegionsOwned[i]);
+
+   DirtyRegionsOwned.clear();
+   DirtyRegions.clear();
+   DirtyRegionsGen++;
+}
+
+const std::vector<SSDirtyRegion> &MDFNSS_GetDirtyRegions(void)
+{
+   return DirtyRegions;
+}
+
+uint32_t MDFNSS_DirtyRegionsGeneration(void)
+{
+   return DirtyRegionsGen;
+}
+
+void MDFNSS_MarkDirty(const void *data, uint32_t size)
+{
+   const uint8_t *p = (const uint8_t *)data;
+
+   for(unsigned i = 0; i < DirtyRegions.size(); i++)
+   {
+      const SSDirtyRegion &r = DirtyRegions[i];
+
+      if(p >= r.data && p < r.data + r.size && size)
+      {
+         const uint32_t offs = p - r.data;
+         const uint32_t end = ((offs + size) < r.size) ? (offs + size) : r.size;
+
+         memset(r.dirty + offs / r.page_size, 1, (end - 1) / r.page_size - offs / r.page_size + 1);
+         return;
+      }
+   }
+}
+
+static const SSDirtyRegion *FindDirtyRegion(const void *data)
+{
+   for(unsigned i = 0; i < DirtyRegions.size(); i++)
+   {
+      if(DirtyRegions[i].data == data)
+         return &DirtyRegions[i];
+   }
+
+   return NULL;
+}
+
+// Fast raw chunk writer, for snapshots: just the variables' bytes as they are in memory, in SFORMAT order.
+static void DOWriteChunk(StateMem *st, SFORMAT *sf, int data_only)
+{
+   while(sf->size || sf->name)       // Size can sometimes be zero, so also check for the text name.  
+      // These two should both be zero only at the end of a struct.
+   {
+      if(!sf->size || !sf->v)
+      {
+         sf++;
+         continue;
+      }
+
+      if(sf->size == (uint32_t) ~0) // Link to another SFORMAT struct
+      {
+         DOWriteChunk(st, (SFORMAT *)sf->v, data_only);
+         sf++;
+         continue;
+      }
+
+      if(data_only == MDFNSS_DATA_DELTA && FindDirtyRegion(sf->v))
+      {
+         sf++;
+         continue;
+      }
+
+      int32_t bytesize = sf->size;
+
+      if(sf->flags & MDFNSTATE_BOOL)
+         bytesize *= sizeof(bool);
+
+      smem_write(st, (uint8_t *)sf->v, bytesize);
+      sf++;
+   }
+}
+
 // Fast raw chunk reader
-static void DOReadChunk(StateMem *st, SFORMAT *sf)
+static bool DOReadChunk(StateMem *st, SFORMAT *sf, int data_only)
 {
    while(sf->size || sf->name)       // Size can sometimes be zero, so also check for the text name.  
       // These two should both be zero only at the end of a struct.
@@ -278,11 +396,25 @@ static void DOReadChunk(StateMem *st, SFORMAT *sf)
 
       if(sf->size == (uint32_t) ~0) // Link to another SFORMAT struct
       {
-         DOReadChunk(st, (SFORMAT *)sf->v);
+         if(!DOReadChunk(st, (SFORMAT *)sf->v, data_only))
+            return false;
          sf++;
          continue;
       }
 
+      const SSDirtyRegion *dr = FindDirtyRegion(sf->v);
+
+      if(dr)
+      {
+         if(data_only == MDFNSS_DATA_DELTA)
+         {
+            sf++;
+            continue;
+         }
+
+         memset(dr->dirty, 1, (dr->size + dr->page_size - 1) / dr->page_size);
+      }
+
       int32_t bytesize = sf->size;
 
       // Loading raw data, bool types are stored as they appear in memory, not as single bytes in the full state format.
@@ -291,9 +423,12 @@ static void DOReadChunk(StateMem *st, SFORMAT *sf)
       if(sf->flags & MDFNSTATE_BOOL)
          bytesize *= sizeof(bool);
 
-      smem_read(st, (uint8_t *)sf->v, bytesize);
+      if(smem_read(st, (uint8_t *)sf->v, bytesize) != bytesize)
+         return false;
       sf++;
    }
+
+   return true;
 }
 
 static int ReadStateChunk(StateMem *st, SFORMAT *sf, int size)
@@ -338,6 +473,11 @@ static int ReadStateChunk(StateMem *st, SFORMAT *sf, int size)
          }
          else
          {
+            const SSDirtyRegion *dr = FindDirtyRegion(tmp->v);
+
+            if(dr)
+               memset(dr->dirty, 1, (dr->size + dr->page_size - 1) / dr->page_size);
+
             smem_read(st, (uint8_t *)tmp->v, expected_size);
 
             if(tmp->flags & MDFNSTATE_BOOL)
@@ -383,6 +523,23 @@ int MDFNSS_StateAction(void *st_p, int load, int data_only, std::vector <SSDescr
    StateMem *st = (StateMem*)st_p;
    std::vector<SSDescriptor>::iterator section;
 
+   // Snapshots have no section headers or variable names; the sections come back in the order they were saved in.
+   if(data_only)
+   {
+      for(section = sections.begin(); section != sections.end(); section++)
+      {
+         if(!load)
+            DOWriteChunk(st, section->sf, data_only);
+         else if(!DOReadChunk(st, section->sf, data_only))
+         {
+            printf("Snapshot too short at section: %s\n", section->name);
+            return(0);
+         }
+      }
+
+      return(1);
+   }
+
    if(load)
    {
       {
@@ -454,30 +611,36 @@ int MDFNSS_StateAction(void *st_p, int load, int data_only, SFORMAT *sf, const c
    std::vector <SSDescriptor> love;
 
    love.push_back(SSDescriptor(sf, name, optional));
-   return(MDFNSS_StateAction(st, load, 0, love));
+   return(MDFNSS_StateAction(st, load, data_only, love));
 }
 
-int MDFNSS_SaveSM(void *st_p, int, int, const void*, const void*, const void*)
+int MDFNSS_SaveSM(void *st_p, int, int data_only, const void*, const void*, const void*)
 {
    uint8_t header[32];
    StateMem *st = (StateMem*)st_p;
-   static const char *header_magic = "MDFNSVST";
+   const char *header_magic = data_only ? "MDFNSNAP" : "MDFNSVST";
    int neowidth = 0, neoheight = 0;
 
    memset(header, 0, sizeof(header));
    memcpy(header, header_magic, 8);
 
    MDFN_en32lsb(header + 16, MEDNAFEN_VERSION_NUMERIC);
+
+   // Snapshots keep what sort they are where full states have the(unused) preview size.
+   if(data_only)
+      neowidth = data_only;
+
    MDFN_en32lsb(header + 24, neowidth);
    MDFN_en32lsb(header + 28, neoheight);
    smem_write(st, header, 32);
 
-   if(!StateAction(st, 0, 0))
+   if(!StateAction(st, 0, data_only))
       return(0);
 
    uint32_t sizy = st->loc;
    smem_seek(st, 16 + 4, SEEK_SET);
    smem_write32le(st, sizy);
+   smem_seek(st, sizy, SEEK_SET);
 
    return(1);
 }
@@ -488,12 +651,31 @@ int MDFNSS_LoadSM(void *st_p, int, int)
    uint32_t stateversion;
    StateMem *st = (StateMem*)st_p;
 
-   smem_read(st, header, 32);
-
-   if(memcmp(header, "MEDNAFENSVESTATE", 16) && memcmp(header, "MDFNSVST", 8))
+   if(smem_read(st, header, 32) != 32)
       return(0);
 
    stateversion = MDFN_de32lsb(header + 16);
 
+   // Snapshots are only loaded back into the build, and the settings, that made them, so all there is to check is
+   // that the sizes of everything still add up.
+   if(!memcmp(header, "MDFNSNAP", 8))
+   {
+      const int data_only = MDFN_de32lsb(header + 24);
+
+      if(stateversion != MEDNAFEN_VERSION_NUMERIC || MDFN_de32lsb(header + 20) > st->len)
+         return(0);
+
+      if(data_only != 1 && data_only != MDFNSS_DATA_DELTA)
+         return(0);
+
+      if(!StateAction(st, stateversion, data_only))
+         return(0);
+
+      return(st->loc == MDFN_de32lsb(header + 20));
+   }
+
+   if(memcmp(header, "MEDNAFENSVESTATE", 16) && memcmp(header, "MDFNSVST", 8))
+      return(0);
+
    return(StateAction(st, stateversion, 0));
 }
@@ -3,6 +3,8 @@
 
 #include <retro_inline.h>
 
+#include <vector>
+
 typedef struct
 {
    uint8_t *data;
@@ -10,6 +12,8 @@ typedef struct
    uint32_t len;
    uint32_t malloced;
    uint32_t initial_malloc; // A setting!
+   bool fixed;              // Also a setting: "data" isn't ours to realloc(), so writes past "malloced" are only
+                            // counted in "len", for the caller to notice.
 } StateMem;
 
 // Eh, we abuse the smem_* in-memory stream code
@@ -21,9 +25,35 @@ int32_t smem_seek(StateMem *st, uint32_t offset, int whence);
 int smem_write32le(StateMem *st, uint32_t b);
 int smem_read32le(StateMem *st, uint32_t *b);
 
-int MDFNSS_SaveSM(void *st, int, int, const void*, const void*, const void*);
+// With "data_only", MDFNSS_SaveSM() makes a snapshot: the same state, but as the variables' raw bytes with no names,
+// which is much faster to save and load, for run-ahead and the like, but only good in the same build with the same
+// settings.  MDFNSS_LoadSM() takes either.
+int MDFNSS_SaveSM(void *st, int, int data_only, const void*, const void*, const void*);
 int MDFNSS_LoadSM(void *st, int, int);
 
+// "data_only" for a snapshot that leaves out the dirty regions below, whose contents the caller keeps track of itself.
+#define MDFNSS_DATA_DELTA 2
+
+// Big arrays saved by StateAction()s, whose writes are tracked a page at a time: the page's byte in "dirty" is set
+// whenever it's written to, so that rewinding(see state_rewind.cpp) need only copy the pages written since its last
+// step.  With no "dirty" given, one is allocated, and writes are to be reported through MDFNSS_MarkDirty().
+// Loading a state marks the whole of each region it loads.
+struct SSDirtyRegion
+{
+   uint8_t *data;
+   uint32_t size;
+   uint32_t page_size;
+   uint8_t *dirty;
+};
+
+void MDFNSS_AddDirtyRegion(void *data, uint32_t size, uint32_t page_size, uint8_t *dirty = NULL);
+void MDFNSS_ClearDirtyRegions(void);
+const std::vector<SSDirtyRegion> &MDFNSS_GetDirtyRegions(void);
+void MDFNSS_MarkDirty(const void *data, uint32_t size);
+
+// Bumped whenever the set of dirty regions changes.
+uint32_t MDFNSS_DirtyRegionsGeneration(void);
+
 // Flag for a single, >= 1 byte native-endian variable
 #define MDFNSTATE_RLSB            0x80000000
 
@@ -89,8 +119,6 @@ INLINE uint32_t SF_FORCE_D(double *) { return(0); }
 
 #define SFEND { 0, 0, 0, 0 }
 
-#include <vector>
-
 // State-Section Descriptor
 class SSDescriptor
 {
@@ -0,0 +1,322 @@
+/* Mednafen - Multi-system Emulator
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <deque>
+
+#include "mednafen.h"
+#include "state.h"
+#include "state_rewind.h"
+
+/*
+ Every dirty region has a shadow copy, holding what it was at the last step saved.  Saving a step goes through the pages
+ dirtied since then, putting the shadow's copy of each(what the page was at the step before) in the step's record, then
+ bringing the shadow up to date.  Going back first copies the dirtied pages from the shadow, so the regions are as they
+ were at the last step, loads that step's snapshot for everything else, then puts the record's pages back into the
+ shadow, marking them dirty, so that the shadow is as it was at the step before for the next time.
+
+ Records, in the ring, are:
+    uint32 snapshot length
+    uint32 number of pages
+    snapshot
+    for each page: uint32 region, uint32 page, page contents
+*/
+
+struct RewindRecord
+{
+   size_t offset;
+   size_t len;
+};
+
+static uint8_t *Ring = NULL;
+static size_t RingSize = 0;
+static std::deque<RewindRecord> Records;
+
+static std::vector<uint8_t *> Shadows;
+static uint32_t ShadowsGen = 0;
+static bool ShadowsValid = false;
+
+static StateMem Scratch;
+
+static INLINE uint32_t PageBytes(const SSDirtyRegion &r, uint32_t page)
+{
+   const uint32_t offs = page * r.page_size;
+
+   return ((r.size - offs) < r.page_size) ? (r.size - offs) : r.page_size;
+}
+
+static INLINE uint32_t PageCount(const SSDirtyRegion &r)
+{
+   return (r.size + r.page_size - 1) / r.page_size;
+}
+
+static void FreeShadows(void)
+{
+   for(unsigned i = 0; i < Shadows.size(); i++)
+      free(Shadows[i]);
+
+   Shadows.clear();
+   ShadowsValid = false;
+}
+
+// Starts afresh from the regions as they are now.
+static bool ResetShadows(void)
+{
+   const std::vector<SSDirtyRegion> &regions = MDFNSS_GetDirtyRegions();
+
+   FreeShadows();
+   Records.clear();
+
+   for(unsigned i = 0; i < regions.size(); i++)
+   {
+      uint8_t *shadow = (uint8_t *)malloc(regions[i].size);
+
+      if(!shadow)
+      {
+         FreeShadows();
+         return false;
+      }
+
+      memcpy(shadow, regions[i].data, regions[i].size);
+      memset(regions[i].dirty, 0, PageCount(regions[i]));
+      Shadows.push_back(shadow);
+   }
+
+   ShadowsGen = MDFNSS_DirtyRegionsGeneration();
+   ShadowsValid = true;
+
+   return true;
+}
+
+// Finds room for a record of "len" bytes after the last one, dropping the oldest ones in the way.
+static size_t Allocate(size_t len)
+{
+   size_t head = Records.empty() ? 0 : (Records.back().offset + Records.back().len);
+
+   if((head + len) > RingSize)
+   {
+      // Whatever lies between here and the end of the ring is the oldest.
+      while(!Records.empty() && Records.front().offset >= head)
+         Records.pop_front();
+
+      head = 0;
+   }
+
+   while(!Records.empty() && Records.front().offset < (head + len) && (Records.front().offset + Records.front().len) > head)
+      Records.pop_front();
+
+   return head;
+}
+
+bool MDFNSS_RewindInit(size_t size)
+{
+   FreeShadows();
+   Records.clear();
+
+   free(Ring);
+   Ring = NULL;
+   RingSize = 0;
+
+   free(Scratch.data);
+   memset(&Scratch, 0, sizeof(Scratch));
+
+   if(!size)
+      return true;
+
+   if(!(Ring = (uint8_t *)malloc(size)))
+      return false;
+
+   RingSize = size;
+
+   return true;
+}
+
+bool MDFNSS_RewindPush(void)
+{
+   const std::vector<SSDirtyRegion> &regions = MDFNSS_GetDirtyRegions();
+   uint32_t page_count = 0;
+   size_t len;
+   size_t offset;
+   uint8_t *p;
+
+   if(!Ring)
+      return false;
+
+   Scratch.loc = 0;
+   Scratch.len = 0;
+
+   if(!MDFNSS_SaveSM(&Scratch, 0, MDFNSS_DATA_DELTA, NULL, NULL, NULL))
+      return false;
+
+   if(!ShadowsValid || ShadowsGen != MDFNSS_DirtyRegionsGeneration())
+   {
+      if(!ResetShadows())
+         return false;
+   }
+
+   len = 8 + Scratch.len;
+
+   for(unsigned i = 0; i < regions.size(); i++)
+   {
+      const SSDirtyRegion &r = regions[i];
+      const uint32_t count = PageCount(r);
+
+      for(uint32_t page = 0; page < count; page++)
+      {
+         if(r.dirty[page])
+         {
+            len += 8 + PageBytes(r, page);
+            page_count++;
+         }
+      }
+   }
+
+   if(len > RingSize)
+   {
+      // Without this step's pages, none of the steps before it can be gone back to.
+      Records.clear();
+
+      for(unsigned i = 0; i < regions.size(); i++)
+      {
+         memcpy(Shadows[i], regions[i].data, regions[i].size);
+         memset(regions[i].dirty, 0, PageCount(regions[i]));
+      }
+
+      return false;
+   }
+
+   offset = Allocate(len);
+   p = Ring + offset;
+
+   memcpy(p + 0, &Scratch.len, 4);
+   memcpy(p + 4, &page_count, 4);
+   memcpy(p + 8, Scratch.data, Scratch.len);
+   p += 8 + Scratch.len;
+
+   for(uint32_t i = 0; i < regions.size(); i++)
+   {
+      const SSDirtyRegion &r = regions[i];
+      const uint32_t count = PageCount(r);
+
+      for(uint32_t page = 0; page < count; page++)
+      {
+         if(r.dirty[page])
+         {
+            const uint32_t offs = page * r.page_size;
+            const uint32_t bytes = PageBytes(r, page);
+
+            memcpy(p + 0, &i, 4);
+            memcpy(p + 4, &page, 4);
+            memcpy(p + 8, Shadows[i] + offs, bytes);
+            p += 8 + bytes;
+
+            memcpy(Shadows[i] + offs, r.data + offs, bytes);
+            r.dirty[page] = 0;
+         }
+      }
+   }
+
+   RewindRecord rec;
+
+   rec.offset = offset;
+   rec.len = len;
+   Records.push_back(rec);
+
+   return true;
+}
+
+bool MDFNSS_RewindPop(void)
+{
+   const std::vector<SSDirtyRegion> &regions = MDFNSS_GetDirtyRegions();
+   StateMem sm;
+   uint32_t snap_len;
+   uint32_t page_count;
+   const uint8_t *p;
+
+   if(Records.empty())
+      return false;
+
+   if(!ShadowsValid || ShadowsGen != MDFNSS_DirtyRegionsGeneration())
+   {
+      FreeShadows();
+      Records.clear();
+      return false;
+   }
+
+   p = Ring + Records.back().offset;
+   memcpy(&snap_len, p + 0, 4);
+   memcpy(&page_count, p + 4, 4);
+
+   for(unsigned i = 0; i < regions.size(); i++)
+   {
+      const SSDirtyRegion &r = regions[i];
+      const uint32_t count = PageCount(r);
+
+      for(uint32_t page = 0; page < count; page++)
+      {
+         if(r.dirty[page])
+         {
+            const uint32_t offs = page * r.page_size;
+
+            memcpy(r.data + offs, Shadows[i] + offs, PageBytes(r, page));
+         }
+      }
+   }
+
+   memset(&sm, 0, sizeof(sm));
+   sm.data = (uint8_t *)p + 8;
+   sm.len = snap_len;
+
+   if(!MDFNSS_LoadSM(&sm, 0, 0))
+   {
+      FreeShadows();
+      Records.clear();
+      return false;
+   }
+
+   for(unsigned i = 0; i < regions.size(); i++)
+      memset(regions[i].dirty, 0, PageCount(regions[i]));
+
+   p += 8 + snap_len;
+
+   while(page_count--)
+   {
+      uint32_t region;
+      uint32_t page;
+
+      memcpy(&region, p + 0, 4);
+      memcpy(&page, p + 4, 4);
+
+      const SSDirtyRegion &r = regions[region];
+      const uint32_t bytes = PageBytes(r, page);
+
+      memcpy(Shadows[region] + page * r.page_size, p + 8, bytes);
+      r.dirty[page] = 1;
+      p += 8 + bytes;
+   }
+
+   Records.pop_back();
+
+   return true;
+}
+
+unsigned MDFNSS_RewindCount(void)
+{
+   return Records.size();
+}
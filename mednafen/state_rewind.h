@@ -0,0 +1,39 @@
+#ifndef _STATE_REWIND_H
+#define _STATE_REWIND_H
+
+#include <stddef.h>
+
+// Rewind buffer of incremental savestates: each step is a delta snapshot(MDFNSS_DATA_DELTA), plus the previous contents
+// of just the pages of the dirty regions(see state.h) written since the step before, so a step costs about as much as
+// the frame dirtied rather than the whole state.  Steps are kept in a fixed-size ring, the oldest going first.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sets the ring's size in bytes, dropping all steps; 0 frees it.  Returns 0 if it can't be allocated.
+int beetle_psx_rewind_init(size_t size);
+
+// Saves a step.  Returns 0 if it couldn't be, in which case all earlier ones are gone, too.
+int beetle_psx_rewind_push(void);
+
+// Goes back to the last step saved, and forgets it.  Returns 0 if there's none.
+int beetle_psx_rewind_pop(void);
+
+// Number of steps there are to go back through.
+unsigned beetle_psx_rewind_count(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+
+bool MDFNSS_RewindInit(size_t size);
+bool MDFNSS_RewindPush(void);
+bool MDFNSS_RewindPop(void);
+unsigned MDFNSS_RewindCount(void);
+
+#endif
+
+#endif
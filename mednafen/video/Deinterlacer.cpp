@@ -48,6 +48,8 @@ void Deinterlacer::InternalProcess(MDFN_Surface *surface, MDFN_Rect &DisplayRect
  // We need to output with LineWidths as always being valid to handle the case of horizontal resolution change between fields
  // while in interlace mode, so clear the first LineWidths entry if it's == ~0, and
  // [...]
+ T* const pixels = (T*)surface->pixels;
+ T* const field_pixels = FieldBuffer ? (T*)FieldBuffer->pixels : NULL;
  const bool LineWidths_In_Valid = (LineWidths[0] != ~0);
  const bool WeaveGood = (StateValid && PrevDRect.h == DisplayRect.h && DeintType == DEINT_WEAVE);
  //
@@ -77,15 +79,15 @@ void Deinterlacer::InternalProcess(MDFN_Surface *surface, MDFN_Rect &DisplayRect
 
   if(XReposition)
   {
-    memmove(surface->pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix,
-	    surface->pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + XReposition,
+    memmove(pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix,
+	    pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + XReposition,
 	    LineWidths[(y * 2) + field + DisplayRect.y] * sizeof(T));
   }
 
   if(WeaveGood)
   {
-   const T* src = FieldBuffer->pixels + y * FieldBuffer->pitchinpix;
-   T* dest = surface->pixels + ((y * 2) + (field ^ 1) + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
+   const T* src = field_pixels + y * FieldBuffer->pitchinpix;
+   T* dest = pixels + ((y * 2) + (field ^ 1) + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
    int32 *dest_lw = &LineWidths[(y * 2) + (field ^ 1) + DisplayRect.y];
 
    *dest_lw = LWBuffer[y];
@@ -95,8 +97,8 @@ void Deinterlacer::InternalProcess(MDFN_Surface *surface, MDFN_Rect &DisplayRect
   }
   else if(DeintType == DEINT_BOB)
   {
-   const T* src = surface->pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
-   T* dest = surface->pixels + ((y * 2) + (field ^ 1) + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
+   const T* src = pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
+   T* dest = pixels + ((y * 2) + (field ^ 1) + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
    const int32 *src_lw = &LineWidths[(y * 2) + field + DisplayRect.y];
    int32 *dest_lw = &LineWidths[(y * 2) + (field ^ 1) + DisplayRect.y];
 
@@ -107,14 +109,14 @@ void Deinterlacer::InternalProcess(MDFN_Surface *surface, MDFN_Rect &DisplayRect
   else
   {
    const int32 *src_lw = &LineWidths[(y * 2) + field + DisplayRect.y];
-   const T* src = surface->pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
+   const T* src = pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
    const int32 dly = ((y * 2) + (field + 1) + DisplayRect.y);
-   T* dest = surface->pixels + dly * surface->pitchinpix + DisplayRect.x;
+   T* dest = pixels + dly * surface->pitchinpix + DisplayRect.x;
 
    if(y == 0 && field)
    {
     T black = MAKECOLOR(0, 0, 0, 0);
-    T* dm2 = surface->pixels + (dly - 2) * surface->pitchinpix;
+    T* dm2 = pixels + (dly - 2) * surface->pitchinpix;
 
     LineWidths[dly - 2] = *src_lw;
 
@@ -138,10 +140,10 @@ void Deinterlacer::InternalProcess(MDFN_Surface *surface, MDFN_Rect &DisplayRect
   if(DeintType == DEINT_WEAVE)
   {
    const int32 *src_lw = &LineWidths[(y * 2) + field + DisplayRect.y];
-   const T* src = surface->pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
-   T* dest = FieldBuffer->pixels + y * FieldBuffer->pitchinpix;
+   const T* src = pixels + ((y * 2) + field + DisplayRect.y) * surface->pitchinpix + DisplayRect.x;
+   T* dest = field_pixels + y * FieldBuffer->pitchinpix;
 
-   memcpy(dest, src, *src_lw * sizeof(uint32));
+   memcpy(dest, src, *src_lw * sizeof(T));
    LWBuffer[y] = *src_lw;
 
    StateValid = true;
@@ -155,7 +157,7 @@ void Deinterlacer::Process(MDFN_Surface *surface, MDFN_Rect &DisplayRect, int32
 
  if(DeintType == DEINT_WEAVE)
  {
-  if(!FieldBuffer || FieldBuffer->w < surface->w || FieldBuffer->h < (surface->h / 2))
+  if(!FieldBuffer || FieldBuffer->w < surface->w || FieldBuffer->h < (surface->h / 2) || FieldBuffer->format.bpp != surface->format.bpp)
   {
    if(FieldBuffer)
     delete FieldBuffer;
@@ -169,11 +171,10 @@ void Deinterlacer::Process(MDFN_Surface *surface, MDFN_Rect &DisplayRect, int32
   }
  }
 
-#if defined(WANT_32BPP)
- InternalProcess<uint32>(surface, DisplayRect, LineWidths, field);
-#elif defined(WANT_16BPP)
- InternalProcess<uint16>(surface, DisplayRect, LineWidths, field);
-#endif
+ if(surface->format.bpp == 16)
+  InternalProcess<uint16>(surface, DisplayRect, LineWidths, field);
+ else
+  InternalProcess<uint32>(surface, DisplayRect, LineWidths, field);
 
  PrevDRect = DisplayRect_Original;
 }
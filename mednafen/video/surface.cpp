@@ -29,9 +29,9 @@ MDFN_PixelFormat::MDFN_PixelFormat()
    Ashift = 0;
 }
 
-MDFN_PixelFormat::MDFN_PixelFormat(const unsigned int p_colorspace, const uint8 p_rs, const uint8 p_gs, const uint8 p_bs, const uint8 p_as)
+MDFN_PixelFormat::MDFN_PixelFormat(const unsigned int p_colorspace, const uint8 p_rs, const uint8 p_gs, const uint8 p_bs, const uint8 p_as, const unsigned int p_bpp)
 {
-   bpp = 32;
+   bpp = p_bpp;
    colorspace = p_colorspace;
 
    Rshift = p_rs;
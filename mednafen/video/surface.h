@@ -29,7 +29,7 @@ class MDFN_PixelFormat
  public:
 
  MDFN_PixelFormat();
- MDFN_PixelFormat(const unsigned int p_colorspace, const uint8 p_rs, const uint8 p_gs, const uint8 p_bs, const uint8 p_as);
+ MDFN_PixelFormat(const unsigned int p_colorspace, const uint8 p_rs, const uint8 p_gs, const uint8 p_bs, const uint8 p_as, const unsigned int p_bpp = 32);
 
  unsigned int bpp;
  unsigned int colorspace;
@@ -65,6 +65,27 @@ class MDFN_PixelFormat
     a = (value >> ALPHA_SHIFT) & 0xFF;
  }
 
+ // Pixel "x" of a line in this format, as a MAKECOLOR() value; for 16bpp(RGB565) "line" really points to uint16s.
+ INLINE uint32 ReadPixel(const uint32 *line, unsigned x) const
+ {
+    uint32 p;
+
+    if(bpp == 32)
+       return line[x];
+
+    p = ((const uint16 *)line)[x];
+
+    return MAKECOLOR((((p >> 8) & 0xF8) | (p >> 13)), (((p >> 3) & 0xFC) | ((p >> 9) & 0x3)), (((p << 3) & 0xF8) | ((p >> 2) & 0x7)), 0);
+ }
+
+ INLINE void WritePixel(uint32 *line, unsigned x, uint32 value) const
+ {
+    if(bpp == 32)
+       line[x] = value;
+    else
+       ((uint16 *)line)[x] = ((value >> (RED_SHIFT - 8)) & 0xF800) | ((value >> (GREEN_SHIFT - 3)) & 0x7E0) | ((value >> (BLUE_SHIFT + 3)) & 0x1F);
+ }
+
 }; // MDFN_PixelFormat;
 
 // Supports 32-bit RGBA
@@ -78,7 +99,11 @@ class MDFN_Surface //typedef struct
 
  ~MDFN_Surface();
 
- uint32 *pixels;
+ union
+ {
+  uint32 *pixels;
+  uint16 *pixels16;	// When format.bpp == 16
+ };
 
  // w, h, and pitch32 should always be > 0
  int32 w;